@@ -0,0 +1,298 @@
+#include <nitro/format.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+// Every allocation of the process goes through these, so we can count allocations per call.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// GCC can't tell that our operator delete only ever gets pointers from our operator new
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<std::size_t> allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+struct point
+{
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& s, const point& p)
+{
+    return s << '(' << p.x << ", " << p.y << ')';
+}
+
+struct traits_point
+{
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& s, const traits_point& p)
+{
+    return s << '(' << p.x << ", " << p.y << ')';
+}
+} // namespace
+
+namespace nitro
+{
+template <>
+struct formatter_traits<traits_point>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const traits_point& p,
+                       const format_spec<Char>&)
+    {
+        format_spec<Char> spec;
+        out.push_back(Char('('));
+        formatter_traits<int>::append(out, p.x, spec);
+        out.append({ Char(','), Char(' ') });
+        formatter_traits<int>::append(out, p.y, spec);
+        out.push_back(Char(')'));
+    }
+};
+} // namespace nitro
+
+namespace
+{
+
+// keeps the compiler from optimizing the benchmarked calls away
+volatile std::size_t sink;
+
+template <typename Function>
+void run(const std::string& name, std::size_t iterations, Function f)
+{
+    // warm up, e.g., the format cache
+    for (std::size_t i = 0; i < iterations / 10 + 1; i++)
+    {
+        sink = f(i);
+    }
+
+    auto allocations_before = allocations.load();
+    auto begin = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+        sink = f(i);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    auto allocations_after = allocations.load();
+
+    auto ns = std::chrono::duration<double, std::nano>(end - begin).count() /
+              static_cast<double>(iterations);
+
+    std::cout << std::left << std::setw(52) << name << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1) << ns << std::setw(12) << std::setprecision(2)
+              << static_cast<double>(allocations_after - allocations_before) /
+                     static_cast<double>(iterations)
+              << std::endl;
+}
+
+std::string placeholders(std::size_t n, const std::string& placeholder)
+{
+    std::string result = "value:";
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        result += " " + placeholder;
+    }
+
+    return result;
+}
+
+template <typename T, std::size_t... I>
+std::size_t format_runtime(const std::string& fmt, const T& arg, std::index_sequence<I...>)
+{
+    std::string result = nitro::format(fmt).args((static_cast<void>(I), arg)...);
+    return result.size();
+}
+
+nitro::detail::formatter<char> literal_formatter(std::size_t placeholders)
+{
+    switch (placeholders)
+    {
+    case 0:
+        return "value:"_nf;
+    case 1:
+        return "value: {}"_nf;
+    case 2:
+        return "value: {} {}"_nf;
+    case 4:
+        return "value: {} {} {} {}"_nf;
+    default:
+        return "value: {} {} {} {} {} {} {} {}"_nf;
+    }
+}
+
+template <typename T, std::size_t... I>
+std::size_t format_literal(const T& arg, std::index_sequence<I...>)
+{
+    std::string result = literal_formatter(sizeof...(I)).args((static_cast<void>(I), arg)...);
+    return result.size();
+}
+
+template <typename T, std::size_t... I>
+std::size_t format_snprintf(const std::string& fmt, const T& arg, std::index_sequence<I...>)
+{
+    char buffer[512];
+    auto size = std::snprintf(buffer, sizeof(buffer), fmt.c_str(), (static_cast<void>(I), arg)...);
+    std::string result(buffer, static_cast<std::size_t>(size));
+    return result.size();
+}
+
+template <typename T, std::size_t... I>
+std::size_t format_stringstream(const T& arg, std::index_sequence<I...>)
+{
+    std::stringstream s;
+    s << "value:";
+
+    int expand[] = { 0, (static_cast<void>(I), s << ' ' << arg, 0)... };
+    static_cast<void>(expand);
+
+    return s.str().size();
+}
+
+template <std::size_t N, typename T, typename Printf>
+void run_placeholders(const std::string& type, std::size_t iterations, const T& arg,
+                      const char* printf_placeholder, const Printf& printf_arg)
+{
+    auto prefix = type + " x" + std::to_string(N) + " ";
+    auto fmt = placeholders(N, "{}");
+
+    run(prefix + "nitro::format (literal)", iterations,
+        [&](std::size_t) { return format_literal(arg, std::make_index_sequence<N>()); });
+
+    run(prefix + "nitro::format (runtime)", iterations,
+        [&](std::size_t) { return format_runtime(fmt, arg, std::make_index_sequence<N>()); });
+
+    if (printf_placeholder != nullptr)
+    {
+        auto printf_fmt = placeholders(N, printf_placeholder);
+
+        run(prefix + "snprintf", iterations, [&](std::size_t) {
+            return format_snprintf(printf_fmt, printf_arg, std::make_index_sequence<N>());
+        });
+    }
+
+    run(prefix + "std::stringstream", iterations,
+        [&](std::size_t) { return format_stringstream(arg, std::make_index_sequence<N>()); });
+}
+
+template <typename T, typename Printf>
+void run_type(const std::string& type, std::size_t iterations, const T& arg,
+              const char* printf_placeholder, const Printf& printf_arg)
+{
+    run_placeholders<0>(type, iterations, arg, printf_placeholder, printf_arg);
+    run_placeholders<1>(type, iterations, arg, printf_placeholder, printf_arg);
+    run_placeholders<2>(type, iterations, arg, printf_placeholder, printf_arg);
+    run_placeholders<4>(type, iterations, arg, printf_placeholder, printf_arg);
+    run_placeholders<8>(type, iterations, arg, printf_placeholder, printf_arg);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+
+    std::cout << std::left << std::setw(52) << "benchmark" << std::right << std::setw(12)
+              << "ns/call" << std::setw(12) << "allocs/call" << std::endl;
+
+    const std::string str = "a string which does not fit into the small string buffer";
+
+    run_type("int", iterations, 1234567, "%d", 1234567);
+    run_type("double", iterations, 3.14159265358979, "%.17g", 3.14159265358979);
+    run_type("string", iterations, str, "%s", str.c_str());
+    run_type("operator<< type", iterations, point{ 3, 4 }, nullptr, 0);
+    run_type("formatter_traits type", iterations, traits_point{ 3, 4 }, nullptr, 0);
+
+#if __cplusplus >= 201703L && defined(__cpp_lib_to_chars)
+    run("int std::to_chars", iterations, [](std::size_t i) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int>(i));
+        return std::string(buffer, result.ptr).size();
+    });
+
+    run("double std::to_chars", iterations, [](std::size_t i) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer),
+                                    3.14159265358979 * static_cast<double>(i));
+        return std::string(buffer, result.ptr).size();
+    });
+#endif
+
+    run("int nitro::format {:08x}", iterations, [](std::size_t i) {
+        std::string result = nitro::format("{:08x}") % static_cast<int>(i);
+        return result.size();
+    });
+
+    run("double nitro::format {}", iterations, [](std::size_t i) {
+        std::string result = nitro::format("{}") % (3.14159265358979 * static_cast<double>(i));
+        return result.size();
+    });
+
+    return 0;
+}
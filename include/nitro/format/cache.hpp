@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_NITRO_FORMAT_CACHE_HPP
+#define INCLUDE_NITRO_FORMAT_CACHE_HPP
+
+#include <nitro/format/spec.hpp>
+
+#include <nitro/lang/hash.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nitro
+{
+
+/**
+ * @brief A bounded cache mapping format strings to their compiled form.
+ *
+ * The cache is set associative with four entries per set. If all entries of a set are taken,
+ * the least recently used one is evicted.
+ *
+ * A cache instance is not synchronized. Instead, nitro::format() uses the instance of the calling
+ * thread, see local(), so lookups never contend with other threads.
+ */
+template <class Char, class Traits = std::char_traits<Char>>
+class format_cache
+{
+public:
+    using string_type = std::basic_string<Char, Traits>;
+    using compiled_type = detail::compiled_format<Char, Traits>;
+
+    static constexpr std::size_t ways = 4;
+
+    /**
+     * @param capacity the maximal number of cached format strings, rounded up to a power of two
+     */
+    explicit format_cache(std::size_t capacity = 256)
+    {
+        std::size_t sets = 1;
+        while (sets * ways < capacity)
+        {
+            sets *= 2;
+        }
+
+        entries_.resize(sets * ways);
+    }
+
+    /**
+     * @brief Returns the compiled form of format, compiling it on a miss.
+     */
+    std::shared_ptr<const compiled_type> get(const string_type& format)
+    {
+        auto hash = lang::hash(format);
+        auto set = entries_.data() + (hash & (entries_.size() / ways - 1)) * ways;
+        auto victim = set;
+
+        ++tick_;
+
+        for (auto entry = set; entry != set + ways; ++entry)
+        {
+            if (entry->compiled && entry->hash == hash && entry->compiled->str() == format)
+            {
+                ++hits_;
+                entry->last_used = tick_;
+                return entry->compiled;
+            }
+
+            if (entry->last_used < victim->last_used)
+            {
+                victim = entry;
+            }
+        }
+
+        ++misses_;
+
+        if (!victim->compiled)
+        {
+            ++size_;
+        }
+
+        victim->hash = hash;
+        victim->last_used = tick_;
+        victim->compiled = std::make_shared<const compiled_type>(format);
+
+        return victim->compiled;
+    }
+
+    /**
+     * @brief Removes all cached format strings, but keeps the counters.
+     */
+    void clear()
+    {
+        for (auto& entry : entries_)
+        {
+            entry = entry_type();
+        }
+
+        size_ = 0;
+    }
+
+    std::size_t capacity() const
+    {
+        return entries_.size();
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    std::uint64_t hits() const
+    {
+        return hits_;
+    }
+
+    std::uint64_t misses() const
+    {
+        return misses_;
+    }
+
+    /**
+     * @brief The cache used by nitro::format() in the calling thread
+     */
+    static format_cache& local()
+    {
+        static thread_local format_cache cache;
+
+        return cache;
+    }
+
+private:
+    struct entry_type
+    {
+        std::size_t hash = 0;
+        std::uint64_t last_used = 0;
+        std::shared_ptr<const compiled_type> compiled;
+    };
+
+    std::vector<entry_type> entries_;
+    std::size_t size_ = 0;
+    std::uint64_t tick_ = 0;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+} // namespace nitro
+
+#endif // INCLUDE_NITRO_FORMAT_CACHE_HPP
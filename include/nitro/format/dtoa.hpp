@@ -0,0 +1,1005 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * The Grisu2 implementation below (diyfp up to and including to_chars) is adapted from the
+ * to_chars implementation of JSON for Modern C++, https://github.com/nlohmann/json, which is
+ * licensed as follows:
+ *
+ * MIT License
+ *
+ * Copyright (c) 2013-2021 Niels Lohmann <https://nlohmann.me>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INCLUDE_NITRO_FORMAT_DTOA_HPP
+#define INCLUDE_NITRO_FORMAT_DTOA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace nitro
+{
+
+namespace detail
+{
+    /**
+     * Shortest round-trip conversion of floating point values to decimal digits, using the
+     * Grisu2 algorithm of Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+     * with Integers", PLDI 2010.
+     *
+     * The generated digits always parse back to the same value. In rare cases, there are shorter
+     * digit strings, which would parse back to the same value as well.
+     *
+     * For a given precision, to_chars_fixed, to_chars_exponent, and to_chars_general produce the
+     * exactly rounded digits of "%f", "%e", and "%g" from the full binary expansion of the value.
+     */
+    namespace dtoa
+    {
+        // A floating point number f * 2^e with an integral significand
+        struct diyfp
+        {
+            std::uint64_t f = 0;
+            int e = 0;
+
+            constexpr diyfp(std::uint64_t f_, int e_) noexcept : f(f_), e(e_)
+            {
+            }
+
+            static diyfp sub(const diyfp& x, const diyfp& y) noexcept
+            {
+                return { x.f - y.f, x.e };
+            }
+
+            // Returns x * y, rounded to the upper 64 bits of the product.
+            static diyfp mul(const diyfp& x, const diyfp& y) noexcept
+            {
+                const std::uint64_t u_lo = x.f & 0xFFFFFFFFu;
+                const std::uint64_t u_hi = x.f >> 32u;
+                const std::uint64_t v_lo = y.f & 0xFFFFFFFFu;
+                const std::uint64_t v_hi = y.f >> 32u;
+
+                const std::uint64_t p0 = u_lo * v_lo;
+                const std::uint64_t p1 = u_lo * v_hi;
+                const std::uint64_t p2 = u_hi * v_lo;
+                const std::uint64_t p3 = u_hi * v_hi;
+
+                std::uint64_t q = (p0 >> 32u) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+                q += std::uint64_t{ 1 } << 31u; // round
+
+                const std::uint64_t h = p3 + (p2 >> 32u) + (p1 >> 32u) + (q >> 32u);
+
+                return { h, x.e + y.e + 64 };
+            }
+
+            static diyfp normalize(diyfp x) noexcept
+            {
+                while ((x.f >> 63u) == 0)
+                {
+                    x.f <<= 1u;
+                    x.e--;
+                }
+
+                return x;
+            }
+
+            static diyfp normalize_to(const diyfp& x, int target_exponent) noexcept
+            {
+                return { x.f << (x.e - target_exponent), target_exponent };
+            }
+        };
+
+        // The value v and the boundaries m- and m+ of the interval of all real numbers, which
+        // round to v. All three share the exponent of m+.
+        struct boundaries
+        {
+            diyfp w;
+            diyfp minus;
+            diyfp plus;
+        };
+
+        template <typename Float>
+        inline boundaries compute_boundaries(Float value)
+        {
+            static_assert(std::numeric_limits<Float>::is_iec559 &&
+                              (sizeof(Float) == 4 || sizeof(Float) == 8),
+                          "Only IEEE 754 single and double precision are supported");
+
+            using bits_type =
+                typename std::conditional<sizeof(Float) == 4, std::uint32_t, std::uint64_t>::type;
+
+            constexpr int precision = std::numeric_limits<Float>::digits; // incl. hidden bit
+            constexpr int bias = std::numeric_limits<Float>::max_exponent - 1 + (precision - 1);
+            constexpr int min_exponent = 1 - bias;
+            constexpr std::uint64_t hidden_bit = std::uint64_t{ 1 } << (precision - 1);
+
+            bits_type bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            const std::uint64_t E = bits >> (precision - 1);
+            const std::uint64_t F = bits & (hidden_bit - 1);
+
+            const bool is_denormal = E == 0;
+            const diyfp v = is_denormal ? diyfp(F, min_exponent)
+                                        : diyfp(F + hidden_bit, static_cast<int>(E) - bias);
+
+            // The lower boundary is closer, if v is a power of two, except for the smallest
+            // normalized value.
+            const bool lower_boundary_is_closer = F == 0 && E > 1;
+            const diyfp m_plus(2 * v.f + 1, v.e - 1);
+            const diyfp m_minus = lower_boundary_is_closer ? diyfp(4 * v.f - 1, v.e - 2)
+                                                           : diyfp(2 * v.f - 1, v.e - 1);
+
+            const diyfp w_plus = diyfp::normalize(m_plus);
+            const diyfp w_minus = diyfp::normalize_to(m_minus, w_plus.e);
+
+            return { diyfp::normalize(v), w_minus, w_plus };
+        }
+
+        // The range of binary exponents, which allows the digit generation to work on 32 bit
+        // integral and 64 bit fractional parts.
+        constexpr int alpha = -60;
+        constexpr int gamma = -32;
+
+        struct cached_power
+        {
+            std::uint64_t f;
+            int e;
+            int k;
+        };
+
+        // Returns c = 10^k = f * 2^e, such that alpha <= e_c + e + 64 <= gamma.
+        inline cached_power get_cached_power(int e)
+        {
+            // f = round(10^k * 2^-e), for k = -300, -292, ..., 324
+            static constexpr cached_power powers[] = {
+            { 0xAB70FE17C79AC6CA, -1060, -300 },
+            { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+            { 0xBE5691EF416BD60C, -1007, -284 },
+            { 0x8DD01FAD907FFC3C, -980, -276 },
+            { 0xD3515C2831559A83, -954, -268 },
+            { 0x9D71AC8FADA6C9B5, -927, -260 },
+            { 0xEA9C227723EE8BCB, -901, -252 },
+            { 0xAECC49914078536D, -874, -244 },
+            { 0x823C12795DB6CE57, -847, -236 },
+            { 0xC21094364DFB5637, -821, -228 },
+            { 0x9096EA6F3848984F, -794, -220 },
+            { 0xD77485CB25823AC7, -768, -212 },
+            { 0xA086CFCD97BF97F4, -741, -204 },
+            { 0xEF340A98172AACE5, -715, -196 },
+            { 0xB23867FB2A35B28E, -688, -188 },
+            { 0x84C8D4DFD2C63F3B, -661, -180 },
+            { 0xC5DD44271AD3CDBA, -635, -172 },
+            { 0x936B9FCEBB25C996, -608, -164 },
+            { 0xDBAC6C247D62A584, -582, -156 },
+            { 0xA3AB66580D5FDAF6, -555, -148 },
+            { 0xF3E2F893DEC3F126, -529, -140 },
+            { 0xB5B5ADA8AAFF80B8, -502, -132 },
+            { 0x87625F056C7C4A8B, -475, -124 },
+            { 0xC9BCFF6034C13053, -449, -116 },
+            { 0x964E858C91BA2655, -422, -108 },
+            { 0xDFF9772470297EBD, -396, -100 },
+            { 0xA6DFBD9FB8E5B88F, -369, -92 },
+            { 0xF8A95FCF88747D94, -343, -84 },
+            { 0xB94470938FA89BCF, -316, -76 },
+            { 0x8A08F0F8BF0F156B, -289, -68 },
+            { 0xCDB02555653131B6, -263, -60 },
+            { 0x993FE2C6D07B7FAC, -236, -52 },
+            { 0xE45C10C42A2B3B06, -210, -44 },
+            { 0xAA242499697392D3, -183, -36 },
+            { 0xFD87B5F28300CA0E, -157, -28 },
+            { 0xBCE5086492111AEB, -130, -20 },
+            { 0x8CBCCC096F5088CC, -103, -12 },
+            { 0xD1B71758E219652C, -77, -4 },
+            { 0x9C40000000000000, -50, 4 },
+            { 0xE8D4A51000000000, -24, 12 },
+            { 0xAD78EBC5AC620000, 3, 20 },
+            { 0x813F3978F8940984, 30, 28 },
+            { 0xC097CE7BC90715B3, 56, 36 },
+            { 0x8F7E32CE7BEA5C70, 83, 44 },
+            { 0xD5D238A4ABE98068, 109, 52 },
+            { 0x9F4F2726179A2245, 136, 60 },
+            { 0xED63A231D4C4FB27, 162, 68 },
+            { 0xB0DE65388CC8ADA8, 189, 76 },
+            { 0x83C7088E1AAB65DB, 216, 84 },
+            { 0xC45D1DF942711D9A, 242, 92 },
+            { 0x924D692CA61BE758, 269, 100 },
+            { 0xDA01EE641A708DEA, 295, 108 },
+            { 0xA26DA3999AEF774A, 322, 116 },
+            { 0xF209787BB47D6B85, 348, 124 },
+            { 0xB454E4A179DD1877, 375, 132 },
+            { 0x865B86925B9BC5C2, 402, 140 },
+            { 0xC83553C5C8965D3D, 428, 148 },
+            { 0x952AB45CFA97A0B3, 455, 156 },
+            { 0xDE469FBD99A05FE3, 481, 164 },
+            { 0xA59BC234DB398C25, 508, 172 },
+            { 0xF6C69A72A3989F5C, 534, 180 },
+            { 0xB7DCBF5354E9BECE, 561, 188 },
+            { 0x88FCF317F22241E2, 588, 196 },
+            { 0xCC20CE9BD35C78A5, 614, 204 },
+            { 0x98165AF37B2153DF, 641, 212 },
+            { 0xE2A0B5DC971F303A, 667, 220 },
+            { 0xA8D9D1535CE3B396, 694, 228 },
+            { 0xFB9B7CD9A4A7443C, 720, 236 },
+            { 0xBB764C4CA7A44410, 747, 244 },
+            { 0x8BAB8EEFB6409C1A, 774, 252 },
+            { 0xD01FEF10A657842C, 800, 260 },
+            { 0x9B10A4E5E9913129, 827, 268 },
+            { 0xE7109BFBA19C0C9D, 853, 276 },
+            { 0xAC2820D9623BF429, 880, 284 },
+            { 0x80444B5E7AA7CF85, 907, 292 },
+            { 0xBF21E44003ACDD2D, 933, 300 },
+            { 0x8E679C2F5E44FF8F, 960, 308 },
+            { 0xD433179D9C8CB841, 986, 316 },
+            { 0x9E19DB92B4E31BA9, 1013, 324 },
+            };
+
+            constexpr int min_decimal_exponent = -300;
+            constexpr int decimal_step = 8;
+
+            const int f = alpha - e - 1;
+            const int k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+            const int index = (-min_decimal_exponent + k + (decimal_step - 1)) / decimal_step;
+
+            return powers[index];
+        }
+
+        // Returns the number of decimal digits of n and the largest power of ten <= n.
+        inline int find_largest_pow10(std::uint32_t n, std::uint32_t& pow10)
+        {
+            static constexpr std::uint32_t powers[] = {
+                1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+            };
+
+            int k = 10;
+            while (k > 1 && n < powers[k - 1])
+            {
+                --k;
+            }
+
+            pow10 = powers[k - 1];
+            return k;
+        }
+
+        inline void round(char* buffer, int length, std::uint64_t dist, std::uint64_t delta,
+                          std::uint64_t rest, std::uint64_t ten_k)
+        {
+            // Move the last digit towards w, as long as the result stays within the boundaries
+            // and gets closer to w.
+            while (rest < dist && delta - rest >= ten_k &&
+                   (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+            {
+                buffer[length - 1]--;
+                rest += ten_k;
+            }
+        }
+
+        // Generates the shortest digits V of M+, with M- <= V * 10^decimal_exponent <= M+,
+        // closest to w.
+        inline void generate_digits(char* buffer, int& length, int& decimal_exponent,
+                                    diyfp M_minus, diyfp w, diyfp M_plus)
+        {
+            std::uint64_t delta = diyfp::sub(M_plus, M_minus).f;
+            std::uint64_t dist = diyfp::sub(M_plus, w).f;
+
+            const diyfp one(std::uint64_t{ 1 } << -M_plus.e, M_plus.e);
+
+            auto p1 = static_cast<std::uint32_t>(M_plus.f >> -one.e);
+            std::uint64_t p2 = M_plus.f & (one.f - 1);
+
+            std::uint32_t pow10;
+            int n = find_largest_pow10(p1, pow10);
+
+            while (n > 0)
+            {
+                const std::uint32_t d = p1 / pow10;
+                p1 %= pow10;
+                buffer[length++] = static_cast<char>('0' + d);
+                n--;
+
+                const std::uint64_t rest = (std::uint64_t{ p1 } << -one.e) + p2;
+                if (rest <= delta)
+                {
+                    decimal_exponent += n;
+                    round(buffer, length, dist, delta, rest, std::uint64_t{ pow10 } << -one.e);
+                    return;
+                }
+
+                pow10 /= 10;
+            }
+
+            int m = 0;
+            while (true)
+            {
+                p2 *= 10;
+                const std::uint64_t d = p2 >> -one.e;
+                p2 &= one.f - 1;
+                buffer[length++] = static_cast<char>('0' + d);
+                m++;
+
+                delta *= 10;
+                dist *= 10;
+                if (p2 <= delta)
+                {
+                    break;
+                }
+            }
+
+            decimal_exponent -= m;
+            round(buffer, length, dist, delta, p2, one.f);
+        }
+
+        /**
+         * @brief Writes the shortest decimal digits of value to buffer.
+         *
+         * value must be finite and positive. At most 17 digits are written.
+         *
+         * @return the number of digits, the value is digits * 10^decimal_exponent
+         */
+        template <typename Float>
+        inline int grisu2(char* buffer, int& decimal_exponent, Float value)
+        {
+            const boundaries b = compute_boundaries(value);
+            const cached_power cached = get_cached_power(b.plus.e);
+            const diyfp c_minus_k(cached.f, cached.e);
+
+            const diyfp w = diyfp::mul(b.w, c_minus_k);
+            const diyfp w_minus = diyfp::mul(b.minus, c_minus_k);
+            const diyfp w_plus = diyfp::mul(b.plus, c_minus_k);
+
+            // The products are off by at most one ulp, so shrink the interval to be safe.
+            const diyfp M_minus(w_minus.f + 1, w_minus.e);
+            const diyfp M_plus(w_plus.f - 1, w_plus.e);
+
+            int length = 0;
+            decimal_exponent = -cached.k;
+            generate_digits(buffer, length, decimal_exponent, M_minus, w, M_plus);
+
+            return length;
+        }
+
+        /**
+         * @brief Writes value to buffer, which needs space for 32 characters.
+         *
+         * Like "%g", the fixed notation is used for values with a decimal exponent in
+         * [-4, max_digits10) and the scientific notation otherwise, but with the shortest digits,
+         * that round-trip, instead of a fixed precision.
+         *
+         * @return pointer past the last written character
+         */
+        template <typename Float>
+        inline char* to_chars(char* first, Float value)
+        {
+            if (std::signbit(value))
+            {
+                *first++ = '-';
+                value = -value;
+            }
+
+            if (value == 0)
+            {
+                *first++ = '0';
+                return first;
+            }
+
+            char digits[20];
+            int decimal_exponent;
+            const int length = grisu2(digits, decimal_exponent, value);
+
+            // exponent of the scientific notation d.ddd * 10^x
+            const int x = length + decimal_exponent - 1;
+
+            if (x >= -4 && x < std::numeric_limits<Float>::max_digits10)
+            {
+                if (decimal_exponent >= 0)
+                {
+                    std::memcpy(first, digits, static_cast<std::size_t>(length));
+                    first += length;
+                    std::memset(first, '0', static_cast<std::size_t>(decimal_exponent));
+                    return first + decimal_exponent;
+                }
+
+                if (x >= 0)
+                {
+                    std::memcpy(first, digits, static_cast<std::size_t>(x + 1));
+                    first += x + 1;
+                    *first++ = '.';
+                    std::memcpy(first, digits + x + 1, static_cast<std::size_t>(length - x - 1));
+                    return first + length - x - 1;
+                }
+
+                *first++ = '0';
+                *first++ = '.';
+                std::memset(first, '0', static_cast<std::size_t>(-x - 1));
+                first += -x - 1;
+                std::memcpy(first, digits, static_cast<std::size_t>(length));
+                return first + length;
+            }
+
+            *first++ = digits[0];
+
+            if (length > 1)
+            {
+                *first++ = '.';
+                std::memcpy(first, digits + 1, static_cast<std::size_t>(length - 1));
+                first += length - 1;
+            }
+
+            *first++ = 'e';
+            *first++ = x < 0 ? '-' : '+';
+
+            auto exponent = static_cast<unsigned>(x < 0 ? -x : x);
+            if (exponent >= 100)
+            {
+                *first++ = static_cast<char>('0' + exponent / 100);
+                exponent %= 100;
+            }
+            *first++ = static_cast<char>('0' + exponent / 10);
+            *first++ = static_cast<char>('0' + exponent % 10);
+
+            return first;
+        }
+
+        /**
+         * An unsigned integer of up to 1280 bits, which holds the integral part of any double, as
+         * well as the numerator of its fractional part times ten.
+         */
+        class bigint
+        {
+        public:
+            explicit bigint(std::uint64_t value) noexcept
+            {
+                words_[0] = static_cast<std::uint32_t>(value);
+                words_[1] = static_cast<std::uint32_t>(value >> 32u);
+                size_ = words_[1] != 0 ? 2 : (words_[0] != 0 ? 1 : 0);
+            }
+
+            bool is_zero() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            bool bit(int index) const noexcept
+            {
+                const int word = index / 32;
+                return word < size_ && ((words_[word] >> (index % 32)) & 1u) != 0;
+            }
+
+            // whether any bit below index is set
+            bool any_below(int index) const noexcept
+            {
+                const int word = index / 32;
+
+                for (int i = 0; i < word && i < size_; i++)
+                {
+                    if (words_[i] != 0)
+                    {
+                        return true;
+                    }
+                }
+
+                const std::uint32_t mask = (std::uint32_t{ 1 } << (index % 32)) - 1;
+                return word < size_ && (words_[word] & mask) != 0;
+            }
+
+            void shift_left(int bits) noexcept
+            {
+                if (size_ == 0)
+                {
+                    return;
+                }
+
+                const int words = bits / 32;
+                const int rest = bits % 32;
+
+                words_[size_ + words] = 0;
+
+                for (int i = size_ - 1; i >= 0; i--)
+                {
+                    const std::uint64_t shifted = std::uint64_t{ words_[i] } << rest;
+                    words_[i + words + 1] |= static_cast<std::uint32_t>(shifted >> 32u);
+                    words_[i + words] = static_cast<std::uint32_t>(shifted);
+                }
+
+                for (int i = 0; i < words; i++)
+                {
+                    words_[i] = 0;
+                }
+
+                size_ += words + 1;
+                trim();
+            }
+
+            void multiply(std::uint32_t factor) noexcept
+            {
+                std::uint64_t carry = 0;
+
+                for (int i = 0; i < size_; i++)
+                {
+                    const std::uint64_t product = std::uint64_t{ words_[i] } * factor + carry;
+                    words_[i] = static_cast<std::uint32_t>(product);
+                    carry = product >> 32u;
+                }
+
+                if (carry != 0)
+                {
+                    words_[size_++] = static_cast<std::uint32_t>(carry);
+                }
+            }
+
+            // divides in place and returns the remainder
+            std::uint32_t divide(std::uint32_t divisor) noexcept
+            {
+                std::uint64_t remainder = 0;
+
+                for (int i = size_ - 1; i >= 0; i--)
+                {
+                    const std::uint64_t current = (remainder << 32u) | words_[i];
+                    words_[i] = static_cast<std::uint32_t>(current / divisor);
+                    remainder = current % divisor;
+                }
+
+                trim();
+                return static_cast<std::uint32_t>(remainder);
+            }
+
+            // removes and returns the bits from index on, which must fit into 32 bits
+            std::uint32_t split(int index) noexcept
+            {
+                const int word = index / 32;
+                const int rest = index % 32;
+
+                std::uint64_t high = 0;
+                if (word + 1 < size_)
+                {
+                    high = std::uint64_t{ words_[word + 1] } << 32u;
+                }
+                if (word < size_)
+                {
+                    high |= words_[word];
+                }
+
+                const auto result = static_cast<std::uint32_t>(high >> rest);
+
+                if (word < size_)
+                {
+                    words_[word] &= (std::uint32_t{ 1 } << rest) - 1;
+                    for (int i = word + 1; i < size_; i++)
+                    {
+                        words_[i] = 0;
+                    }
+                    size_ = word + 1;
+                    trim();
+                }
+
+                return result;
+            }
+
+        private:
+            void trim() noexcept
+            {
+                while (size_ > 0 && words_[size_ - 1] == 0)
+                {
+                    size_--;
+                }
+            }
+
+            std::uint32_t words_[40] = {};
+            int size_ = 0;
+        };
+
+        /**
+         * The exact decimal expansion of a finite, non-negative double. The integral digits are
+         * computed at once, the fractional digits one at a time on request.
+         */
+        class exact_decimal
+        {
+        public:
+            explicit exact_decimal(double value) noexcept : fraction_(0)
+            {
+                std::uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                const std::uint64_t E = (bits >> 52u) & 0x7FFu;
+                const std::uint64_t F = bits & ((std::uint64_t{ 1 } << 52u) - 1);
+
+                const std::uint64_t m = E == 0 ? F : F | (std::uint64_t{ 1 } << 52u);
+                const int e = E == 0 ? -1074 : static_cast<int>(E) - 1075;
+
+                if (e >= 0)
+                {
+                    bigint integer(m);
+                    integer.shift_left(e);
+                    set_integer(integer);
+                }
+                else
+                {
+                    fraction_bits_ = -e;
+                    set_integer(bigint(fraction_bits_ < 64 ? m >> fraction_bits_ : 0));
+                    fraction_ = bigint(
+                        fraction_bits_ < 64 ? m & ((std::uint64_t{ 1 } << fraction_bits_) - 1) : m);
+                }
+            }
+
+            // the digits of the integral part, none if it is zero
+            const char* integer_digits() const noexcept
+            {
+                return integer_ + sizeof(integer_) - integer_length_;
+            }
+
+            int integer_length() const noexcept
+            {
+                return integer_length_;
+            }
+
+            int next_digit() noexcept
+            {
+                if (fraction_.is_zero())
+                {
+                    return 0;
+                }
+
+                fraction_.multiply(10);
+                return static_cast<int>(fraction_.split(fraction_bits_));
+            }
+
+            bool rest_is_zero() const noexcept
+            {
+                return fraction_.is_zero();
+            }
+
+            // compares the fraction after the generated digits with half a unit of the last one
+            int compare_rest_to_half() const noexcept
+            {
+                if (fraction_.is_zero() || !fraction_.bit(fraction_bits_ - 1))
+                {
+                    return -1;
+                }
+
+                return fraction_.any_below(fraction_bits_ - 1) ? 1 : 0;
+            }
+
+        private:
+            void set_integer(bigint integer) noexcept
+            {
+                char* first = integer_ + sizeof(integer_);
+
+                while (!integer.is_zero())
+                {
+                    auto chunk = integer.divide(1000000000u);
+
+                    for (int i = 0; i < 9; i++)
+                    {
+                        *--first = static_cast<char>('0' + chunk % 10);
+                        chunk /= 10;
+                    }
+                }
+
+                while (first != integer_ + sizeof(integer_) && *first == '0')
+                {
+                    first++;
+                }
+
+                integer_length_ = static_cast<int>(integer_ + sizeof(integer_) - first);
+            }
+
+            // 2^1024 has 309 digits, rounded up to whole chunks of nine
+            char integer_[315];
+            int integer_length_ = 0;
+            bigint fraction_;
+            int fraction_bits_ = 0;
+        };
+
+        // adds one to the last of length digits, returns whether the carry ran out of digits
+        inline bool round_up(char* digits, int length) noexcept
+        {
+            for (int i = length - 1; i >= 0; i--)
+            {
+                if (digits[i] != '9')
+                {
+                    digits[i]++;
+                    return false;
+                }
+
+                digits[i] = '0';
+            }
+
+            return true;
+        }
+
+        inline bool round_half_even(int compare_to_half, char last_digit) noexcept
+        {
+            return compare_to_half > 0 || (compare_to_half == 0 && (last_digit - '0') % 2 == 1);
+        }
+
+        /**
+         * @brief Writes the count most significant digits of value, correctly rounded.
+         *
+         * value must be finite and positive.
+         *
+         * @return the decimal exponent of the first digit
+         */
+        inline int significant_digits(char* digits, int count, double value) noexcept
+        {
+            exact_decimal decimal(value);
+
+            const int integer_length = decimal.integer_length();
+            const char* integer = decimal.integer_digits();
+
+            int exponent;
+            int compare;
+
+            if (integer_length >= count)
+            {
+                std::memcpy(digits, integer, static_cast<std::size_t>(count));
+                exponent = integer_length - 1;
+
+                if (integer_length == count)
+                {
+                    compare = decimal.compare_rest_to_half();
+                }
+                else if (integer[count] != '5')
+                {
+                    compare = integer[count] > '5' ? 1 : -1;
+                }
+                else
+                {
+                    compare = decimal.rest_is_zero() ? 0 : 1;
+
+                    for (int i = count + 1; i < integer_length && compare == 0; i++)
+                    {
+                        compare = integer[i] != '0' ? 1 : 0;
+                    }
+                }
+            }
+            else
+            {
+                int length = integer_length;
+                std::memcpy(digits, integer, static_cast<std::size_t>(length));
+                exponent = integer_length - 1;
+
+                if (length == 0)
+                {
+                    int digit = decimal.next_digit();
+
+                    while (digit == 0)
+                    {
+                        digit = decimal.next_digit();
+                        exponent--;
+                    }
+
+                    digits[length++] = static_cast<char>('0' + digit);
+                }
+
+                while (length < count)
+                {
+                    digits[length++] = static_cast<char>('0' + decimal.next_digit());
+                }
+
+                compare = decimal.compare_rest_to_half();
+            }
+
+            if (round_half_even(compare, digits[count - 1]) && round_up(digits, count))
+            {
+                digits[0] = '1';
+                exponent++;
+            }
+
+            return exponent;
+        }
+
+        // the size of a buffer, which fits any value written by the functions below
+        inline std::size_t max_chars(int precision) noexcept
+        {
+            return static_cast<std::size_t>(precision) + 330;
+        }
+
+        /**
+         * @brief Writes value with precision digits after the decimal point, like "%.*f".
+         *
+         * value must be finite and non-negative. Unlike printf, this ignores the locale.
+         *
+         * @return pointer past the last written character
+         */
+        inline char* to_chars_fixed(char* first, double value, int precision, bool alternate)
+        {
+            exact_decimal decimal(value);
+
+            // one leading digit for the carry of the rounding
+            char* digits = first;
+            *digits = '0';
+
+            int length = 1;
+            if (decimal.integer_length() == 0)
+            {
+                digits[length++] = '0';
+            }
+            else
+            {
+                std::memcpy(digits + length, decimal.integer_digits(),
+                            static_cast<std::size_t>(decimal.integer_length()));
+                length += decimal.integer_length();
+            }
+
+            const int integer_end = length;
+
+            for (int i = 0; i < precision; i++)
+            {
+                digits[length++] = static_cast<char>('0' + decimal.next_digit());
+            }
+
+            if (round_half_even(decimal.compare_rest_to_half(), digits[length - 1]))
+            {
+                round_up(digits, length);
+            }
+
+            // drop the carry digit, if it is unused
+            const int offset = digits[0] == '0' ? 1 : 0;
+            std::memmove(first, digits + offset, static_cast<std::size_t>(integer_end - offset));
+            char* last = first + integer_end - offset;
+
+            if (precision > 0 || alternate)
+            {
+                std::memmove(last + 1, digits + integer_end, static_cast<std::size_t>(precision));
+                *last = '.';
+                last += precision + 1;
+            }
+
+            return last;
+        }
+
+        /**
+         * @brief Writes value with one digit before and precision digits after the decimal point
+         *        followed by the exponent, like "%.*e".
+         *
+         * value must be finite and non-negative.
+         *
+         * @return pointer past the last written character
+         */
+        inline char* to_chars_exponent(char* first, double value, int precision, bool upper,
+                                       bool alternate)
+        {
+            char* digits = first + 1;
+            int exponent = 0;
+
+            if (value == 0)
+            {
+                std::fill_n(digits, precision + 1, '0');
+            }
+            else
+            {
+                exponent = significant_digits(digits, precision + 1, value);
+            }
+
+            first[0] = digits[0];
+            char* last = first + 1;
+
+            if (precision > 0 || alternate)
+            {
+                *last = '.';
+                last += precision + 1;
+            }
+
+            *last++ = upper ? 'E' : 'e';
+            *last++ = exponent < 0 ? '-' : '+';
+
+            auto abs_exponent = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+            if (abs_exponent >= 100)
+            {
+                *last++ = static_cast<char>('0' + abs_exponent / 100);
+                abs_exponent %= 100;
+            }
+            *last++ = static_cast<char>('0' + abs_exponent / 10);
+            *last++ = static_cast<char>('0' + abs_exponent % 10);
+
+            return last;
+        }
+
+        /**
+         * @brief Writes value with precision significant digits, like "%.*g".
+         *
+         * value must be finite and non-negative.
+         *
+         * @return pointer past the last written character
+         */
+        inline char* to_chars_general(char* first, double value, int precision, bool upper,
+                                      bool alternate)
+        {
+            if (precision == 0)
+            {
+                precision = 1;
+            }
+
+            int exponent = 0;
+            if (value != 0)
+            {
+                exponent = significant_digits(first, precision, value);
+            }
+
+            char* last;
+            if (exponent >= -4 && exponent < precision)
+            {
+                last = to_chars_fixed(first, value, precision - 1 - exponent, alternate);
+            }
+            else
+            {
+                last = to_chars_exponent(first, value, precision - 1, upper, alternate);
+            }
+
+            if (alternate)
+            {
+                return last;
+            }
+
+            char* point = std::find(first, last, '.');
+            if (point == last)
+            {
+                return last;
+            }
+
+            char* mantissa_end =
+                std::find_if(point, last, [](char c) { return c == 'e' || c == 'E'; });
+            char* trimmed = mantissa_end;
+
+            while (trimmed[-1] == '0')
+            {
+                trimmed--;
+            }
+
+            if (trimmed[-1] == '.')
+            {
+                trimmed--;
+            }
+
+            std::memmove(trimmed, mantissa_end, static_cast<std::size_t>(last - mantissa_end));
+            return trimmed + (last - mantissa_end);
+        }
+    } // namespace dtoa
+} // namespace detail
+} // namespace nitro
+
+#endif // INCLUDE_NITRO_FORMAT_DTOA_HPP
@@ -29,18 +29,35 @@
 #ifndef INCLUDE_NITRO_FORMAT_FORMAT_HPP
 #define INCLUDE_NITRO_FORMAT_FORMAT_HPP
 
+#include <nitro/format/cache.hpp>
+#include <nitro/format/spec.hpp>
+#include <nitro/format/traits.hpp>
+
 #include <nitro/except/raise.hpp>
 
 #include <cstdio>
-#include <regex>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace nitro
 {
 
 namespace detail
 {
+    /**
+     * @brief An argument, which is referenced in the format string by its name, e.g., "{name}".
+     *
+     * Use nitro::arg() to create one.
+     */
+    template <class Char, typename T>
+    struct named_argument
+    {
+        const Char* name;
+        const T& value;
+    };
+
     template <class Char, class Traits = std::char_traits<Char>>
     class formatter
     {
@@ -50,17 +67,16 @@ namespace detail
         using string_type = std::basic_string<Char, Traits>;
         using stream_type = std::basic_stringstream<Char, Traits>;
 
-        formatter(const string_type& format) : format_(format)
+        formatter(const string_type& format)
+        : format_(format_cache<Char, Traits>::local().get(format)),
+          results_(format_->fields().size()), written_(format_->fields().size(), false)
         {
         }
 
         template <typename T>
         self& operator%(T&& arg)
         {
-            stream_type str;
-            str << std::forward<T>(arg);
-
-            args_.emplace_back(str.str());
+            add_argument(arg);
 
             return *this;
         }
@@ -80,32 +96,43 @@ namespace detail
 
         string_type str() const
         {
-            string_type result;
+            if (unused_argument_)
+            {
+                raise("Provided more arguments than placeholders available in format string");
+            }
 
-            std::regex r("\\{\\}");
+            std::size_t size = format_->literal_size();
+            for (const auto& result : results_)
+            {
+                size += result.size();
+            }
 
-            auto input = format_.begin();
-            auto placeholders_begin = std::sregex_iterator(format_.begin(), format_.end(), r);
-            auto placeholders_end = std::sregex_iterator();
-            auto placeholder = placeholders_begin;
+            string_type result;
+            result.reserve(size);
 
-            for (auto it = args_.begin(); it != args_.end(); ++it, ++placeholder)
+            for (const auto& segment : format_->segments())
             {
-                if (placeholder == placeholders_end)
+                result.append(format_->literal(segment), segment.length);
+
+                if (segment.field == compiled_format<Char, Traits>::no_field)
                 {
-                    raise("Provided more arguments than placeholders available in format string");
+                    continue;
                 }
 
-                result.append(input, format_.begin() + placeholder->position());
-                input = format_.begin() + placeholder->position() + placeholder->length();
-                result.append(it->begin(), it->end());
-            }
+                if (written_[segment.field])
+                {
+                    result.append(results_[segment.field]);
+                    continue;
+                }
 
-            result.append(input, format_.end());
+                // a name without a matching nitro::arg() is not a field, e.g., "json: {key}"
+                const auto& field = format_->fields()[segment.field];
+                if (field.index != format_field<Char, Traits>::named)
+                {
+                    raise("Provided less arguments than placeholders needed in format string");
+                }
 
-            if (placeholder != placeholders_end)
-            {
-                raise("Provided less arguments than placeholders needed in format string");
+                result.append(format_->str(), field.offset, field.length);
             }
 
             return result;
@@ -117,8 +144,54 @@ namespace detail
         }
 
     private:
-        string_type format_;
-        std::vector<string_type> args_;
+        template <typename T>
+        void add_argument(const T& value)
+        {
+            add_argument(nullptr, value);
+        }
+
+        template <typename T>
+        void add_argument(const named_argument<Char, T>& arg)
+        {
+            add_argument(arg.name, arg.value);
+        }
+
+        // Arguments are written as soon as they are passed, once for every field referencing them.
+        // Only the results are kept, so temporaries can be passed safely.
+        template <typename T>
+        void add_argument(const Char* name, const T& value)
+        {
+            auto index = arguments_++;
+            const auto& fields = format_->fields();
+            bool used = false;
+
+            for (std::size_t i = 0; i < fields.size(); ++i)
+            {
+                const auto& field = fields[i];
+
+                if (field.index == index ||
+                    (name != nullptr && field.index == format_field<Char, Traits>::named &&
+                     field.name == name))
+                {
+                    results_[i].clear();
+                    write_formatted(results_[i], value, field.spec);
+                    written_[i] = true;
+                    used = true;
+                }
+            }
+
+            if (!used)
+            {
+                unused_argument_ = true;
+            }
+        }
+
+    private:
+        std::shared_ptr<const compiled_format<Char, Traits>> format_;
+        std::vector<string_type> results_;
+        std::vector<bool> written_;
+        std::size_t arguments_ = 0;
+        bool unused_argument_ = false;
     };
 
     template <class Char, class Traits = std::char_traits<Char>>
@@ -128,6 +201,17 @@ namespace detail
     }
 } // namespace detail
 
+/**
+ * @brief Creates an argument for the named replacement field "{name}".
+ *
+ * The returned object references value, so it must be passed to a formatter immediately.
+ */
+template <class Char, typename T>
+inline auto arg(const Char* name, const T& value) -> detail::named_argument<Char, T>
+{
+    return { name, value };
+}
+
 template <class Char, class Traits>
 inline auto format(const std::basic_string<Char, Traits>& format_str)
     -> detail::formatter<Char, Traits>
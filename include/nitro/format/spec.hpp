@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_NITRO_FORMAT_SPEC_HPP
+#define INCLUDE_NITRO_FORMAT_SPEC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nitro
+{
+
+namespace detail
+{
+    enum class format_align
+    {
+        none,
+        left,
+        right,
+        center
+    };
+
+    enum class format_sign
+    {
+        minus,
+        plus,
+        space
+    };
+
+    /**
+     * @brief The parsed form of everything following the colon in a replacement field.
+     *
+     * The grammar is a subset of the one of std::format:
+     *
+     *     [[fill]align][sign]['#']['0'][width]['.' precision][type]
+     *
+     * with align one of '<', '>', '^', sign one of '+', '-', ' ' and type one of
+     * "bBcdoxXeEfFgGs".
+     */
+    template <class Char>
+    struct format_spec
+    {
+        Char fill = Char(' ');
+        format_align align = format_align::none;
+        format_sign sign = format_sign::minus;
+        bool alternate = false;
+        bool zero_pad = false;
+        std::size_t width = 0;
+        int precision = -1;
+        char type = '\0';
+    };
+
+    /**
+     * @brief A replacement field, i.e., "{}", "{1:>8}" or "{name:.3f}".
+     *
+     * Fields without an explicit index or name are numbered automatically in order of their
+     * appearance. Named fields have the index format_field::named. The field covers the characters
+     * [offset, offset + length) of the format string.
+     */
+    template <class Char, class Traits = std::char_traits<Char>>
+    struct format_field
+    {
+        static constexpr std::size_t named = std::numeric_limits<std::size_t>::max();
+
+        std::size_t index = named;
+        std::basic_string<Char, Traits> name;
+        format_spec<Char> spec;
+        std::size_t offset = 0;
+        std::size_t length = 0;
+    };
+
+    template <class Char>
+    inline bool is_format_digit(Char c)
+    {
+        return c >= Char('0') && c <= Char('9');
+    }
+
+    template <class Char>
+    inline bool is_format_name_start(Char c)
+    {
+        return (c >= Char('a') && c <= Char('z')) || (c >= Char('A') && c <= Char('Z')) ||
+               c == Char('_');
+    }
+
+    template <class Char>
+    inline bool is_format_name_char(Char c)
+    {
+        return is_format_name_start(c) || is_format_digit(c);
+    }
+
+    template <class Char>
+    inline bool parse_format_align(Char c, format_align& align)
+    {
+        switch (c)
+        {
+        case Char('<'):
+            align = format_align::left;
+            return true;
+        case Char('>'):
+            align = format_align::right;
+            return true;
+        case Char('^'):
+            align = format_align::center;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    template <class Char>
+    inline const Char* parse_format_number(const Char* first, const Char* last, std::size_t& value)
+    {
+        value = 0;
+
+        for (; first != last && is_format_digit(*first); ++first)
+        {
+            auto digit = static_cast<std::size_t>(*first - Char('0'));
+
+            if (value > (std::numeric_limits<int>::max() - digit) / 10)
+            {
+                return nullptr;
+            }
+
+            value = value * 10 + digit;
+        }
+
+        return first;
+    }
+
+    /**
+     * @brief Parses the format spec in [first, last).
+     *
+     * @return whether the complete range was a valid format spec
+     */
+    template <class Char>
+    inline bool parse_format_spec(const Char* first, const Char* last, format_spec<Char>& spec)
+    {
+        if (last - first >= 2 && *first != Char('}') && parse_format_align(first[1], spec.align))
+        {
+            spec.fill = *first;
+            first += 2;
+        }
+        else if (first != last && parse_format_align(*first, spec.align))
+        {
+            ++first;
+        }
+
+        if (first != last)
+        {
+            if (*first == Char('+'))
+            {
+                spec.sign = format_sign::plus;
+                ++first;
+            }
+            else if (*first == Char(' '))
+            {
+                spec.sign = format_sign::space;
+                ++first;
+            }
+            else if (*first == Char('-'))
+            {
+                ++first;
+            }
+        }
+
+        if (first != last && *first == Char('#'))
+        {
+            spec.alternate = true;
+            ++first;
+        }
+
+        if (first != last && *first == Char('0'))
+        {
+            spec.zero_pad = true;
+            ++first;
+        }
+
+        first = parse_format_number(first, last, spec.width);
+        if (first == nullptr)
+        {
+            return false;
+        }
+
+        if (first != last && *first == Char('.'))
+        {
+            ++first;
+
+            if (first == last || !is_format_digit(*first))
+            {
+                return false;
+            }
+
+            std::size_t precision;
+            first = parse_format_number(first, last, precision);
+            if (first == nullptr)
+            {
+                return false;
+            }
+
+            spec.precision = static_cast<int>(precision);
+        }
+
+        if (first != last)
+        {
+            static const char types[] = "bBcdoxXeEfFgGs";
+
+            for (auto type : types)
+            {
+                if (type != '\0' && *first == Char(type))
+                {
+                    spec.type = type;
+                    ++first;
+                    break;
+                }
+            }
+        }
+
+        return first == last;
+    }
+
+    /**
+     * @brief Parses the replacement field starting with the opening brace at first.
+     *
+     * @return a pointer past the closing brace or nullptr if [first, last) does not start with a
+     *         valid replacement field.
+     */
+    template <class Char, class Traits>
+    inline const Char* parse_format_field(const Char* first, const Char* last,
+                                          format_field<Char, Traits>& field)
+    {
+        auto it = first + 1;
+
+        if (it != last && is_format_digit(*it))
+        {
+            it = parse_format_number(it, last, field.index);
+            if (it == nullptr)
+            {
+                return nullptr;
+            }
+        }
+        else if (it != last && is_format_name_start(*it))
+        {
+            auto name_begin = it;
+            while (it != last && is_format_name_char(*it))
+            {
+                ++it;
+            }
+            field.name.assign(name_begin, it);
+        }
+
+        if (it == last)
+        {
+            return nullptr;
+        }
+
+        if (*it == Char('}'))
+        {
+            return it + 1;
+        }
+
+        if (*it != Char(':'))
+        {
+            return nullptr;
+        }
+
+        auto spec_begin = ++it;
+
+        // the fill character may be a '{', but never a '}'
+        while (it != last && *it != Char('}'))
+        {
+            ++it;
+        }
+
+        if (it == last || !parse_format_spec(spec_begin, it, field.spec))
+        {
+            return nullptr;
+        }
+
+        return it + 1;
+    }
+
+    /**
+     * @brief A format string, which was split into literal text and replacement fields.
+     *
+     * A brace which does not start a valid replacement field is kept as literal text, so
+     * "{ {}, {} }" has two fields.
+     */
+    template <class Char, class Traits = std::char_traits<Char>>
+    class compiled_format
+    {
+    public:
+        using string_type = std::basic_string<Char, Traits>;
+        using field_type = format_field<Char, Traits>;
+
+        static constexpr std::size_t no_field = std::numeric_limits<std::size_t>::max();
+
+        /**
+         * @brief Literal text [offset, offset + length) of the format string, followed by the
+         *        field with the given index into fields(), if there is one.
+         */
+        struct segment
+        {
+            std::size_t offset;
+            std::size_t length;
+            std::size_t field;
+        };
+
+        explicit compiled_format(string_type format) : format_(std::move(format))
+        {
+            const Char* begin = format_.data();
+            const Char* last = begin + format_.size();
+            const Char* literal = begin;
+            std::size_t next_index = 0;
+
+            for (const Char* it = begin; it != last; ++it)
+            {
+                if (*it != Char('{'))
+                {
+                    continue;
+                }
+
+                field_type field;
+                auto field_end = parse_format_field(it, last, field);
+
+                if (field_end == nullptr)
+                {
+                    continue;
+                }
+
+                field.offset = static_cast<std::size_t>(it - begin);
+                field.length = static_cast<std::size_t>(field_end - it);
+
+                if (field.index == field_type::named && field.name.empty())
+                {
+                    field.index = next_index++;
+                }
+
+                if (field.index != field_type::named)
+                {
+                    positional_ = std::max(positional_, field.index + 1);
+                }
+
+                segments_.push_back({ static_cast<std::size_t>(literal - begin),
+                                      static_cast<std::size_t>(it - literal), fields_.size() });
+                literal_size_ += static_cast<std::size_t>(it - literal);
+                fields_.emplace_back(std::move(field));
+
+                literal = field_end;
+                it = field_end - 1;
+            }
+
+            if (literal != last)
+            {
+                segments_.push_back({ static_cast<std::size_t>(literal - begin),
+                                      static_cast<std::size_t>(last - literal), no_field });
+                literal_size_ += static_cast<std::size_t>(last - literal);
+            }
+        }
+
+        const string_type& str() const
+        {
+            return format_;
+        }
+
+        const std::vector<segment>& segments() const
+        {
+            return segments_;
+        }
+
+        const std::vector<field_type>& fields() const
+        {
+            return fields_;
+        }
+
+        /**
+         * @brief The number of positional arguments referenced by the format string
+         */
+        std::size_t positional_arguments() const
+        {
+            return positional_;
+        }
+
+        /**
+         * @brief The total length of all literal text
+         */
+        std::size_t literal_size() const
+        {
+            return literal_size_;
+        }
+
+        const Char* literal(const segment& s) const
+        {
+            return format_.data() + s.offset;
+        }
+
+    private:
+        string_type format_;
+        std::vector<segment> segments_;
+        std::vector<field_type> fields_;
+        std::size_t positional_ = 0;
+        std::size_t literal_size_ = 0;
+    };
+} // namespace detail
+} // namespace nitro
+
+#endif // INCLUDE_NITRO_FORMAT_SPEC_HPP
@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_NITRO_FORMAT_TRAITS_HPP
+#define INCLUDE_NITRO_FORMAT_TRAITS_HPP
+
+#include <nitro/format/spec.hpp>
+#include <nitro/format/write.hpp>
+
+#include <nitro/lang/string_ref.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <ratio>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace nitro
+{
+
+template <class Char>
+using format_spec = detail::format_spec<Char>;
+
+namespace detail
+{
+    // base class of the formatter_traits, which fall back to operator<<
+    struct stream_formatter
+    {
+    };
+
+    template <typename T>
+    struct is_character
+    : std::integral_constant<
+          bool, std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                    std::is_same<T, unsigned char>::value || std::is_same<T, wchar_t>::value ||
+                    std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value>
+    {
+    };
+
+    template <typename T, typename = void>
+    struct has_ostream_operator : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct has_ostream_operator<
+        T, decltype(static_cast<void>(std::declval<std::ostream&>() << std::declval<const T&>()))>
+    : std::true_type
+    {
+    };
+
+    template <typename T>
+    struct is_string_like : std::is_same<T, lang::string_ref>
+    {
+    };
+
+    template <typename C, class CharTraits, class Allocator>
+    struct is_string_like<std::basic_string<C, CharTraits, Allocator>> : std::true_type
+    {
+    };
+
+#if __cplusplus >= 201703L
+    template <typename C, class CharTraits>
+    struct is_string_like<std::basic_string_view<C, CharTraits>> : std::true_type
+    {
+    };
+#endif
+
+    template <typename T, typename = void>
+    struct is_formatted_range : std::false_type
+    {
+    };
+
+    // Ranges with their own operator<< are left alone, so existing output doesn't change.
+    template <typename T>
+    struct is_formatted_range<T, decltype(static_cast<void>(std::begin(std::declval<const T&>())),
+                                          static_cast<void>(std::end(std::declval<const T&>())))>
+    : std::integral_constant<bool, !has_ostream_operator<T>::value && !is_string_like<T>::value>
+    {
+    };
+
+    template <class Char, class Traits, typename T>
+    inline void write_formatted(std::basic_string<Char, Traits>& out, const T& value,
+                                const format_spec<Char>& spec);
+
+    /**
+     * @brief Writes a value consisting of several parts, e.g., a number and a unit, and applies
+     *        the width and alignment of spec to the whole value.
+     */
+    template <class Char, class Traits, typename Writer>
+    inline void write_composite(std::basic_string<Char, Traits>& out,
+                                const format_spec<Char>& spec, Writer writer)
+    {
+        if (spec.width == 0)
+        {
+            writer(out, spec);
+            return;
+        }
+
+        auto inner = spec;
+        inner.width = 0;
+        inner.zero_pad = false;
+
+        std::basic_string<Char, Traits> buffer;
+        writer(buffer, inner);
+
+        inner = spec;
+        inner.precision = -1;
+        write_padded(out, buffer.data(), buffer.size(), inner, format_align::left);
+    }
+
+    template <class Char, class Traits, typename Tuple, std::size_t... I>
+    inline void write_tuple(std::basic_string<Char, Traits>& out, const Tuple& value,
+                            const format_spec<Char>& spec, std::index_sequence<I...>)
+    {
+        out.push_back(Char('('));
+
+        // expands to one write per element, preceded by a separator for all but the first
+        int expand[] = { 0, ((I == 0 ? void() : static_cast<void>(out.append({ Char(','),
+                                                                                Char(' ') }))),
+                             write_formatted(out, std::get<I>(value), spec), 0)... };
+        static_cast<void>(expand);
+
+        out.push_back(Char(')'));
+    }
+
+    template <typename Period>
+    inline const char* duration_suffix()
+    {
+        if (std::is_same<Period, std::nano>::value)
+            return "ns";
+        if (std::is_same<Period, std::micro>::value)
+            return "us";
+        if (std::is_same<Period, std::milli>::value)
+            return "ms";
+        if (std::is_same<Period, std::ratio<1>>::value)
+            return "s";
+        if (std::is_same<Period, std::ratio<60>>::value)
+            return "min";
+        if (std::is_same<Period, std::ratio<3600>>::value)
+            return "h";
+        if (std::is_same<Period, std::ratio<86400>>::value)
+            return "d";
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Converts days since 1970-01-01 to a date of the proleptic Gregorian calendar.
+     *
+     * See http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+     */
+    inline void civil_from_days(std::int64_t z, std::int64_t& year, unsigned& month, unsigned& day)
+    {
+        z += 719468;
+        const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const auto doe = static_cast<unsigned>(z - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2);
+    }
+
+    template <class Char, class Traits>
+    inline void write_digits(std::basic_string<Char, Traits>& out, unsigned long long value,
+                             std::size_t digits)
+    {
+        char buffer[20];
+        char* end = buffer + sizeof(buffer);
+        char* begin = format_decimal(end, value);
+
+        if (static_cast<std::size_t>(end - begin) < digits)
+        {
+            out.append(digits - static_cast<std::size_t>(end - begin), Char('0'));
+        }
+
+        out.append(begin, end);
+    }
+} // namespace detail
+
+/**
+ * @brief Customization point for writing values of type T with nitro::format() and the log
+ *        streams.
+ *
+ * A specialization has to provide
+ *
+ *     template <class Char, class Traits>
+ *     static void append(std::basic_string<Char, Traits>& out, const T& value,
+ *                        const nitro::format_spec<Char>& spec);
+ *
+ * which appends value to out as requested by spec. Without a specialization, values are written
+ * with operator<< and padded afterwards.
+ */
+template <typename T, typename Enable = void>
+struct formatter_traits : detail::stream_formatter
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const T& value,
+                       const format_spec<Char>& spec)
+    {
+        std::basic_ostringstream<Char, Traits> s;
+        s << value;
+        auto str = s.str();
+
+        auto size = str.size();
+        if (spec.precision >= 0 && size > static_cast<std::size_t>(spec.precision))
+        {
+            size = static_cast<std::size_t>(spec.precision);
+        }
+
+        detail::write_padded(out, str.data(), size, spec, detail::format_align::left);
+    }
+};
+
+/**
+ * @brief Whether there is a specialization of formatter_traits for T, i.e., whether T is written
+ *        without operator<<.
+ */
+template <typename T>
+struct has_formatter_traits
+: std::integral_constant<bool, !std::is_base_of<detail::stream_formatter,
+                                                formatter_traits<T>>::value>
+{
+};
+
+template <typename T>
+struct formatter_traits<
+    T, typename std::enable_if<std::is_integral<T>::value && !detail::is_character<T>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, T value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_integer(out, value, spec);
+    }
+};
+
+template <typename T>
+struct formatter_traits<T, typename std::enable_if<detail::is_character<T>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, T value,
+                       const format_spec<Char>& spec)
+    {
+        if (spec.type == '\0' || spec.type == 'c')
+        {
+            Char c = static_cast<Char>(value);
+            detail::write_padded(out, &c, 1, spec, detail::format_align::left);
+        }
+        else
+        {
+            detail::write_integer(out, value, spec);
+        }
+    }
+};
+
+template <typename T>
+struct formatter_traits<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, T value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_float(out, value, spec);
+    }
+};
+
+template <typename C>
+struct formatter_traits<const C*, typename std::enable_if<detail::is_character<C>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const C* value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_string(out, value,
+                             value == nullptr ? 0 : std::char_traits<C>::length(value), spec);
+    }
+};
+
+template <typename C>
+struct formatter_traits<C*, typename std::enable_if<detail::is_character<C>::value>::type>
+: formatter_traits<const C*>
+{
+};
+
+template <typename C, class CharTraits, class Allocator>
+struct formatter_traits<std::basic_string<C, CharTraits, Allocator>>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out,
+                       const std::basic_string<C, CharTraits, Allocator>& value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_string(out, value.data(), value.size(), spec);
+    }
+};
+
+#if __cplusplus >= 201703L
+template <typename C, class CharTraits>
+struct formatter_traits<std::basic_string_view<C, CharTraits>>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out,
+                       std::basic_string_view<C, CharTraits> value, const format_spec<Char>& spec)
+    {
+        detail::write_string(out, value.data(), value.size(), spec);
+    }
+};
+#endif
+
+template <>
+struct formatter_traits<lang::string_ref>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const lang::string_ref& value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_string(out, value.data(), value.size(), spec);
+    }
+};
+
+template <typename Rep, typename Period>
+struct formatter_traits<std::chrono::duration<Rep, Period>>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out,
+                       const std::chrono::duration<Rep, Period>& value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_composite(out, spec, [&value](auto& buffer, const auto& inner) {
+            detail::write_formatted(buffer, value.count(), inner);
+
+            if (auto suffix = detail::duration_suffix<typename Period::type>())
+            {
+                buffer.append(suffix, suffix + std::char_traits<char>::length(suffix));
+            }
+            else
+            {
+                buffer.push_back(Char('['));
+                detail::write_digits(buffer, Period::num, 1);
+                if (Period::den != 1)
+                {
+                    buffer.push_back(Char('/'));
+                    detail::write_digits(buffer, Period::den, 1);
+                }
+                buffer.push_back(Char(']'));
+                buffer.push_back(Char('s'));
+            }
+        });
+    }
+};
+
+/**
+ * Time points of the system clock are written as UTC date and time, e.g.,
+ * "2021-03-04 05:06:07.123456789", with as many fractional digits as the duration provides.
+ * Time points of other clocks are written as their time since epoch.
+ */
+template <typename Clock, typename Duration>
+struct formatter_traits<std::chrono::time_point<Clock, Duration>>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out,
+                       const std::chrono::time_point<Clock, Duration>& value,
+                       const format_spec<Char>& spec)
+    {
+        write(out, value, spec, std::is_same<Clock, std::chrono::system_clock>());
+    }
+
+private:
+    template <class Char, class Traits>
+    static void write(std::basic_string<Char, Traits>& out,
+                      const std::chrono::time_point<Clock, Duration>& value,
+                      const format_spec<Char>& spec, std::false_type)
+    {
+        formatter_traits<Duration>::append(out, value.time_since_epoch(), spec);
+    }
+
+    template <class Char, class Traits>
+    static void write(std::basic_string<Char, Traits>& out,
+                      const std::chrono::time_point<Clock, Duration>& value,
+                      const format_spec<Char>& spec, std::true_type)
+    {
+        using days = std::chrono::duration<std::int64_t, std::ratio<86400>>;
+        using fraction = std::chrono::duration<std::int64_t, typename Duration::period>;
+
+        auto since_epoch = std::chrono::duration_cast<fraction>(value.time_since_epoch());
+        auto day = std::chrono::duration_cast<days>(since_epoch);
+        if (day > since_epoch)
+        {
+            day -= days(1);
+        }
+        auto time_of_day = since_epoch - day;
+
+        std::int64_t year;
+        unsigned month, mday;
+        detail::civil_from_days(day.count(), year, month, mday);
+
+        detail::write_composite(out, spec, [&](auto& buffer, const auto&) {
+            if (year < 0)
+            {
+                buffer.push_back(Char('-'));
+            }
+            detail::write_digits(buffer, static_cast<unsigned long long>(year < 0 ? -year : year),
+                                 4);
+            buffer.push_back(Char('-'));
+            detail::write_digits(buffer, month, 2);
+            buffer.push_back(Char('-'));
+            detail::write_digits(buffer, mday, 2);
+            buffer.push_back(Char(' '));
+
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time_of_day);
+            detail::write_digits(buffer, static_cast<unsigned long long>(seconds.count() / 3600),
+                                 2);
+            buffer.push_back(Char(':'));
+            detail::write_digits(
+                buffer, static_cast<unsigned long long>(seconds.count() / 60 % 60), 2);
+            buffer.push_back(Char(':'));
+            detail::write_digits(buffer, static_cast<unsigned long long>(seconds.count() % 60),
+                                 2);
+
+            std::size_t digits = 0;
+            for (auto den = std::ratio_divide<std::ratio<1>, typename Duration::period>::num;
+                 den > 1; den /= 10)
+            {
+                ++digits;
+            }
+
+            if (digits > 0)
+            {
+                buffer.push_back(Char('.'));
+                detail::write_digits(
+                    buffer, static_cast<unsigned long long>((time_of_day - seconds).count()),
+                    digits);
+            }
+        });
+    }
+};
+
+/**
+ * Ranges without an operator<< are written as "[a, b, c]", where the spec applies to every
+ * element.
+ */
+template <typename T>
+struct formatter_traits<T, typename std::enable_if<detail::is_formatted_range<T>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const T& value,
+                       const format_spec<Char>& spec)
+    {
+        out.push_back(Char('['));
+
+        bool first = true;
+        for (const auto& element : value)
+        {
+            if (!first)
+            {
+                out.push_back(Char(','));
+                out.push_back(Char(' '));
+            }
+            first = false;
+
+            detail::write_formatted(out, element, spec);
+        }
+
+        out.push_back(Char(']'));
+    }
+};
+
+/**
+ * Tuples and pairs are written as "(a, b, c)", where the spec applies to every element.
+ */
+template <typename... Ts>
+struct formatter_traits<
+    std::tuple<Ts...>,
+    typename std::enable_if<!detail::has_ostream_operator<std::tuple<Ts...>>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const std::tuple<Ts...>& value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_tuple(out, value, spec, std::index_sequence_for<Ts...>());
+    }
+};
+
+template <typename T, typename U>
+struct formatter_traits<
+    std::pair<T, U>,
+    typename std::enable_if<!detail::has_ostream_operator<std::pair<T, U>>::value>::type>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const std::pair<T, U>& value,
+                       const format_spec<Char>& spec)
+    {
+        detail::write_tuple(out, value, spec, std::index_sequence<0, 1>());
+    }
+};
+
+namespace detail
+{
+    /**
+     * @brief Appends value to out as requested by spec, using formatter_traits.
+     */
+    template <class Char, class Traits, typename T>
+    inline void write_formatted(std::basic_string<Char, Traits>& out, const T& value,
+                                const format_spec<Char>& spec)
+    {
+        formatter_traits<typename std::decay<T>::type>::append(out, value, spec);
+    }
+} // namespace detail
+} // namespace nitro
+
+#endif // INCLUDE_NITRO_FORMAT_TRAITS_HPP
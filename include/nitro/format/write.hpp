@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef INCLUDE_NITRO_FORMAT_WRITE_HPP
+#define INCLUDE_NITRO_FORMAT_WRITE_HPP
+
+#include <nitro/format/dtoa.hpp>
+#include <nitro/format/spec.hpp>
+
+#include <nitro/except/raise.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace nitro
+{
+
+namespace detail
+{
+    /**
+     * @brief Appends size characters from data to out, surrounded by the fill character as
+     *        requested by the width and alignment of spec.
+     *
+     * Source may be char, in which case the characters are widened to Char.
+     */
+    template <class Char, class Traits, class Source>
+    inline void write_padded(std::basic_string<Char, Traits>& out, const Source* data,
+                             std::size_t size, const format_spec<Char>& spec,
+                             format_align default_align)
+    {
+        std::size_t padding = spec.width > size ? spec.width - size : 0;
+        std::size_t left = 0;
+
+        switch (spec.align == format_align::none ? default_align : spec.align)
+        {
+        case format_align::right:
+            left = padding;
+            break;
+        case format_align::center:
+            left = padding / 2;
+            break;
+        default:
+            break;
+        }
+
+        out.append(left, spec.fill);
+        out.append(data, data + size);
+        out.append(padding - left, spec.fill);
+    }
+
+    /**
+     * @brief Appends a number, which is given as its sign and base prefix followed by its digits.
+     *
+     * With the '0' flag and without an explicit alignment, zeros are inserted between the prefix
+     * and the digits.
+     */
+    template <class Char, class Traits>
+    inline void write_number(std::basic_string<Char, Traits>& out, const char* data,
+                             std::size_t prefix_size, std::size_t size,
+                             const format_spec<Char>& spec)
+    {
+        if (spec.zero_pad && spec.align == format_align::none)
+        {
+            out.append(data, data + prefix_size);
+
+            if (spec.width > size)
+            {
+                out.append(spec.width - size, Char('0'));
+            }
+
+            out.append(data + prefix_size, data + size);
+            return;
+        }
+
+        write_padded(out, data, size, spec, format_align::right);
+    }
+
+    /**
+     * @brief Writes the decimal digits of value backwards, ending in end.
+     *
+     * @return pointer to the first digit
+     */
+    inline char* format_decimal(char* end, unsigned long long value)
+    {
+        static const char digits[] = "0001020304050607080910111213141516171819"
+                                     "2021222324252627282930313233343536373839"
+                                     "4041424344454647484950515253545556575859"
+                                     "6061626364656667686970717273747576777879"
+                                     "8081828384858687888990919293949596979899";
+
+        while (value >= 100)
+        {
+            auto i = static_cast<std::size_t>(value % 100) * 2;
+            value /= 100;
+            *--end = digits[i + 1];
+            *--end = digits[i];
+        }
+
+        if (value < 10)
+        {
+            *--end = static_cast<char>('0' + value);
+        }
+        else
+        {
+            auto i = static_cast<std::size_t>(value) * 2;
+            *--end = digits[i + 1];
+            *--end = digits[i];
+        }
+
+        return end;
+    }
+
+    /**
+     * @brief Writes the digits of value in base 2^shift backwards, ending in end.
+     *
+     * @return pointer to the first digit
+     */
+    inline char* format_radix(char* end, unsigned long long value, unsigned shift, bool upper)
+    {
+        const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        const unsigned long long mask = (1ull << shift) - 1;
+
+        do
+        {
+            *--end = digits[value & mask];
+            value >>= shift;
+        } while (value != 0);
+
+        return end;
+    }
+
+    template <typename Int>
+    inline typename std::enable_if<std::is_signed<Int>::value, bool>::type
+    is_format_negative(Int value)
+    {
+        return value < 0;
+    }
+
+    template <typename Int>
+    inline typename std::enable_if<!std::is_signed<Int>::value, bool>::type
+    is_format_negative(Int)
+    {
+        return false;
+    }
+
+    template <class Char, class Traits, typename Int>
+    inline void write_integer(std::basic_string<Char, Traits>& out, Int value,
+                              const format_spec<Char>& spec)
+    {
+        if (spec.type == 'c')
+        {
+            Char c = static_cast<Char>(value);
+            write_padded(out, &c, 1, spec, format_align::left);
+            return;
+        }
+
+        bool negative = is_format_negative(value);
+        auto abs = static_cast<unsigned long long>(value);
+        if (negative)
+        {
+            abs = 0ull - abs;
+        }
+
+        // enough for 64 binary digits, a sign and a base prefix
+        char buffer[sizeof(unsigned long long) * 8 + 3];
+        char* end = buffer + sizeof(buffer);
+        char* begin;
+
+        switch (spec.type)
+        {
+        case '\0':
+        case 'd':
+            begin = format_decimal(end, abs);
+            break;
+        case 'x':
+        case 'X':
+            begin = format_radix(end, abs, 4, spec.type == 'X');
+            break;
+        case 'b':
+        case 'B':
+            begin = format_radix(end, abs, 1, false);
+            break;
+        case 'o':
+            begin = format_radix(end, abs, 3, false);
+            break;
+        default:
+            raise("Invalid format type '", spec.type, "' for an integer argument");
+        }
+
+        const char* digits = begin;
+
+        if (spec.alternate && spec.type != '\0' && spec.type != 'd')
+        {
+            if (spec.type != 'o')
+            {
+                *--begin = spec.type;
+                *--begin = '0';
+            }
+            else if (abs != 0)
+            {
+                *--begin = '0';
+            }
+        }
+
+        if (negative)
+        {
+            *--begin = '-';
+        }
+        else if (spec.sign == format_sign::plus)
+        {
+            *--begin = '+';
+        }
+        else if (spec.sign == format_sign::space)
+        {
+            *--begin = ' ';
+        }
+
+        auto prefix_size = static_cast<std::size_t>(digits - begin);
+
+        write_number(out, begin, prefix_size, static_cast<std::size_t>(end - begin), spec);
+    }
+
+    template <class Char, class Traits, typename Float>
+    inline void write_float(std::basic_string<Char, Traits>& out, Float value,
+                            const format_spec<Char>& spec);
+
+    template <class Char, class Traits, typename Float>
+    inline void write_shortest_float(std::basic_string<Char, Traits>& out, Float value,
+                                     const format_spec<Char>& spec)
+    {
+        char buffer[32];
+        char* begin = buffer + 1;
+        char* end = dtoa::to_chars(begin, value);
+
+        if (*begin != '-' && spec.sign != format_sign::minus)
+        {
+            *--begin = spec.sign == format_sign::plus ? '+' : ' ';
+        }
+
+        std::size_t prefix_size = (*begin == '-' || *begin == '+' || *begin == ' ') ? 1 : 0;
+        write_number(out, begin, prefix_size, static_cast<std::size_t>(end - begin), spec);
+    }
+
+    /**
+     * @brief Whether values of type Float are written with the shortest digits, which parse back
+     *        to the same value, if no precision is given.
+     *
+     * This is the case for IEEE 754 single and double precision values. Other types are written
+     * with max_digits10 significant digits instead, which round-trips as well.
+     */
+    template <typename Float>
+    struct has_shortest_float
+    : std::integral_constant<bool, std::numeric_limits<Float>::is_iec559 &&
+                                       (sizeof(Float) == sizeof(float) ||
+                                        sizeof(Float) == sizeof(double))>
+    {
+    };
+
+    template <class Char, class Traits, typename Float>
+    inline void write_shortest_float(std::basic_string<Char, Traits>& out, Float value,
+                                     const format_spec<Char>& spec, std::true_type)
+    {
+        using shortest_type =
+            typename std::conditional<sizeof(Float) == sizeof(float), float, double>::type;
+
+        write_shortest_float(out, static_cast<shortest_type>(value), spec);
+    }
+
+    template <class Char, class Traits, typename Float>
+    inline void write_shortest_float(std::basic_string<Char, Traits>& out, Float value,
+                                     const format_spec<Char>& spec, std::false_type)
+    {
+        auto precise = spec;
+        precise.type = 'g';
+        precise.precision = std::numeric_limits<Float>::max_digits10;
+
+        write_float(out, value, precise);
+    }
+
+    inline void check_float_type(char type)
+    {
+        switch (type)
+        {
+        case '\0':
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+            return;
+        default:
+            raise("Invalid format type '", type, "' for a floating point argument");
+        }
+    }
+
+    // Writes float and double exactly rounded without printf, so the locale never applies.
+    template <class Char, class Traits, typename Float>
+    inline void write_precise_float(std::basic_string<Char, Traits>& out, Float value,
+                                    const format_spec<Char>& spec, std::true_type)
+    {
+        check_float_type(spec.type);
+
+        const bool upper = spec.type == 'E' || spec.type == 'F' || spec.type == 'G';
+        const int precision = spec.precision >= 0 ? spec.precision : 6;
+
+        char stack[512];
+        std::vector<char> heap;
+        char* buffer = stack;
+
+        if (dtoa::max_chars(precision) > sizeof(stack))
+        {
+            heap.resize(dtoa::max_chars(precision));
+            buffer = heap.data();
+        }
+
+        char* begin = buffer + 1;
+        char* end;
+
+        const auto abs = std::fabs(static_cast<double>(value));
+
+        if (std::isnan(value))
+        {
+            end = std::copy_n(upper ? "NAN" : "nan", 3, begin);
+        }
+        else if (std::isinf(value))
+        {
+            end = std::copy_n(upper ? "INF" : "inf", 3, begin);
+        }
+        else if (spec.type == 'f' || spec.type == 'F')
+        {
+            end = dtoa::to_chars_fixed(begin, abs, precision, spec.alternate);
+        }
+        else if (spec.type == 'e' || spec.type == 'E')
+        {
+            end = dtoa::to_chars_exponent(begin, abs, precision, upper, spec.alternate);
+        }
+        else
+        {
+            end = dtoa::to_chars_general(begin, abs, precision, upper, spec.alternate);
+        }
+
+        if (std::signbit(value))
+        {
+            *--begin = '-';
+        }
+        else if (spec.sign == format_sign::plus)
+        {
+            *--begin = '+';
+        }
+        else if (spec.sign == format_sign::space)
+        {
+            *--begin = ' ';
+        }
+
+        if (!std::isfinite(value))
+        {
+            auto padded = spec;
+            padded.zero_pad = false;
+            write_padded(out, begin, static_cast<std::size_t>(end - begin), padded,
+                         format_align::right);
+            return;
+        }
+
+        std::size_t prefix_size = begin != buffer + 1 ? 1 : 0;
+        write_number(out, begin, prefix_size, static_cast<std::size_t>(end - begin), spec);
+    }
+
+    // Fallback for long double, which has no exact conversion of its own
+    template <class Char, class Traits, typename Float>
+    inline void write_precise_float(std::basic_string<Char, Traits>& out, Float value,
+                                    const format_spec<Char>& spec, std::false_type)
+    {
+        char format[12];
+        char* f = format;
+
+        *f++ = '%';
+
+        if (spec.sign == format_sign::plus)
+        {
+            *f++ = '+';
+        }
+        else if (spec.sign == format_sign::space)
+        {
+            *f++ = ' ';
+        }
+
+        if (spec.alternate)
+        {
+            *f++ = '#';
+        }
+
+        *f++ = '.';
+        *f++ = '*';
+
+        if (std::is_same<Float, long double>::value)
+        {
+            *f++ = 'L';
+        }
+
+        check_float_type(spec.type);
+        *f++ = spec.type == '\0' ? 'g' : spec.type;
+
+        *f = '\0';
+
+        int precision = spec.precision >= 0 ? spec.precision : 6;
+
+        char buffer[64];
+        auto size = std::snprintf(buffer, sizeof(buffer), format, precision, value);
+        const char* data = buffer;
+
+        std::vector<char> large;
+        if (size >= static_cast<int>(sizeof(buffer)))
+        {
+            large.resize(static_cast<std::size_t>(size) + 1);
+            std::snprintf(large.data(), large.size(), format, precision, value);
+            data = large.data();
+        }
+
+        if (!std::isfinite(value))
+        {
+            auto padded = spec;
+            padded.zero_pad = false;
+            write_padded(out, data, static_cast<std::size_t>(size), padded, format_align::right);
+            return;
+        }
+
+        std::size_t prefix_size = (data[0] == '-' || data[0] == '+' || data[0] == ' ') ? 1 : 0;
+        write_number(out, data, prefix_size, static_cast<std::size_t>(size), spec);
+    }
+
+    template <class Char, class Traits, typename Float>
+    inline void write_float(std::basic_string<Char, Traits>& out, Float value,
+                            const format_spec<Char>& spec)
+    {
+        if (spec.type == '\0' && spec.precision < 0 && std::isfinite(value))
+        {
+            write_shortest_float(out, value, spec, has_shortest_float<Float>());
+            return;
+        }
+
+        write_precise_float(out, value, spec, has_shortest_float<Float>());
+    }
+
+    template <class Char, class Traits, class Source>
+    inline void write_string(std::basic_string<Char, Traits>& out, const Source* data,
+                             std::size_t size, const format_spec<Char>& spec)
+    {
+        if (spec.type != '\0' && spec.type != 's')
+        {
+            raise("Invalid format type '", spec.type, "' for a string argument");
+        }
+
+        if (spec.precision >= 0 && size > static_cast<std::size_t>(spec.precision))
+        {
+            size = static_cast<std::size_t>(spec.precision);
+        }
+
+        write_padded(out, data, size, spec, format_align::left);
+    }
+} // namespace detail
+} // namespace nitro
+
+#endif // INCLUDE_NITRO_FORMAT_WRITE_HPP
@@ -0,0 +1,554 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        struct arena_chunk
+        {
+            arena_chunk* next;
+            std::size_t size;
+            bool huge_pages;
+
+            static constexpr std::size_t header_size =
+                (sizeof(arena_chunk*) + sizeof(std::size_t) + sizeof(bool) +
+                 alignof(std::max_align_t) - 1) /
+                alignof(std::max_align_t) * alignof(std::max_align_t);
+
+            char* begin() noexcept
+            {
+                return reinterpret_cast<char*>(this) + header_size;
+            }
+
+            char* end() noexcept
+            {
+                return reinterpret_cast<char*>(this) + size;
+            }
+
+            std::size_t capacity() const noexcept
+            {
+                return size - header_size;
+            }
+        };
+
+        constexpr std::size_t arena_huge_page_size = 2 * 1024 * 1024;
+
+        inline arena_chunk* allocate_arena_chunk(std::size_t size, bool huge_pages)
+        {
+            void* memory = nullptr;
+
+#ifdef __linux__
+            if (huge_pages)
+            {
+                size = (size + arena_huge_page_size - 1) / arena_huge_page_size *
+                       arena_huge_page_size;
+
+                memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (memory == MAP_FAILED)
+                {
+                    memory = nullptr;
+                }
+#ifdef MADV_HUGEPAGE
+                else
+                {
+                    // only a hint, without transparent huge pages, we still get normal pages
+                    ::madvise(memory, size, MADV_HUGEPAGE);
+                }
+#endif
+            }
+#endif
+
+            if (memory == nullptr)
+            {
+                huge_pages = false;
+                memory = std::malloc(size);
+
+                if (memory == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+            }
+
+            return ::new (memory) arena_chunk{ nullptr, size, huge_pages };
+        }
+
+        inline void free_arena_chunk(arena_chunk* chunk) noexcept
+        {
+#ifdef __linux__
+            if (chunk->huge_pages)
+            {
+                ::munmap(chunk, chunk->size);
+                return;
+            }
+#endif
+            std::free(chunk);
+        }
+
+        /**
+         * \brief Keeps a few released chunks per thread, so arenas which are created and
+         * destroyed in a loop don't go to malloc for every chunk
+         */
+        class arena_chunk_cache
+        {
+        public:
+            static constexpr std::size_t max_chunks = 8;
+
+            ~arena_chunk_cache()
+            {
+                for (std::size_t i = 0; i < count_; i++)
+                {
+                    free_arena_chunk(chunks_[i]);
+                }
+
+                destroyed() = true;
+            }
+
+            /// returns nullptr, if the cache of this thread is already destroyed
+            static arena_chunk_cache* local() noexcept
+            {
+                if (destroyed())
+                {
+                    return nullptr;
+                }
+
+                thread_local arena_chunk_cache cache;
+                return &cache;
+            }
+
+            arena_chunk* get(std::size_t size, bool huge_pages) noexcept
+            {
+                for (std::size_t i = count_; i-- > 0;)
+                {
+                    auto chunk = chunks_[i];
+
+                    if (chunk->huge_pages == huge_pages && chunk->size >= size &&
+                        chunk->size / 2 < size)
+                    {
+                        chunks_[i] = chunks_[--count_];
+                        return chunk;
+                    }
+                }
+
+                return nullptr;
+            }
+
+            bool put(arena_chunk* chunk) noexcept
+            {
+                if (count_ == max_chunks)
+                {
+                    return false;
+                }
+
+                chunks_[count_++] = chunk;
+                return true;
+            }
+
+        private:
+            static bool& destroyed() noexcept
+            {
+                thread_local bool destroyed = false;
+                return destroyed;
+            }
+
+            arena_chunk* chunks_[max_chunks];
+            std::size_t count_ = 0;
+        };
+    } // namespace detail
+
+    struct arena_stats
+    {
+        /// bytes handed out since the last reset(), including alignment padding
+        std::size_t bytes_used;
+        /// bytes in all chunks owned by the arena
+        std::size_t bytes_reserved;
+        /// number of chunks owned by the arena
+        std::size_t chunks;
+        /// number of chunks the arena obtained over its lifetime
+        std::size_t chunks_allocated;
+    };
+
+    /**
+     * \brief A monotonic bump-pointer allocator
+     *
+     * Memory is handed out from chunks of chunk_size bytes, larger requests get a chunk of their
+     * own. Memory is only reclaimed all at once, with reset() or by rewinding to a mark. Both are
+     * O(1) and keep the chunks for reuse, release() gives them back to a per-thread cache.
+     *
+     * An arena is not thread-safe. Destructors of objects in an arena are never called.
+     */
+    class arena
+    {
+    public:
+        static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+        class mark
+        {
+            friend class arena;
+
+            detail::arena_chunk* chunk_ = nullptr;
+            char* position_ = nullptr;
+            std::size_t bytes_used_ = 0;
+        };
+
+        explicit arena(std::size_t chunk_size = default_chunk_size, bool huge_pages = false)
+        : chunk_size_(std::max(chunk_size, 2 * detail::arena_chunk::header_size)),
+          huge_pages_(huge_pages)
+        {
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        arena(arena&& other) noexcept
+        {
+            swap(other);
+        }
+
+        arena& operator=(arena&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                swap(other);
+            }
+
+            return *this;
+        }
+
+        ~arena()
+        {
+            release();
+        }
+
+        void swap(arena& other) noexcept
+        {
+            std::swap(chunk_size_, other.chunk_size_);
+            std::swap(huge_pages_, other.huge_pages_);
+            std::swap(head_, other.head_);
+            std::swap(current_, other.current_);
+            std::swap(position_, other.position_);
+            std::swap(end_, other.end_);
+            std::swap(bytes_used_, other.bytes_used_);
+            std::swap(bytes_reserved_, other.bytes_reserved_);
+            std::swap(chunks_, other.chunks_);
+            std::swap(chunks_allocated_, other.chunks_allocated_);
+        }
+
+        /// alignment must be a power of two
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+        {
+            auto position = reinterpret_cast<std::uintptr_t>(position_);
+            auto aligned = (position + alignment - 1) & ~(alignment - 1);
+            auto end = reinterpret_cast<std::uintptr_t>(end_);
+
+            if (aligned <= end && size <= end - aligned)
+            {
+                bytes_used_ += aligned + size - position;
+                position_ = reinterpret_cast<char*>(aligned + size);
+
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            return allocate_slow(size, alignment);
+        }
+
+        template <typename T>
+        T* allocate(std::size_t n = 1)
+        {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+
+            return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        }
+
+        template <typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "Objects in an arena are never destroyed");
+
+            return ::new (allocate<T>()) T(std::forward<Args>(args)...);
+        }
+
+        /// only reclaims the memory, if ptr was the last allocation
+        void deallocate(void* ptr, std::size_t size) noexcept
+        {
+            if (static_cast<char*>(ptr) + size == position_)
+            {
+                position_ = static_cast<char*>(ptr);
+                bytes_used_ -= size;
+            }
+        }
+
+        mark save() const noexcept
+        {
+            mark m;
+            m.chunk_ = current_;
+            m.position_ = position_;
+            m.bytes_used_ = bytes_used_;
+
+            return m;
+        }
+
+        /// frees everything allocated after m was saved
+        void rewind(const mark& m) noexcept
+        {
+            current_ = m.chunk_;
+            position_ = m.position_;
+            end_ = current_ == nullptr ? nullptr : current_->end();
+            bytes_used_ = m.bytes_used_;
+        }
+
+        /// frees everything, but keeps the chunks for reuse
+        void reset() noexcept
+        {
+            rewind(mark());
+        }
+
+        /// frees everything and gives the chunks back
+        void release() noexcept
+        {
+            auto cache = detail::arena_chunk_cache::local();
+
+            while (head_ != nullptr)
+            {
+                auto chunk = head_;
+                head_ = chunk->next;
+
+                if (cache == nullptr || !cache->put(chunk))
+                {
+                    detail::free_arena_chunk(chunk);
+                }
+            }
+
+            reset();
+            bytes_reserved_ = 0;
+            chunks_ = 0;
+        }
+
+        arena_stats stats() const noexcept
+        {
+            return { bytes_used_, bytes_reserved_, chunks_, chunks_allocated_ };
+        }
+
+        std::size_t chunk_size() const noexcept
+        {
+            return chunk_size_;
+        }
+
+    private:
+        void* allocate_slow(std::size_t size, std::size_t alignment)
+        {
+            if (size > std::numeric_limits<std::size_t>::max() / 2 - alignment)
+            {
+                throw std::bad_alloc();
+            }
+
+            // worst case, we need alignment - 1 bytes of padding
+            auto needed = size + alignment - 1;
+
+            // after a rewind, the following chunks are still there to be reused
+            auto next = current_ == nullptr ? head_ : current_->next;
+
+            if (next == nullptr || next->capacity() < needed)
+            {
+                auto chunk = obtain_chunk(
+                    std::max(chunk_size_, needed + detail::arena_chunk::header_size));
+
+                if (current_ == nullptr)
+                {
+                    chunk->next = head_;
+                    head_ = chunk;
+                }
+                else
+                {
+                    chunk->next = current_->next;
+                    current_->next = chunk;
+                }
+
+                next = chunk;
+            }
+
+            current_ = next;
+            position_ = next->begin();
+            end_ = next->end();
+
+            return allocate(size, alignment);
+        }
+
+        detail::arena_chunk* obtain_chunk(std::size_t size)
+        {
+            detail::arena_chunk* chunk = nullptr;
+
+            if (auto cache = detail::arena_chunk_cache::local())
+            {
+                chunk = cache->get(size, huge_pages_);
+            }
+
+            if (chunk == nullptr)
+            {
+                chunk = detail::allocate_arena_chunk(size, huge_pages_);
+            }
+
+            bytes_reserved_ += chunk->size;
+            ++chunks_;
+            ++chunks_allocated_;
+
+            return chunk;
+        }
+
+        std::size_t chunk_size_ = default_chunk_size;
+        bool huge_pages_ = false;
+
+        detail::arena_chunk* head_ = nullptr;
+        detail::arena_chunk* current_ = nullptr;
+        char* position_ = nullptr;
+        char* end_ = nullptr;
+
+        std::size_t bytes_used_ = 0;
+        std::size_t bytes_reserved_ = 0;
+        std::size_t chunks_ = 0;
+        std::size_t chunks_allocated_ = 0;
+    };
+
+    /**
+     * \brief An allocator for standard containers, which allocates from an arena
+     */
+    template <typename T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+
+        arena_allocator(arena& a) noexcept : arena_(&a)
+        {
+        }
+
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& other) noexcept : arena_(&other.get_arena())
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return arena_->allocate<T>(n);
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept
+        {
+            arena_->deallocate(ptr, n * sizeof(T));
+        }
+
+        arena& get_arena() const noexcept
+        {
+            return *arena_;
+        }
+
+        template <typename U>
+        bool operator==(const arena_allocator<U>& other) const noexcept
+        {
+            return arena_ == &other.get_arena();
+        }
+
+        template <typename U>
+        bool operator!=(const arena_allocator<U>& other) const noexcept
+        {
+            return arena_ != &other.get_arena();
+        }
+
+    private:
+        arena* arena_;
+    };
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+    /**
+     * \brief A std::pmr::memory_resource, which allocates from an arena
+     */
+    class arena_resource : public std::pmr::memory_resource
+    {
+    public:
+        explicit arena_resource(arena& a) noexcept : arena_(a)
+        {
+        }
+
+        arena& get_arena() const noexcept
+        {
+            return arena_;
+        }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return arena_.allocate(std::max<std::size_t>(bytes, 1), alignment);
+        }
+
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t) override
+        {
+            arena_.deallocate(ptr, std::max<std::size_t>(bytes, 1));
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        arena& arena_;
+    };
+#endif
+#endif
+} // namespace lang
+} // namespace nitro
@@ -0,0 +1,910 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+#include <nitro/lang/optional.hpp>
+#include <nitro/lang/span.hpp>
+#include <nitro/lang/string_ref.hpp>
+#include <nitro/lang/tuple_foreach.hpp>
+#include <nitro/lang/tuple_operators.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <optional>
+#include <string_view>
+#include <variant>
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief How binary_archive encodes integers and lengths
+     *
+     * fixed copies the native representation. varint uses LEB128, with zigzag encoding for signed
+     * integers, which is smaller for typical values but costs a loop per integer. Contiguous runs
+     * of trivially copyable elements, e.g., a std::vector<int>, are always copied verbatim.
+     */
+    enum class binary_encoding
+    {
+        fixed,
+        varint
+    };
+
+    namespace detail
+    {
+        template <typename T, typename = void>
+        struct archive_has_as_tuple : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct archive_has_as_tuple<T, decltype(void(std::declval<T&>().as_tuple()))>
+        : std::true_type
+        {
+        };
+
+        template <typename T, typename = void>
+        struct archive_is_range : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct archive_is_range<T, decltype(void(std::begin(std::declval<T&>())),
+                                            void(std::end(std::declval<T&>())))> : std::true_type
+        {
+        };
+
+        template <typename T, typename = void>
+        struct archive_element
+        {
+            using type = typename T::value_type;
+        };
+
+        // reads map entries with a mutable key
+        template <typename T>
+        struct archive_element<T, decltype(void(std::declval<typename T::mapped_type>()))>
+        {
+            using type = std::pair<typename T::key_type, typename T::mapped_type>;
+        };
+
+        /// addresses are meaningless in another process, so pointers are never written
+        template <typename T>
+        using archive_is_pointer =
+            std::integral_constant<bool, std::is_pointer<T>::value ||
+                                             std::is_member_pointer<T>::value ||
+                                             std::is_same<T, std::nullptr_t>::value>;
+
+        /// element runs of these types are copied with a single memcpy
+        template <typename T>
+        using archive_is_bulk =
+            std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                             !std::is_same<T, bool>::value &&
+                                             !archive_is_pointer<T>::value &&
+                                             !archive_has_as_tuple<T>::value>;
+
+        struct archive_bool_tag
+        {
+        };
+
+        struct archive_integer_tag
+        {
+        };
+
+        struct archive_object_tag
+        {
+        };
+
+        struct archive_bytes_tag
+        {
+        };
+
+        struct archive_range_tag
+        {
+        };
+
+        struct archive_unsupported_tag
+        {
+        };
+
+        template <typename T>
+        using archive_tag = std::conditional_t<
+            archive_is_pointer<T>::value, archive_unsupported_tag,
+            std::conditional_t<
+                std::is_same<T, bool>::value, archive_bool_tag,
+                std::conditional_t<
+                    (std::is_integral<T>::value || std::is_enum<T>::value), archive_integer_tag,
+                    std::conditional_t<
+                        archive_has_as_tuple<T>::value, archive_object_tag,
+                        std::conditional_t<
+                            std::is_trivially_copyable<T>::value, archive_bytes_tag,
+                            std::conditional_t<archive_is_range<T>::value, archive_range_tag,
+                                               archive_unsupported_tag>>>>>>;
+
+        template <typename T>
+        using archive_integer_t =
+            typename std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>,
+                                        std::common_type<T>>::type;
+
+        inline std::uint64_t zigzag_encode(std::int64_t value)
+        {
+            return value < 0 ? ~(static_cast<std::uint64_t>(value) << 1)
+                             : static_cast<std::uint64_t>(value) << 1;
+        }
+
+        inline std::int64_t zigzag_decode(std::uint64_t value)
+        {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+    } // namespace detail
+
+    /**
+     * \brief Serializes values into a contiguous buffer
+     *
+     * Supports arithmetic types and enums, types with an as_tuple(), see tuple_operators, strings,
+     * std::pair and std::tuple, lang::optional, std::array, std::vector and other standard
+     * containers, and since C++17 std::optional and std::variant. Other trivially copyable types
+     * are copied verbatim. Pointers, including C strings, don't compile, as their addresses are
+     * meaningless once read back; write a string_ref instead. Like a Boost archive, `ar & value`
+     * works, so tuple_operators::serialize can write into it as well.
+     *
+     * The format uses the native byte order and is meant to be read back by binary_reader on the
+     * same kind of machine, e.g., for snapshots and checkpoints.
+     */
+    class binary_archive
+    {
+    public:
+        explicit binary_archive(binary_encoding encoding = binary_encoding::fixed)
+        : encoding_(encoding)
+        {
+        }
+
+        binary_encoding encoding() const noexcept
+        {
+            return encoding_;
+        }
+
+        template <typename T>
+        binary_archive& operator&(const T& value)
+        {
+            write(value);
+            return *this;
+        }
+
+        template <typename T>
+        binary_archive& operator<<(const T& value)
+        {
+            write(value);
+            return *this;
+        }
+
+        template <typename T>
+        void write(const T& value)
+        {
+            write(value, detail::archive_tag<T>());
+        }
+
+        template <typename Char, typename Traits, typename Allocator>
+        void write(const std::basic_string<Char, Traits, Allocator>& value)
+        {
+            write_run(value.data(), value.size());
+        }
+
+        void write(const string_ref& value)
+        {
+            write_run(value.data(), value.size());
+        }
+
+#if __cplusplus >= 201703L
+        template <typename Char, typename Traits>
+        void write(std::basic_string_view<Char, Traits> value)
+        {
+            write_run(value.data(), value.size());
+        }
+
+        template <typename T>
+        void write(const std::optional<T>& value)
+        {
+            write(value.has_value());
+
+            if (value)
+            {
+                write(*value);
+            }
+        }
+
+        template <typename... T>
+        void write(const std::variant<T...>& value)
+        {
+            if (value.valueless_by_exception())
+                raise("Cannot serialize a valueless variant");
+
+            write_size(value.index());
+            std::visit([this](const auto& alternative) { write(alternative); }, value);
+        }
+#endif
+
+        template <typename T>
+        void write(const span<T>& value)
+        {
+            write_run(value.data(), value.size());
+        }
+
+        template <typename T, typename Allocator>
+        void write(const std::vector<T, Allocator>& value)
+        {
+            write_run(value.data(), value.size());
+        }
+
+        template <typename Allocator>
+        void write(const std::vector<bool, Allocator>& value)
+        {
+            write_size(value.size());
+
+            // the elements are proxies, so convert them first
+            for (bool element : value)
+            {
+                write(element);
+            }
+        }
+
+        template <typename T, std::size_t N>
+        void write(const std::array<T, N>& value)
+        {
+            write_elements(value.data(), N, detail::archive_is_bulk<T>());
+        }
+
+        template <typename T, typename U>
+        void write(const std::pair<T, U>& value)
+        {
+            write(value.first);
+            write(value.second);
+        }
+
+        template <typename... T>
+        void write(const std::tuple<T...>& value)
+        {
+            write_tuple(value, std::index_sequence_for<T...>());
+        }
+
+        template <typename T>
+        void write(const optional<T>& value)
+        {
+            write(value.has_value());
+
+            if (value)
+            {
+                write(*value);
+            }
+        }
+
+        /// appends size raw bytes
+        void write_bytes(const void* data, std::size_t size)
+        {
+            auto bytes = static_cast<const char*>(data);
+            buffer_.insert(buffer_.end(), bytes, bytes + size);
+        }
+
+        void write_size(std::size_t size)
+        {
+            write_unsigned(size);
+        }
+
+        const char* data() const noexcept
+        {
+            return buffer_.data();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return buffer_.size();
+        }
+
+        span<const char> bytes() const noexcept
+        {
+            return span<const char>(buffer_.data(), buffer_.size());
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            buffer_.reserve(capacity);
+        }
+
+        void clear() noexcept
+        {
+            buffer_.clear();
+        }
+
+    private:
+        template <typename T>
+        void write(const T& value, detail::archive_bool_tag)
+        {
+            char byte = value ? 1 : 0;
+            write_bytes(&byte, 1);
+        }
+
+        template <typename T>
+        void write(const T& value, detail::archive_integer_tag)
+        {
+            using integer = detail::archive_integer_t<T>;
+            auto number = static_cast<integer>(value);
+
+            if (encoding_ == binary_encoding::fixed)
+            {
+                write_bytes(&number, sizeof(number));
+            }
+            else if (std::is_signed<integer>::value)
+            {
+                write_varint(detail::zigzag_encode(static_cast<std::int64_t>(number)));
+            }
+            else
+            {
+                write_varint(static_cast<std::uint64_t>(number));
+            }
+        }
+
+        template <typename T>
+        void write(const T& value, detail::archive_object_tag)
+        {
+            auto fields = lang::as_tuple(value);
+            tuple_foreach(fields, [this](const auto& field) { write(field); });
+        }
+
+        template <typename T>
+        void write(const T& value, detail::archive_bytes_tag)
+        {
+            write_bytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void write(const T& value, detail::archive_range_tag)
+        {
+            write_size(static_cast<std::size_t>(std::distance(std::begin(value), std::end(value))));
+
+            for (const auto& element : value)
+            {
+                write(element);
+            }
+        }
+
+        template <typename T, bool False = false>
+        void write(const T&, detail::archive_unsupported_tag)
+        {
+            static_assert(False, "binary_archive cannot serialize this type, nor any pointer");
+        }
+
+        template <typename Tuple, std::size_t... I>
+        void write_tuple(const Tuple& value, std::index_sequence<I...>)
+        {
+            auto l = { (write(std::get<I>(value)), 0)... };
+
+            // l is only for meta bullshit
+            (void)l;
+        }
+
+        /// a length followed by the elements, aligned for zero-copy reads if copied verbatim
+        template <typename T>
+        void write_run(const T* data, std::size_t size)
+        {
+            write_size(size);
+            write_elements(data, size, detail::archive_is_bulk<T>());
+        }
+
+        template <typename T>
+        void write_elements(const T* data, std::size_t size, std::true_type)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+
+            buffer_.resize((buffer_.size() + alignof(T) - 1) / alignof(T) * alignof(T), 0);
+            write_bytes(data, size * sizeof(T));
+        }
+
+        template <typename T>
+        void write_elements(const T* data, std::size_t size, std::false_type)
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                write(data[i]);
+            }
+        }
+
+        void write_unsigned(std::uint64_t value)
+        {
+            if (encoding_ == binary_encoding::fixed)
+            {
+                write_bytes(&value, sizeof(value));
+            }
+            else
+            {
+                write_varint(value);
+            }
+        }
+
+        void write_varint(std::uint64_t value)
+        {
+            char bytes[10];
+            std::size_t size = 0;
+
+            while (value >= 0x80)
+            {
+                bytes[size++] = static_cast<char>(value | 0x80);
+                value >>= 7;
+            }
+
+            bytes[size++] = static_cast<char>(value);
+            write_bytes(bytes, size);
+        }
+
+        binary_encoding encoding_;
+        std::vector<char> buffer_;
+    };
+
+    /**
+     * \brief Deserializes values written by a binary_archive
+     *
+     * The reader doesn't copy the buffer, which must outlive it. Reading into a string_ref, a
+     * std::string_view or a span<const T> doesn't copy either, the result points into the buffer.
+     * A span<const T> requires that the buffer starts at an address aligned for T, which holds
+     * for binary_archive::data(). Truncated or malformed input raises an exception.
+     */
+    class binary_reader
+    {
+    public:
+        binary_reader(const char* data, std::size_t size,
+                      binary_encoding encoding = binary_encoding::fixed)
+        : data_(data), size_(size), encoding_(encoding)
+        {
+        }
+
+        explicit binary_reader(span<const char> bytes,
+                               binary_encoding encoding = binary_encoding::fixed)
+        : binary_reader(bytes.data(), bytes.size(), encoding)
+        {
+        }
+
+        explicit binary_reader(const binary_archive& archive)
+        : binary_reader(archive.data(), archive.size(), archive.encoding())
+        {
+        }
+
+        binary_encoding encoding() const noexcept
+        {
+            return encoding_;
+        }
+
+        std::size_t position() const noexcept
+        {
+            return position_;
+        }
+
+        std::size_t remaining() const noexcept
+        {
+            return size_ - position_;
+        }
+
+        bool at_end() const noexcept
+        {
+            return position_ == size_;
+        }
+
+        template <typename T>
+        binary_reader& operator&(T& value)
+        {
+            read(value);
+            return *this;
+        }
+
+        template <typename T>
+        binary_reader& operator>>(T& value)
+        {
+            read(value);
+            return *this;
+        }
+
+        /// reads and returns a T, which must be default constructible
+        template <typename T>
+        T read()
+        {
+            T value;
+            read(value);
+            return value;
+        }
+
+        template <typename T>
+        void read(T& value)
+        {
+            read(value, detail::archive_tag<T>());
+        }
+
+        template <typename Char, typename Traits, typename Allocator>
+        void read(std::basic_string<Char, Traits, Allocator>& value)
+        {
+            auto run = read_view<Char>();
+            value.assign(run.data(), run.size());
+        }
+
+        void read(string_ref& value)
+        {
+            auto run = read_view<char>();
+            value = string_ref(run.data(), run.size());
+        }
+
+#if __cplusplus >= 201703L
+        template <typename Char, typename Traits>
+        void read(std::basic_string_view<Char, Traits>& value)
+        {
+            auto run = read_view<Char>();
+            value = std::basic_string_view<Char, Traits>(run.data(), run.size());
+        }
+
+        template <typename T>
+        void read(std::optional<T>& value)
+        {
+            if (read<bool>())
+            {
+                read(value.emplace());
+            }
+            else
+            {
+                value.reset();
+            }
+        }
+
+        template <typename... T>
+        void read(std::variant<T...>& value)
+        {
+            read_variant<0>(value, read_size());
+        }
+#endif
+
+        template <typename T>
+        void read(span<const T>& value)
+        {
+            value = read_view<T>();
+        }
+
+        template <typename T, typename Allocator>
+        void read(std::vector<T, Allocator>& value)
+        {
+            read_vector(value, detail::archive_is_bulk<T>());
+        }
+
+        template <typename Allocator>
+        void read(std::vector<bool, Allocator>& value)
+        {
+            read(value, detail::archive_range_tag());
+        }
+
+        template <typename T, std::size_t N>
+        void read(std::array<T, N>& value)
+        {
+            read_elements(value.data(), N, detail::archive_is_bulk<T>());
+        }
+
+        template <typename T, typename U>
+        void read(std::pair<T, U>& value)
+        {
+            read(value.first);
+            read(value.second);
+        }
+
+        template <typename... T>
+        void read(std::tuple<T...>& value)
+        {
+            read_tuple(value, std::index_sequence_for<T...>());
+        }
+
+        template <typename T>
+        void read(optional<T>& value)
+        {
+            if (read<bool>())
+            {
+                read(value.emplace());
+            }
+            else
+            {
+                value.reset();
+            }
+        }
+
+        /// returns the next size raw bytes without copying them
+        span<const char> read_bytes(std::size_t size)
+        {
+            if (size > remaining())
+                raise("Unexpected end of binary archive");
+
+            span<const char> result(data_ + position_, size);
+            position_ += size;
+            return result;
+        }
+
+        std::size_t read_size()
+        {
+            auto size = read_unsigned();
+
+            if (size > std::numeric_limits<std::size_t>::max())
+                raise("Size in binary archive is too large");
+
+            return static_cast<std::size_t>(size);
+        }
+
+    private:
+        template <typename T>
+        void read(T& value, detail::archive_bool_tag)
+        {
+            value = read_bytes(1)[0] != 0;
+        }
+
+        template <typename T>
+        void read(T& value, detail::archive_integer_tag)
+        {
+            using integer = detail::archive_integer_t<T>;
+            integer number;
+
+            if (encoding_ == binary_encoding::fixed)
+            {
+                std::memcpy(&number, read_bytes(sizeof(number)).data(), sizeof(number));
+            }
+            else if (std::is_signed<integer>::value)
+            {
+                auto decoded = detail::zigzag_decode(read_varint());
+
+                if (decoded < static_cast<std::int64_t>(std::numeric_limits<integer>::min()) ||
+                    decoded > static_cast<std::int64_t>(std::numeric_limits<integer>::max()))
+                    raise("Integer in binary archive is out of range");
+
+                number = static_cast<integer>(decoded);
+            }
+            else
+            {
+                auto decoded = read_varint();
+
+                if (decoded > static_cast<std::uint64_t>(std::numeric_limits<integer>::max()))
+                    raise("Integer in binary archive is out of range");
+
+                number = static_cast<integer>(decoded);
+            }
+
+            value = static_cast<T>(number);
+        }
+
+        template <typename T>
+        void read(T& value, detail::archive_object_tag)
+        {
+            auto fields = lang::as_tuple(value);
+            tuple_foreach(fields, [this](auto& field) { read(field); });
+        }
+
+        template <typename T>
+        void read(T& value, detail::archive_bytes_tag)
+        {
+            std::memcpy(static_cast<void*>(&value), read_bytes(sizeof(T)).data(), sizeof(T));
+        }
+
+        template <typename T>
+        void read(T& value, detail::archive_range_tag)
+        {
+            auto size = read_size();
+
+            value.clear();
+
+            for (std::size_t i = 0; i < size; i++)
+            {
+                typename detail::archive_element<T>::type element;
+                read(element);
+                value.insert(value.end(), std::move(element));
+            }
+        }
+
+        template <typename T, bool False = false>
+        void read(T&, detail::archive_unsupported_tag)
+        {
+            static_assert(False, "binary_reader cannot deserialize this type, nor any pointer");
+        }
+
+        template <typename Tuple, std::size_t... I>
+        void read_tuple(Tuple& value, std::index_sequence<I...>)
+        {
+            auto l = { (read(std::get<I>(value)), 0)... };
+
+            // l is only for meta bullshit
+            (void)l;
+        }
+
+#if __cplusplus >= 201703L
+        template <std::size_t I, typename... T>
+        void read_variant(std::variant<T...>& value, std::size_t index)
+        {
+            if constexpr (I < sizeof...(T))
+            {
+                if (I == index)
+                {
+                    read(value.template emplace<I>());
+                }
+                else
+                {
+                    read_variant<I + 1>(value, index);
+                }
+            }
+            else
+            {
+                raise("Invalid variant index in binary archive");
+            }
+        }
+#endif
+
+        /// the elements of a run, that binary_archive::write_run() copied verbatim
+        template <typename T>
+        span<const T> read_view()
+        {
+            static_assert(detail::archive_is_bulk<T>::value,
+                          "only runs of trivially copyable types can be viewed in place");
+
+            auto size = read_size();
+
+            if (size == 0)
+            {
+                return span<const T>();
+            }
+
+            skip_padding(alignof(T));
+
+            if (size > remaining() / sizeof(T))
+                raise("Unexpected end of binary archive");
+
+            auto data = data_ + position_;
+
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+                raise("Binary archive buffer is not aligned for the requested span");
+
+            position_ += size * sizeof(T);
+            return span<const T>(reinterpret_cast<const T*>(data), size);
+        }
+
+        template <typename Vector>
+        void read_vector(Vector& value, std::true_type)
+        {
+            auto size = read_size();
+
+            if (size == 0)
+            {
+                value.clear();
+                return;
+            }
+
+            using element = typename Vector::value_type;
+
+            skip_padding(alignof(element));
+
+            if (size > remaining() / sizeof(element))
+                raise("Unexpected end of binary archive");
+
+            value.resize(size);
+            std::memcpy(static_cast<void*>(value.data()), data_ + position_,
+                        size * sizeof(element));
+            position_ += size * sizeof(element);
+        }
+
+        template <typename Vector>
+        void read_vector(Vector& value, std::false_type)
+        {
+            auto size = read_size();
+
+            value.clear();
+            // every element takes at least a byte, so don't trust larger sizes
+            value.reserve(std::min(size, remaining()));
+
+            for (std::size_t i = 0; i < size; i++)
+            {
+                value.emplace_back();
+                read(value.back());
+            }
+        }
+
+        template <typename T>
+        void read_elements(T* data, std::size_t size, std::true_type)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+
+            skip_padding(alignof(T));
+            std::memcpy(static_cast<void*>(data), read_bytes(size * sizeof(T)).data(),
+                        size * sizeof(T));
+        }
+
+        template <typename T>
+        void read_elements(T* data, std::size_t size, std::false_type)
+        {
+            for (std::size_t i = 0; i < size; i++)
+            {
+                read(data[i]);
+            }
+        }
+
+        void skip_padding(std::size_t alignment)
+        {
+            auto aligned = (position_ + alignment - 1) / alignment * alignment;
+            read_bytes(aligned - position_);
+        }
+
+        std::uint64_t read_unsigned()
+        {
+            if (encoding_ == binary_encoding::varint)
+            {
+                return read_varint();
+            }
+
+            std::uint64_t value;
+            std::memcpy(&value, read_bytes(sizeof(value)).data(), sizeof(value));
+            return value;
+        }
+
+        std::uint64_t read_varint()
+        {
+            std::uint64_t value = 0;
+
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                auto byte = static_cast<unsigned char>(read_bytes(1)[0]);
+                value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            raise("Varint in binary archive is too long");
+        }
+
+        const char* data_;
+        std::size_t size_;
+        std::size_t position_ = 0;
+        binary_encoding encoding_;
+    };
+} // namespace lang
+} // namespace nitro
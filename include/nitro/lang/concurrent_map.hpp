@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/flat_map.hpp>
+#include <nitro/lang/optional.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief A hash map for concurrent use, split into independently locked shards
+     *
+     * The high bits of the hash select the shard, so they are independent of the low bits used
+     * within the shards. Each key is hashed once and the shard reuses that hash. Each shard is a
+     * flat_map behind a reader-writer lock, so lookups in different shards never contend and
+     * lookups in the same shard only share the lock.
+     *
+     * Values are never handed out by reference, as they could be modified or erased
+     * concurrently. Use find() to get a copy or visit() and upsert() to access them in place.
+     */
+    template <typename Key, typename T, typename Hash = hash_wrapper<Key>,
+              typename KeyEqual = typename detail::default_key_equal<Key>::type>
+    class concurrent_map
+    {
+        using map_type = flat_map<Key, T, Hash, KeyEqual>;
+
+        struct shard
+        {
+            mutable std::shared_timed_mutex mutex;
+            map_type map;
+
+            // keeps the locks of neighboring shards in different cache lines
+            char padding[64];
+        };
+
+        using shared_lock = std::shared_lock<std::shared_timed_mutex>;
+        using unique_lock = std::unique_lock<std::shared_timed_mutex>;
+
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using size_type = std::size_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+
+        /// shard_count is rounded up to a power of two, 0 picks one for the number of cores
+        explicit concurrent_map(size_type shard_count = 0, const Hash& hash = Hash())
+        : hash_(hash)
+        {
+            if (shard_count == 0)
+            {
+                shard_count = 4 * std::max<size_type>(std::thread::hardware_concurrency(), 1);
+            }
+
+            shard_bits_ = 0;
+            while ((size_type(1) << shard_bits_) < shard_count)
+            {
+                ++shard_bits_;
+            }
+
+            shard_count = size_type(1) << shard_bits_;
+            shards_.reset(new shard[shard_count]);
+
+            for (size_type i = 0; i < shard_count; i++)
+            {
+                shards_[i].map = map_type(0, hash_);
+            }
+        }
+
+        concurrent_map(const concurrent_map&) = delete;
+        concurrent_map& operator=(const concurrent_map&) = delete;
+
+        size_type shard_count() const noexcept
+        {
+            return size_type(1) << shard_bits_;
+        }
+
+        /// returns a copy of the value for key, if there is one
+        optional<T> find(const Key& key) const
+        {
+            auto hash = hash_of(key);
+            const auto& s = shard_for(hash);
+            shared_lock lock(s.mutex);
+
+            auto it = s.map.find(key, hash);
+
+            if (it == s.map.end())
+            {
+                return {};
+            }
+
+            return it->second;
+        }
+
+        bool contains(const Key& key) const
+        {
+            auto hash = hash_of(key);
+            const auto& s = shard_for(hash);
+            shared_lock lock(s.mutex);
+
+            return s.map.find(key, hash) != s.map.end();
+        }
+
+        /// calls f(const T&) for the value of key under a shared lock, returns whether it exists
+        template <typename F>
+        bool visit(const Key& key, F&& f) const
+        {
+            auto hash = hash_of(key);
+            const auto& s = shard_for(hash);
+            shared_lock lock(s.mutex);
+
+            auto it = s.map.find(key, hash);
+
+            if (it == s.map.end())
+            {
+                return false;
+            }
+
+            std::forward<F>(f)(static_cast<const T&>(it->second));
+            return true;
+        }
+
+        /// inserts the value, if key doesn't exist yet, returns whether it was inserted
+        template <typename... Args>
+        bool insert(const Key& key, Args&&... args)
+        {
+            auto hash = hash_of(key);
+            auto& s = shard_for(hash);
+            unique_lock lock(s.mutex);
+
+            return s.map.try_emplace_hashed(hash, key, std::forward<Args>(args)...).second;
+        }
+
+        /// returns true, if the value was inserted, and false, if it was assigned
+        template <typename M>
+        bool insert_or_assign(const Key& key, M&& value)
+        {
+            auto hash = hash_of(key);
+            auto& s = shard_for(hash);
+            unique_lock lock(s.mutex);
+
+            auto result = s.map.try_emplace_hashed(hash, key, std::forward<M>(value));
+
+            if (!result.second)
+            {
+                result.first->second = std::forward<M>(value);
+            }
+
+            return result.second;
+        }
+
+        /**
+         * \brief Calls update(T&) on the value of key, or inserts T(args...), if it is missing
+         *
+         * Returns true, if the value was inserted. update runs under the lock of the shard, so it
+         * must not access this map.
+         */
+        template <typename F, typename... Args>
+        bool upsert(const Key& key, F&& update, Args&&... args)
+        {
+            auto hash = hash_of(key);
+            auto& s = shard_for(hash);
+            unique_lock lock(s.mutex);
+
+            auto result = s.map.try_emplace_hashed(hash, key, std::forward<Args>(args)...);
+
+            if (!result.second)
+            {
+                std::forward<F>(update)(result.first->second);
+            }
+
+            return result.second;
+        }
+
+        bool erase(const Key& key)
+        {
+            auto hash = hash_of(key);
+            auto& s = shard_for(hash);
+            unique_lock lock(s.mutex);
+
+            return s.map.erase(key, hash) != 0;
+        }
+
+        /// the sum of the shard sizes, each taken at a slightly different time
+        size_type size() const
+        {
+            size_type result = 0;
+
+            for (size_type i = 0; i < shard_count(); i++)
+            {
+                shared_lock lock(shards_[i].mutex);
+                result += shards_[i].map.size();
+            }
+
+            return result;
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        void clear()
+        {
+            for (size_type i = 0; i < shard_count(); i++)
+            {
+                unique_lock lock(shards_[i].mutex);
+                shards_[i].map.clear();
+            }
+        }
+
+        /// reserves room for count elements, assuming they are evenly spread across the shards
+        void reserve(size_type count)
+        {
+            auto per_shard = count / shard_count() + count / shard_count() / 8 + 1;
+
+            for (size_type i = 0; i < shard_count(); i++)
+            {
+                unique_lock lock(shards_[i].mutex);
+                shards_[i].map.reserve(per_shard);
+            }
+        }
+
+        /// calls f(const Key&, const T&) for every element, one shard at a time
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (size_type i = 0; i < shard_count(); i++)
+            {
+                shared_lock lock(shards_[i].mutex);
+
+                for (const auto& entry : shards_[i].map)
+                {
+                    f(entry.first, entry.second);
+                }
+            }
+        }
+
+    private:
+        size_type hash_of(const Key& key) const
+        {
+            return detail::flat_hash(hash_, key);
+        }
+
+        size_type shard_index(size_type hash) const noexcept
+        {
+            if (shard_bits_ == 0)
+            {
+                return 0;
+            }
+
+            return hash >> (std::numeric_limits<size_type>::digits - shard_bits_);
+        }
+
+        shard& shard_for(size_type hash) noexcept
+        {
+            return shards_[shard_index(hash)];
+        }
+
+        const shard& shard_for(size_type hash) const noexcept
+        {
+            return shards_[shard_index(hash)];
+        }
+
+        Hash hash_;
+        unsigned shard_bits_;
+        std::unique_ptr<shard[]> shards_;
+    };
+} // namespace lang
+} // namespace nitro
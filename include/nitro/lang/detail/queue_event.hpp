@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/detail/bits.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        inline void spin_pause() noexcept
+        {
+#ifdef NITRO_LANG_SSE2
+            _mm_pause();
+#endif
+        }
+
+        /**
+         * \brief Lets threads block until a queue changes
+         *
+         * Waiting spins briefly, then blocks on a condition variable until the epoch changes.
+         * notify() runs after every push or pop, so it is only a relaxed load, while nobody
+         * waits. Without a full fence it may miss a waiter, which registers concurrently, so
+         * waiters wake up periodically, after 100 microseconds at first and at most every 10 ms,
+         * and check again. That bounds the latency of the rare missed notification.
+         */
+        class queue_event
+        {
+        public:
+            template <typename Predicate>
+            void wait_until(Predicate ready)
+            {
+                for (int spin = 0; spin < 64; spin++)
+                {
+                    if (ready())
+                    {
+                        return;
+                    }
+
+                    spin_pause();
+                }
+
+                waiters_.fetch_add(1, std::memory_order_seq_cst);
+
+                std::chrono::microseconds timeout(100);
+
+                // the predicate may notify other events, so it must run without our lock
+                while (true)
+                {
+                    std::uint64_t epoch;
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        epoch = epoch_;
+                    }
+
+                    if (ready())
+                    {
+                        break;
+                    }
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+
+                    if (!cv_.wait_for(lock, timeout, [this, epoch]() { return epoch_ != epoch; }) &&
+                        timeout < std::chrono::milliseconds(10))
+                    {
+                        timeout *= 2;
+                    }
+                }
+
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            /// call after the change, which waiting threads are waiting for
+            void notify()
+            {
+                if (waiters_.load(std::memory_order_relaxed) > 0)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        ++epoch_;
+                    }
+
+                    cv_.notify_all();
+                }
+            }
+
+        private:
+            std::atomic<std::size_t> waiters_{ 0 };
+            std::uint64_t epoch_ = 0;
+            std::mutex mutex_;
+            std::condition_variable cv_;
+        };
+
+        // keeps the atomics, that different threads write, on separate cache lines
+        constexpr std::size_t queue_padding = 64;
+
+        inline std::size_t queue_capacity(std::size_t capacity)
+        {
+            std::size_t result = 1;
+
+            while (result < capacity)
+            {
+                result *= 2;
+            }
+
+            return result;
+        }
+    } // namespace detail
+} // namespace lang
+} // namespace nitro
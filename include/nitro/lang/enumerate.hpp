@@ -28,6 +28,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace nitro
@@ -40,101 +46,255 @@ namespace lang
         template <typename T>
         class enumerate;
 
+        // iterators without iterator_traits are treated as input iterators
+        template <typename Iterator, typename = void>
+        struct enumerate_traits
+        {
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+        };
+
         template <typename Iterator>
-        class enumerate_proxy
+        struct enumerate_traits<
+            Iterator, decltype(std::declval<typename std::iterator_traits<
+                                   Iterator>::iterator_category>(),
+                               void())>
         {
-            template <typename T>
-            friend class enumerate;
+            using iterator_category = typename std::iterator_traits<Iterator>::iterator_category;
+
+            // C++20 derives the iterator_traits of some iterators with a void difference_type
+            using difference_type = std::conditional_t<
+                std::is_void<typename std::iterator_traits<Iterator>::difference_type>::value,
+                std::ptrdiff_t, typename std::iterator_traits<Iterator>::difference_type>;
+        };
+
+        template <typename Iterator>
+        using is_random_access =
+            std::is_base_of<std::random_access_iterator_tag,
+                            typename enumerate_traits<Iterator>::iterator_category>;
+
+        /**
+         * \brief The index and the element of an enumerated range
+         *
+         * Reference is the reference type of the underlying iterator, so for containers,
+         * value() refers to the element in the container. The index and the value can also be
+         * bound with structured bindings: for (auto [i, v] : enumerate(c)).
+         */
+        template <typename Reference>
+        class enumerate_element
+        {
+        public:
+            enumerate_element(std::size_t index, Reference value)
+            : index_(index), value_(std::forward<Reference>(value))
+            {
+            }
+
+            std::size_t index() const noexcept
+            {
+                return index_;
+            }
+
+            Reference value() const
+            {
+                return static_cast<Reference>(value_);
+            }
+
+            template <std::size_t I>
+            std::enable_if_t<I == 0, std::size_t> get() const noexcept
+            {
+                return index_;
+            }
+
+            template <std::size_t I>
+            std::enable_if_t<I == 1, Reference> get() const
+            {
+                return static_cast<Reference>(value_);
+            }
+
+        private:
+            std::size_t index_;
+            Reference value_;
+        };
+
+        /// an iterator over enumerate_element, with the category of the underlying iterator
+        template <typename Iterator>
+        class enumerate_iterator
+        {
+            using traits = enumerate_traits<Iterator>;
+
+        public:
+            using iterator_category = typename traits::iterator_category;
+            using difference_type = typename traits::difference_type;
+            using reference = enumerate_element<decltype(*std::declval<Iterator&>())>;
+            using value_type = reference;
+            using pointer = void;
+
+            enumerate_iterator() = default;
+
+            enumerate_iterator(Iterator it, std::size_t index) : it_(it), index_(index)
+            {
+            }
+
+            reference operator*()
+            {
+                return { index_, *it_ };
+            }
+
+            reference operator*() const
+            {
+                return { index_, *it_ };
+            }
+
+            reference operator[](difference_type n) const
+            {
+                return *(*this + n);
+            }
+
+            enumerate_iterator& operator++()
+            {
+                ++it_;
+                ++index_;
+
+                return *this;
+            }
+
+            enumerate_iterator operator++(int)
+            {
+                enumerate_iterator orig = *this;
+                ++(*this);
+                return orig;
+            }
+
+            enumerate_iterator& operator--()
+            {
+                --it_;
+                --index_;
+
+                return *this;
+            }
+
+            enumerate_iterator operator--(int)
+            {
+                enumerate_iterator orig = *this;
+                --(*this);
+                return orig;
+            }
 
-            template <typename U>
-            struct proxy
+            enumerate_iterator& operator+=(difference_type n)
             {
-                proxy(std::size_t index, U value) : index_(index), value_(value)
-                {
-                }
+                it_ += n;
+                index_ += n;
+
+                return *this;
+            }
 
-                std::size_t index()
-                {
-                    return index_;
-                }
+            enumerate_iterator& operator-=(difference_type n)
+            {
+                return *this += -n;
+            }
 
-                std::size_t index() const
-                {
-                    return index_;
-                }
+            friend enumerate_iterator operator+(enumerate_iterator it, difference_type n)
+            {
+                return it += n;
+            }
 
-                U value()
-                {
-                    return value_;
-                }
+            friend enumerate_iterator operator+(difference_type n, enumerate_iterator it)
+            {
+                return it += n;
+            }
+
+            friend enumerate_iterator operator-(enumerate_iterator it, difference_type n)
+            {
+                return it -= n;
+            }
+
+            friend difference_type operator-(const enumerate_iterator& a,
+                                             const enumerate_iterator& b)
+            {
+                return a.it_ - b.it_;
+            }
 
-                const U value() const
-                {
-                    return value_;
-                }
+            // by value, as some iterators only have non-const comparisons
+            friend bool operator==(enumerate_iterator a, enumerate_iterator b)
+            {
+                return !(a.it_ != b.it_);
+            }
 
-            private:
-                std::size_t index_;
-                U value_;
-            };
+            friend bool operator!=(enumerate_iterator a, enumerate_iterator b)
+            {
+                return a.it_ != b.it_;
+            }
 
-            struct iterator
+            friend bool operator<(const enumerate_iterator& a, const enumerate_iterator& b)
             {
-                using value_type = decltype(*std::declval<Iterator>());
+                return a.it_ < b.it_;
+            }
 
-                iterator(Iterator it, std::size_t index) : it_(it), index_(index)
-                {
-                }
+            friend bool operator>(const enumerate_iterator& a, const enumerate_iterator& b)
+            {
+                return b < a;
+            }
 
-                auto operator*()
-                {
-                    return proxy<value_type>(index_, *it_);
-                }
+            friend bool operator<=(const enumerate_iterator& a, const enumerate_iterator& b)
+            {
+                return !(b < a);
+            }
 
-                auto operator*() const
-                {
-                    return proxy<const value_type&>(index_, *it_);
-                }
+            friend bool operator>=(const enumerate_iterator& a, const enumerate_iterator& b)
+            {
+                return !(a < b);
+            }
 
-                iterator& operator++()
-                {
-                    ++it_;
-                    ++index_;
+            const Iterator& base() const noexcept
+            {
+                return it_;
+            }
 
-                    return *this;
-                }
+            std::size_t index() const noexcept
+            {
+                return index_;
+            }
 
-                iterator operator++(int)
-                {
+        private:
+            Iterator it_;
+            std::size_t index_;
+        };
 
-                    iterator orig = *this;
-                    ++(*this);
-                    return orig;
-                }
+        template <typename Iterator>
+        std::size_t enumerate_end_index(const Iterator& begin, const Iterator& end,
+                                        std::true_type)
+        {
+            return static_cast<std::size_t>(end - begin);
+        }
 
-                bool operator!=(iterator other)
-                {
-                    return it_ != other.it_;
-                }
+        // the index of the end is only needed to step back from it, which is too costly here
+        template <typename Iterator>
+        std::size_t enumerate_end_index(const Iterator&, const Iterator&, std::false_type)
+        {
+            return 0;
+        }
 
-            private:
-                Iterator it_;
-                std::size_t index_;
-            };
+        template <typename Iterator>
+        class enumerate_proxy
+        {
+            template <typename T>
+            friend class enumerate;
 
         public:
+            using iterator = enumerate_iterator<Iterator>;
+
             enumerate_proxy(Iterator begin, Iterator end) : begin_(begin), end_(end)
             {
             }
 
-            iterator begin()
+            iterator begin() const
             {
                 return { begin_, 0 };
             }
 
-            iterator end()
+            iterator end() const
             {
-                return { end_, 0 };
+                return { end_, enumerate_end_index(begin_, end_, is_random_access<Iterator>()) };
             }
 
         private:
@@ -150,19 +310,37 @@ namespace lang
             {
             }
 
+            auto begin()
+            {
+                return proxy(container_).begin();
+            }
+
+            auto end()
+            {
+                return proxy(container_).end();
+            }
+
             auto begin() const
             {
-                return typename enumerate_proxy<decltype(container_.begin())>::iterator(
-                    container_.begin(), 0);
+                return proxy(container_).begin();
             }
 
             auto end() const
             {
-                return typename enumerate_proxy<decltype(container_.begin())>::iterator(
-                    container_.end(), 0);
+                return proxy(container_).end();
             }
 
         private:
+            template <typename C>
+            static auto proxy(C& container)
+            {
+                using std::begin;
+                using std::end;
+
+                return enumerate_proxy<decltype(begin(container))>(begin(container),
+                                                                   end(container));
+            }
+
             T container_;
         };
     } // namespace detail
@@ -200,3 +378,24 @@ namespace lang
     }
 } // namespace lang
 } // namespace nitro
+
+namespace std
+{
+template <typename Reference>
+struct tuple_size<nitro::lang::detail::enumerate_element<Reference>>
+: std::integral_constant<std::size_t, 2>
+{
+};
+
+template <typename Reference>
+struct tuple_element<0, nitro::lang::detail::enumerate_element<Reference>>
+{
+    using type = std::size_t;
+};
+
+template <typename Reference>
+struct tuple_element<1, nitro::lang::detail::enumerate_element<Reference>>
+{
+    using type = Reference;
+};
+} // namespace std
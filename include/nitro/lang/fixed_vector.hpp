@@ -31,16 +31,40 @@
 #include <nitro/except/raise.hpp>
 
 #include <array>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
 
 namespace nitro
 {
 namespace lang
 {
-    template <typename T>
+    /**
+     * \brief A vector with a capacity fixed at construction
+     *
+     * The storage for capacity elements is allocated once, but elements are only constructed on
+     * insertion and destroyed on removal. A moved-from vector keeps its capacity and allocates
+     * new storage with the next insertion.
+     *
+     * The storage is obtained from Allocator, elements are constructed with it as well. See
+     * pmr::fixed_vector to place the vector in a std::pmr::memory_resource, e.g., an arena.
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
     class fixed_vector
     {
+        using allocator_traits = std::allocator_traits<Allocator>;
+
     public:
+        using allocator_type = Allocator;
         using value_type = T;
         using pointer = value_type*;
         using const_pointer = const value_type*;
@@ -52,49 +76,127 @@ namespace lang
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-        constexpr fixed_vector(size_type capacity)
-        : capacity_(capacity), data_(std::make_unique<value_type[]>(capacity))
+        constexpr fixed_vector(size_type capacity, const allocator_type& alloc = allocator_type())
+        : capacity_(capacity), allocator_(alloc), data_(allocate(capacity))
         {
         }
 
-        template <typename Iterabel>
-        constexpr fixed_vector(size_type capacity, const Iterabel& array)
-        : capacity_(capacity), data_(std::make_unique<value_type[]>(capacity))
+        template <typename Iterabel, typename = std::enable_if_t<
+                                         !std::is_convertible<Iterabel, allocator_type>::value>>
+        constexpr fixed_vector(size_type capacity, const Iterabel& array,
+                               const allocator_type& alloc = allocator_type())
+        : fixed_vector(capacity, alloc)
         {
             insert(this->begin(), array.begin(), array.end());
         }
 
-        constexpr fixed_vector(const std::initializer_list<value_type>& list)
-        : capacity_(list.size()), data_(std::make_unique<value_type[]>(list.size()))
+        constexpr fixed_vector(const std::initializer_list<value_type>& list,
+                               const allocator_type& alloc = allocator_type())
+        : fixed_vector(list.size(), alloc)
         {
             insert(this->begin(), list.begin(), list.end());
         }
 
-        constexpr fixed_vector(const fixed_vector<value_type>& v) : fixed_vector(v.capacity_, v)
+        constexpr fixed_vector(const fixed_vector& v)
+        : fixed_vector(v, allocator_traits::select_on_container_copy_construction(v.allocator_))
         {
         }
 
-        constexpr fixed_vector(fixed_vector<value_type>&& v)
-        : capacity_(v.capacity_), data_(std::move(v.data_))
+        constexpr fixed_vector(const fixed_vector& v, const allocator_type& alloc)
+        : fixed_vector(v.capacity_, v, alloc)
         {
         }
 
-        constexpr fixed_vector operator=(const fixed_vector& v)
+        constexpr fixed_vector(fixed_vector&& v) noexcept
+        : size_(v.size_), capacity_(v.capacity_), allocator_(std::move(v.allocator_)),
+          data_(v.data_)
         {
-            return fixed_vector(v);
+            v.size_ = 0;
+            v.data_ = nullptr;
         }
 
-        constexpr fixed_vector operator=(fixed_vector&& v)
+        constexpr fixed_vector& operator=(const fixed_vector& v)
         {
-            return fixed_vector(std::move(v));
+            if (this != &v)
+            {
+                clear();
+
+                if (capacity_ != v.capacity_ ||
+                    (allocator_traits::propagate_on_container_copy_assignment::value &&
+                     allocator_ != v.allocator_))
+                {
+                    deallocate(data_, capacity_);
+                    data_ = nullptr;
+                    capacity_ = v.capacity_;
+                }
+
+                if (allocator_traits::propagate_on_container_copy_assignment::value)
+                {
+                    allocator_ = v.allocator_;
+                }
+
+                insert(begin(), v.begin(), v.end());
+            }
+
+            return *this;
         }
 
-        constexpr fixed_vector operator=(const std::initializer_list<value_type>& l)
+        constexpr fixed_vector& operator=(fixed_vector&& v) noexcept(
+            allocator_traits::propagate_on_container_move_assignment::value ||
+            allocator_traits::is_always_equal::value)
         {
-            return fixed_vector(l.size(), l);
+            if (this == &v)
+            {
+                return *this;
+            }
+
+            clear();
+
+            if (allocator_traits::propagate_on_container_move_assignment::value ||
+                allocator_ == v.allocator_)
+            {
+                deallocate(data_, capacity_);
+
+                if (allocator_traits::propagate_on_container_move_assignment::value)
+                {
+                    allocator_ = std::move(v.allocator_);
+                }
+
+                size_ = v.size_;
+                capacity_ = v.capacity_;
+                data_ = v.data_;
+
+                v.size_ = 0;
+                v.data_ = nullptr;
+            }
+            else
+            {
+                // the storage of v belongs to another allocator, so we can only move the elements
+                if (capacity_ != v.capacity_)
+                {
+                    deallocate(data_, capacity_);
+                    data_ = nullptr;
+                    capacity_ = v.capacity_;
+                }
+
+                insert(begin(), std::make_move_iterator(v.begin()),
+                       std::make_move_iterator(v.end()));
+                v.clear();
+            }
+
+            return *this;
         }
 
-        ~fixed_vector() = default;
+        constexpr fixed_vector& operator=(const std::initializer_list<value_type>& l)
+        {
+            return *this = fixed_vector(l, allocator_);
+        }
+
+        ~fixed_vector()
+        {
+            clear();
+            deallocate(data_, capacity_);
+        }
 
         constexpr bool empty() const
         {
@@ -121,7 +223,7 @@ namespace lang
             if (key >= capacity_)
                 raise("Key is larger than capacity");
 
-            if (key > size_)
+            if (key >= size_)
                 raise("Key is larger than size, use append() instead");
 
             return data_[key];
@@ -137,7 +239,7 @@ namespace lang
             if (key >= capacity_)
                 raise("Key is larger than capacity!");
 
-            if (key > size_)
+            if (key >= size_)
                 raise("Key is larger than size, use emplace_back() instead!");
 
             return data_[key];
@@ -166,12 +268,41 @@ namespace lang
         template <class... Args>
         constexpr void emplace(pointer const pos, Args&&... args)
         {
-            auto key = std::distance(begin(), pos);
+            size_type key = std::distance(begin(), pos);
+
+            if (key > size_)
+                raise("Key larger than size!");
+
+            if (key == size_)
+            {
+                emplace_back(std::forward<Args>(args)...);
+                return;
+            }
 
             if (size_ >= capacity_)
                 raise("No capacity left!");
 
-            replace(data_[key], value_type(args...));
+            // the arguments might refer to elements, which are moved below
+            value_type value(std::forward<Args>(args)...);
+
+            if (std::is_trivially_copyable<value_type>::value)
+            {
+                std::memmove(static_cast<void*>(data_ + key + 1), data_ + key,
+                             (size_ - key) * sizeof(value_type));
+                construct(key, std::move(value));
+            }
+            else
+            {
+                construct(size_, std::move(data_[size_ - 1]));
+
+                for (size_type i = size_ - 1; i > key; --i)
+                {
+                    replace(data_[i], std::move(data_[i - 1]));
+                }
+
+                replace(data_[key], std::move(value));
+            }
+
             ++size_;
         }
 
@@ -181,7 +312,7 @@ namespace lang
             if (size_ >= capacity_)
                 raise("No capacity left!");
 
-            replace(data_[size_], value_type(std::forward<Args>(args)...));
+            construct(size_, std::forward<Args>(args)...);
             ++size_;
 
             return size_ - 1;
@@ -189,26 +320,15 @@ namespace lang
 
         constexpr size_type insert(const_reference value)
         {
-            if (size_ >= capacity_)
-                raise("No capacity left!");
-
-            replace(data_[size_], value);
-            ++size_;
-
-            return size_ - 1;
+            return emplace_back(value);
         }
 
         constexpr size_type insert(value_type&& value)
         {
-            if (size_ >= capacity_)
-                raise("No capacity left!");
-
-            replace(data_[size_], std::move(value));
-            ++size_;
-
-            return size_ - 1;
+            return emplace_back(std::move(value));
         }
 
+        /// Writes [start, end) starting at pos, overwriting elements and appending the rest
         template <typename Iter>
         constexpr void insert(iterator const pos, Iter start, Iter end)
         {
@@ -216,19 +336,7 @@ namespace lang
             if (key > size_)
                 raise("Key larger than size!");
 
-            while (start != end)
-            {
-                if (key >= capacity_)
-                    raise("No capacity left!");
-
-                data_[key] = *start;
-
-                if (key == size_)
-                    ++size_;
-
-                ++key;
-                ++start;
-            }
+            insert_at(key, start, end, is_trivial_copy<Iter>());
         }
 
         constexpr void insert(iterator const pos, std::initializer_list<value_type>& list)
@@ -238,13 +346,12 @@ namespace lang
 
         constexpr size_type push_back(const_reference value)
         {
-            if (size_ >= capacity_)
-                raise("No capacity left!");
-
-            data_[size_] = value;
-            ++size_;
+            return emplace_back(value);
+        }
 
-            return size_ - 1;
+        constexpr size_type push_back(value_type&& value)
+        {
+            return emplace_back(std::move(value));
         }
 
         template <typename Iter>
@@ -259,6 +366,30 @@ namespace lang
                 raise("Container is empty!");
 
             --size_;
+            destroy(size_);
+        }
+
+        /// Sets the size without constructing the new elements, e.g., to fill data() in place
+        constexpr void resize_uninitialized(size_type size)
+        {
+            static_assert(std::is_trivial<value_type>::value,
+                          "resize_uninitialized() requires a trivial value_type");
+
+            if (size > capacity_)
+                raise("No capacity left!");
+
+            if (data_ == nullptr)
+                data_ = allocate(capacity_);
+
+            size_ = size;
+        }
+
+        constexpr void clear() noexcept
+        {
+            while (size_ > 0)
+            {
+                destroy(--size_);
+            }
         }
 
         constexpr iterator begin() noexcept
@@ -328,29 +459,139 @@ namespace lang
             if (key >= size_)
                 raise("Key does not exsist!");
 
-            while (key + 1 < size_ && key + 1 < capacity_)
+            if (std::is_trivially_copyable<value_type>::value)
             {
-                replace(data_[key], std::forward<value_type>(data_[key + 1]));
-                ++key;
+                std::memmove(static_cast<void*>(data_ + key), data_ + key + 1,
+                             (size_ - key - 1) * sizeof(value_type));
+            }
+            else
+            {
+                while (key + 1 < size_)
+                {
+                    replace(data_[key], std::move(data_[key + 1]));
+                    ++key;
+                }
+            }
+
+            --size_;
+            destroy(size_);
+        }
+
+        /// Erases pos by moving the last element into its place, doesn't preserve the order
+        constexpr void erase_unordered(iterator pos)
+        {
+            size_type key = std::distance(begin(), pos);
+
+            if (key >= size_)
+                raise("Key does not exsist!");
+
+            if (key + 1 != size_)
+            {
+                replace(data_[key], std::move(data_[size_ - 1]));
             }
+
             --size_;
+            destroy(size_);
         }
 
         constexpr pointer data() noexcept
         {
-            return data_.get();
+            return data_;
         }
 
         constexpr const_pointer data() const noexcept
         {
-            return data_.get();
+            return data_;
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return allocator_;
         }
 
     private:
+        template <typename Iter>
+        using is_trivial_copy = std::integral_constant<
+            bool, std::is_trivially_copyable<value_type>::value && std::is_pointer<Iter>::value &&
+                      std::is_same<std::remove_cv_t<std::remove_pointer_t<Iter>>,
+                                   value_type>::value>;
+
+        pointer allocate(size_type capacity)
+        {
+            if (capacity == 0)
+                return nullptr;
+
+            return allocator_traits::allocate(allocator_, capacity);
+        }
+
+        void deallocate(pointer data, size_type capacity) noexcept
+        {
+            if (data != nullptr)
+                allocator_traits::deallocate(allocator_, data, capacity);
+        }
+
+        template <class... Args>
+        constexpr void construct(size_type key, Args&&... args)
+        {
+            if (data_ == nullptr)
+                data_ = allocate(capacity_);
+
+            allocator_traits::construct(allocator_, data_ + key, std::forward<Args>(args)...);
+        }
+
+        constexpr void destroy(size_type key) noexcept
+        {
+            allocator_traits::destroy(allocator_, data_ + key);
+        }
+
+        template <typename Iter>
+        constexpr void insert_at(size_type key, Iter start, Iter end, std::true_type)
+        {
+            size_type count = end - start;
+
+            if (count == 0)
+                return;
+
+            if (key + count > capacity_)
+                raise("No capacity left!");
+
+            if (data_ == nullptr)
+                data_ = allocate(capacity_);
+
+            std::memmove(static_cast<void*>(data_ + key), start, count * sizeof(value_type));
+
+            if (key + count > size_)
+                size_ = key + count;
+        }
+
+        template <typename Iter>
+        constexpr void insert_at(size_type key, Iter start, Iter end, std::false_type)
+        {
+            while (start != end)
+            {
+                if (key >= capacity_)
+                    raise("No capacity left!");
+
+                if (key < size_)
+                {
+                    data_[key] = *start;
+                }
+                else
+                {
+                    construct(key, *start);
+                    ++size_;
+                }
+
+                ++key;
+                ++start;
+            }
+        }
+
         size_type size_ = 0;
         size_type capacity_ = 0;
 
-        std::unique_ptr<value_type[]> data_;
+        allocator_type allocator_;
+        pointer data_ = nullptr;
 
         template <typename A>
         constexpr std::enable_if_t<std::is_move_assignable<A>::value> replace(A& a, A&& b)
@@ -365,13 +606,23 @@ namespace lang
         }
     };
 
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+        template <typename T>
+        using fixed_vector = lang::fixed_vector<T, std::pmr::polymorphic_allocator<T>>;
+    } // namespace pmr
+#endif
+#endif
+
 } // namespace lang
 } // namespace nitro
 
 namespace std
 {
-template <size_t I, typename T>
-T& get(nitro::lang::fixed_vector<T>& c) noexcept
+template <size_t I, typename T, typename Allocator>
+T& get(nitro::lang::fixed_vector<T, Allocator>& c) noexcept
 {
     return c.at(I);
 }
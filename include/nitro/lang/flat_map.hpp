@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+#include <nitro/lang/flat_table.hpp>
+
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        // Like abseil's map_slot_type: the slot is constructed as a pair with a mutable key, so
+        // growing the table moves keys instead of copying them. Users only ever see value.
+        template <typename Key, typename T>
+        union flat_map_slot
+        {
+            flat_map_slot()
+            {
+            }
+
+            // the table destroys the active member
+            ~flat_map_slot()
+            {
+            }
+
+            std::pair<const Key, T> value;
+            std::pair<Key, T> mutable_value;
+        };
+
+        template <typename Key, typename T>
+        struct flat_map_policy
+        {
+            using key_type = Key;
+            using value_type = std::pair<const Key, T>;
+            using slot_type = flat_map_slot<Key, T>;
+
+            static_assert(sizeof(value_type) == sizeof(std::pair<Key, T>) &&
+                              alignof(value_type) == alignof(std::pair<Key, T>),
+                          "pairs with a const and a mutable key need the same layout");
+
+            static constexpr bool const_values = false;
+
+            template <typename Allocator, typename... Args>
+            static void construct(Allocator& alloc, slot_type* slot, Args&&... args)
+            {
+                std::allocator_traits<Allocator>::construct(alloc, &slot->mutable_value,
+                                                            std::forward<Args>(args)...);
+            }
+
+            template <typename Allocator>
+            static void destroy(Allocator& alloc, slot_type* slot) noexcept
+            {
+                std::allocator_traits<Allocator>::destroy(alloc, &slot->mutable_value);
+            }
+
+            static std::pair<Key, T>&& move(slot_type& slot) noexcept
+            {
+                return std::move(slot.mutable_value);
+            }
+
+            static value_type& value(slot_type& slot) noexcept
+            {
+#ifdef __cpp_lib_launder
+                return *std::launder(&slot.value);
+#else
+                return slot.value;
+#endif
+            }
+
+            static const value_type& value(const slot_type& slot) noexcept
+            {
+#ifdef __cpp_lib_launder
+                return *std::launder(&slot.value);
+#else
+                return slot.value;
+#endif
+            }
+
+            static const Key& key(const value_type& value) noexcept
+            {
+                return value.first;
+            }
+
+            static bool equal_values(const value_type& a, const value_type& b)
+            {
+                return a.second == b.second;
+            }
+        };
+    } // namespace detail
+
+    /**
+     * \brief An open addressing hash map, which stores its values in one flat array
+     *
+     * Unlike unordered_map, there is no allocation per element and lookups don't chase
+     * pointers. Inserting and erasing invalidates iterators, references and pointers, unless
+     * the map was reserved for enough elements.
+     *
+     * Use pmr::flat_map to place the map in a std::pmr::memory_resource.
+     */
+    template <typename Key, typename T, typename Hash = hash_wrapper<Key>,
+              typename KeyEqual = typename detail::default_key_equal<Key>::type,
+              typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class flat_map
+    : public detail::flat_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual, Allocator>
+    {
+        using base = detail::flat_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+    public:
+        using mapped_type = T;
+        using typename base::iterator;
+        using typename base::key_type;
+        using typename base::size_type;
+        using typename base::value_type;
+
+        using base::base;
+
+        flat_map() = default;
+
+        template <typename InputIt>
+        flat_map(InputIt first, InputIt last, size_type bucket_count = 0)
+        : base(bucket_count)
+        {
+            insert(first, last);
+        }
+
+        flat_map(std::initializer_list<value_type> list, size_type bucket_count = 0)
+        : flat_map(list.begin(), list.end(), bucket_count)
+        {
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return this->emplace_key(value.first, value);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return this->emplace_key(value.first, std::move(value));
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                emplace(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> list)
+        {
+            insert(list.begin(), list.end());
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            std::pair<Key, T> value(std::forward<Args>(args)...);
+            return this->emplace_key(value.first, std::move(value));
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+        {
+            return this->emplace_key(key, std::piecewise_construct,
+                                     std::forward_as_tuple(std::move(key)),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        /// try_emplace for a key, whose hash_of() was computed before
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace_hashed(size_type hash, const key_type& key,
+                                                     Args&&... args)
+        {
+            return this->emplace_hashed(hash, key, std::piecewise_construct,
+                                        std::forward_as_tuple(key),
+                                        std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value)
+        {
+            auto result = try_emplace(key, std::forward<M>(value));
+
+            if (!result.second)
+            {
+                result.first->second = std::forward<M>(value);
+            }
+
+            return result;
+        }
+
+        template <typename M>
+        std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& value)
+        {
+            auto result = try_emplace(std::move(key), std::forward<M>(value));
+
+            if (!result.second)
+            {
+                result.first->second = std::forward<M>(value);
+            }
+
+            return result;
+        }
+
+        T& operator[](const key_type& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        T& operator[](key_type&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        T& at(const key_type& key)
+        {
+            auto it = this->find(key);
+
+            if (it == this->end())
+            {
+                raise("Key not found in flat_map");
+            }
+
+            return it->second;
+        }
+
+        const T& at(const key_type& key) const
+        {
+            auto it = this->find(key);
+
+            if (it == this->end())
+            {
+                raise("Key not found in flat_map");
+            }
+
+            return it->second;
+        }
+
+        template <typename K, typename H = Hash, typename E = KeyEqual,
+                  typename = typename H::is_transparent, typename = typename E::is_transparent>
+        T& at(const K& key)
+        {
+            auto it = this->template find<K>(key);
+
+            if (it == this->end())
+            {
+                raise("Key not found in flat_map");
+            }
+
+            return it->second;
+        }
+
+        template <typename K, typename H = Hash, typename E = KeyEqual,
+                  typename = typename H::is_transparent, typename = typename E::is_transparent>
+        const T& at(const K& key) const
+        {
+            auto it = this->template find<K>(key);
+
+            if (it == this->end())
+            {
+                raise("Key not found in flat_map");
+            }
+
+            return it->second;
+        }
+    };
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+        template <typename Key, typename T, typename Hash = hash_wrapper<Key>,
+                  typename KeyEqual = typename detail::default_key_equal<Key>::type>
+        using flat_map = lang::flat_map<Key, T, Hash, KeyEqual,
+                                        std::pmr::polymorphic_allocator<std::pair<const Key, T>>>;
+    } // namespace pmr
+#endif
+#endif
+
+} // namespace lang
+} // namespace nitro
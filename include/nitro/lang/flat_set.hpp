@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/flat_table.hpp>
+
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        template <typename Key>
+        struct flat_set_policy
+        {
+            using key_type = Key;
+            using value_type = Key;
+            using slot_type = Key;
+
+            static constexpr bool const_values = true;
+
+            template <typename Allocator, typename... Args>
+            static void construct(Allocator& alloc, slot_type* slot, Args&&... args)
+            {
+                std::allocator_traits<Allocator>::construct(alloc, slot,
+                                                            std::forward<Args>(args)...);
+            }
+
+            template <typename Allocator>
+            static void destroy(Allocator& alloc, slot_type* slot) noexcept
+            {
+                std::allocator_traits<Allocator>::destroy(alloc, slot);
+            }
+
+            static slot_type&& move(slot_type& slot) noexcept
+            {
+                return std::move(slot);
+            }
+
+            static value_type& value(slot_type& slot) noexcept
+            {
+                return slot;
+            }
+
+            static const value_type& value(const slot_type& slot) noexcept
+            {
+                return slot;
+            }
+
+            static const Key& key(const value_type& value) noexcept
+            {
+                return value;
+            }
+
+            static bool equal_values(const value_type&, const value_type&)
+            {
+                return true;
+            }
+        };
+    } // namespace detail
+
+    /**
+     * \brief An open addressing hash set, which stores its values in one flat array
+     *
+     * See flat_map for the differences to unordered_set.
+     */
+    template <typename Key, typename Hash = hash_wrapper<Key>,
+              typename KeyEqual = typename detail::default_key_equal<Key>::type,
+              typename Allocator = std::allocator<Key>>
+    class flat_set
+    : public detail::flat_table<detail::flat_set_policy<Key>, Hash, KeyEqual, Allocator>
+    {
+        using base = detail::flat_table<detail::flat_set_policy<Key>, Hash, KeyEqual, Allocator>;
+
+    public:
+        using typename base::iterator;
+        using typename base::size_type;
+        using typename base::value_type;
+
+        using base::base;
+
+        flat_set() = default;
+
+        template <typename InputIt>
+        flat_set(InputIt first, InputIt last, size_type bucket_count = 0) : base(bucket_count)
+        {
+            insert(first, last);
+        }
+
+        flat_set(std::initializer_list<value_type> list, size_type bucket_count = 0)
+        : flat_set(list.begin(), list.end(), bucket_count)
+        {
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return this->emplace_key(value, value);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return this->emplace_key(value, std::move(value));
+        }
+
+        template <typename InputIt>
+        void insert(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                emplace(*first);
+            }
+        }
+
+        void insert(std::initializer_list<value_type> list)
+        {
+            insert(list.begin(), list.end());
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            value_type value(std::forward<Args>(args)...);
+            return this->emplace_key(value, std::move(value));
+        }
+    };
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+        template <typename Key, typename Hash = hash_wrapper<Key>,
+                  typename KeyEqual = typename detail::default_key_equal<Key>::type>
+        using flat_set =
+            lang::flat_set<Key, Hash, KeyEqual, std::pmr::polymorphic_allocator<Key>>;
+    } // namespace pmr
+#endif
+#endif
+
+} // namespace lang
+} // namespace nitro
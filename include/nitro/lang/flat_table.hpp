@@ -0,0 +1,1000 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/detail/bits.hpp>
+#include <nitro/lang/hash.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        // The open addressing scheme of SwissTable, see https://abseil.io/about/design/swisstables
+        //
+        // Every slot has a control byte. It is either empty, deleted, or, for a full slot, holds
+        // the lower 7 bits of the hash (h2). Lookups compare h2 against a whole group of control
+        // bytes at once and only compare keys of matching slots. The remaining hash bits (h1)
+        // select where the probing starts.
+        using flat_ctrl = std::int8_t;
+
+        constexpr flat_ctrl flat_empty = -128;
+        constexpr flat_ctrl flat_deleted = -2;
+        constexpr flat_ctrl flat_sentinel = -1;
+
+        // The positions of matching control bytes in a group, each byte is 1 << Shift bits wide
+        template <typename T, int Shift>
+        class flat_bitmask
+        {
+        public:
+            explicit flat_bitmask(T mask) noexcept : mask_(mask)
+            {
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return mask_ != 0;
+            }
+
+            std::size_t lowest() const noexcept
+            {
+                return static_cast<std::size_t>(countr_zero(mask_)) >> Shift;
+            }
+
+            void clear_lowest() noexcept
+            {
+                mask_ &= mask_ - 1;
+            }
+
+        private:
+            T mask_;
+        };
+
+#ifdef NITRO_LANG_SSE2
+        class flat_group
+        {
+        public:
+            static constexpr std::size_t width = 16;
+
+            explicit flat_group(const flat_ctrl* ctrl) noexcept
+            : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+            {
+            }
+
+            flat_bitmask<std::uint32_t, 0> match(flat_ctrl h2) const noexcept
+            {
+                return flat_bitmask<std::uint32_t, 0>(static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+            }
+
+            flat_bitmask<std::uint32_t, 0> match_empty() const noexcept
+            {
+                return match(flat_empty);
+            }
+
+            flat_bitmask<std::uint32_t, 0> match_empty_or_deleted() const noexcept
+            {
+                // empty and deleted are the only control bytes below the sentinel
+                return flat_bitmask<std::uint32_t, 0>(static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flat_sentinel), ctrl_))));
+            }
+
+        private:
+            __m128i ctrl_;
+        };
+#else
+        // Without SSE2, a group is a 64 bit word, matched with bit tricks
+        class flat_group
+        {
+        public:
+            static constexpr std::size_t width = 8;
+
+            explicit flat_group(const flat_ctrl* ctrl) noexcept
+            : ctrl_(hash_read8(reinterpret_cast<const unsigned char*>(ctrl)))
+            {
+            }
+
+            flat_bitmask<std::uint64_t, 3> match(flat_ctrl h2) const noexcept
+            {
+                // may report false positives after a real match, but those only cost a key
+                // comparison
+                constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+                auto x = ctrl_ ^ (lsbs * static_cast<std::uint8_t>(h2));
+                return flat_bitmask<std::uint64_t, 3>((x - lsbs) & ~x & msbs);
+            }
+
+            flat_bitmask<std::uint64_t, 3> match_empty() const noexcept
+            {
+                return flat_bitmask<std::uint64_t, 3>((ctrl_ & (~ctrl_ << 6)) & msbs);
+            }
+
+            flat_bitmask<std::uint64_t, 3> match_empty_or_deleted() const noexcept
+            {
+                return flat_bitmask<std::uint64_t, 3>((ctrl_ & (~ctrl_ << 7)) & msbs);
+            }
+
+        private:
+            static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+
+            std::uint64_t ctrl_;
+        };
+#endif
+
+        // The control bytes of a table without slots, so lookups need no special case
+        inline const flat_ctrl* flat_empty_group() noexcept
+        {
+            alignas(16) static const flat_ctrl group[16] = {
+                flat_sentinel, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty,
+                flat_empty,    flat_empty, flat_empty, flat_empty, flat_empty, flat_empty,
+                flat_empty,    flat_empty, flat_empty, flat_empty
+            };
+            return group;
+        }
+
+        // hash_wrapper is built on lang::hash, which mixes all bits. Other hash functions, like
+        // std::hash for integers, need an extra mixing step to be usable for h1 and h2.
+        template <typename Hash>
+        struct flat_hash_mixes : std::false_type
+        {
+        };
+
+        template <typename T>
+        struct flat_hash_mixes<hash_wrapper<T>>
+        : std::integral_constant<bool, !std::is_base_of<hashable, T>::value>
+        {
+        };
+
+        template <>
+        struct flat_hash_mixes<string_hash> : std::true_type
+        {
+        };
+
+        // the hash of key as used by flat_table, exposed for tables sharing one hash with the
+        // caller
+        template <typename Hash, typename K>
+        inline std::size_t flat_hash(const Hash& hash, const K& key)
+        {
+            auto result = static_cast<std::uint64_t>(hash(key));
+
+            if (!flat_hash_mixes<Hash>::value)
+            {
+                result = hash_int(result);
+            }
+
+            return static_cast<std::size_t>(result);
+        }
+
+        template <typename Table, bool Const>
+        class flat_iterator
+        {
+            using slot_type = typename Table::slot_type;
+            using policy_type = typename Table::policy_type;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename Table::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const || Table::const_values, const value_type&,
+                                                 value_type&>;
+            using pointer = std::conditional_t<Const || Table::const_values, const value_type*,
+                                               value_type*>;
+
+            flat_iterator() = default;
+
+            // iterator converts to const_iterator
+            template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            flat_iterator(const flat_iterator<Table, OtherConst>& other) noexcept
+            : ctrl_(other.ctrl_), slot_(other.slot_)
+            {
+            }
+
+            reference operator*() const noexcept
+            {
+                return policy_type::value(*slot_);
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &policy_type::value(*slot_);
+            }
+
+            flat_iterator& operator++() noexcept
+            {
+                ++ctrl_;
+                ++slot_;
+                skip_empty_or_deleted();
+
+                return *this;
+            }
+
+            flat_iterator operator++(int) noexcept
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            friend bool operator==(const flat_iterator& a, const flat_iterator& b) noexcept
+            {
+                return a.ctrl_ == b.ctrl_;
+            }
+
+            friend bool operator!=(const flat_iterator& a, const flat_iterator& b) noexcept
+            {
+                return a.ctrl_ != b.ctrl_;
+            }
+
+        private:
+            friend Table;
+            friend class flat_iterator<Table, !Const>;
+
+            flat_iterator(const flat_ctrl* ctrl, slot_type* slot) noexcept
+            : ctrl_(ctrl), slot_(slot)
+            {
+            }
+
+            void skip_empty_or_deleted() noexcept
+            {
+                // the sentinel after the last slot stops this
+                while (*ctrl_ < flat_sentinel)
+                {
+                    ++ctrl_;
+                    ++slot_;
+                }
+            }
+
+            const flat_ctrl* ctrl_ = nullptr;
+            slot_type* slot_ = nullptr;
+        };
+
+        /**
+         * \brief The open addressing table behind flat_map and flat_set
+         *
+         * Policy defines the exposed value_type, the slot_type actually stored, how to construct,
+         * destroy and move from a slot, and how to get the value_type and the key_type from it.
+         */
+        template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+        class flat_table
+        {
+            using allocator_traits = typename std::allocator_traits<
+                Allocator>::template rebind_traits<typename Policy::slot_type>;
+            using slot_allocator = typename allocator_traits::allocator_type;
+            using ctrl_allocator =
+                typename allocator_traits::template rebind_alloc<flat_ctrl>;
+            using ctrl_allocator_traits = std::allocator_traits<ctrl_allocator>;
+            using group = flat_group;
+
+        public:
+            using key_type = typename Policy::key_type;
+            using value_type = typename Policy::value_type;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using hasher = Hash;
+            using key_equal = KeyEqual;
+            using allocator_type = Allocator;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+            using iterator = flat_iterator<flat_table, false>;
+            using const_iterator = flat_iterator<flat_table, true>;
+
+            static constexpr bool const_values = Policy::const_values;
+            using policy_type = Policy;
+            using slot_type = typename Policy::slot_type;
+
+            flat_table() noexcept(std::is_nothrow_default_constructible<Hash>::value&&
+                                      std::is_nothrow_default_constructible<KeyEqual>::value&&
+                                          std::is_nothrow_default_constructible<Allocator>::value)
+            {
+            }
+
+            explicit flat_table(size_type bucket_count, const Hash& hash = Hash(),
+                                const KeyEqual& equal = KeyEqual(),
+                                const Allocator& alloc = Allocator())
+            : hash_(hash), equal_(equal), allocator_(alloc)
+            {
+                reserve(bucket_count);
+            }
+
+            explicit flat_table(const Allocator& alloc) : allocator_(alloc)
+            {
+            }
+
+            flat_table(const flat_table& other)
+            : flat_table(other, allocator_traits::select_on_container_copy_construction(
+                                    other.allocator_))
+            {
+            }
+
+            flat_table(const flat_table& other, const Allocator& alloc)
+            : hash_(other.hash_), equal_(other.equal_), allocator_(alloc)
+            {
+                reserve(other.size_);
+
+                for (const auto& value : other)
+                {
+                    insert_new(hash_of(Policy::key(value)), value);
+                }
+            }
+
+            flat_table(flat_table&& other) noexcept
+            : hash_(std::move(other.hash_)), equal_(std::move(other.equal_)),
+              allocator_(std::move(other.allocator_))
+            {
+                steal(other);
+            }
+
+            flat_table& operator=(const flat_table& other)
+            {
+                if (this != &other)
+                {
+                    using propagate =
+                        typename allocator_traits::propagate_on_container_copy_assignment;
+
+                    flat_table copy(other, propagate::value ? other.allocator_ : allocator_);
+
+                    hash_ = std::move(copy.hash_);
+                    equal_ = std::move(copy.equal_);
+                    take(copy, propagate());
+                }
+
+                return *this;
+            }
+
+            flat_table& operator=(flat_table&& other) noexcept(
+                allocator_traits::propagate_on_container_move_assignment::value ||
+                allocator_traits::is_always_equal::value)
+            {
+                if (this != &other)
+                {
+                    using propagate =
+                        typename allocator_traits::propagate_on_container_move_assignment;
+
+                    hash_ = std::move(other.hash_);
+                    equal_ = std::move(other.equal_);
+                    move_assign(other, propagate());
+                }
+
+                return *this;
+            }
+
+            ~flat_table()
+            {
+                destroy();
+            }
+
+            void swap(flat_table& other) noexcept
+            {
+                using std::swap;
+                swap(hash_, other.hash_);
+                swap(equal_, other.equal_);
+                swap_allocator(other, typename allocator_traits::propagate_on_container_swap());
+                swap(ctrl_, other.ctrl_);
+                swap(slots_, other.slots_);
+                swap(size_, other.size_);
+                swap(capacity_, other.capacity_);
+                swap(growth_left_, other.growth_left_);
+            }
+
+            iterator begin() noexcept
+            {
+                iterator it(ctrl_, slots_);
+                it.skip_empty_or_deleted();
+                return it;
+            }
+
+            iterator end() noexcept
+            {
+                return iterator(ctrl_ + capacity_, slots_ + capacity_);
+            }
+
+            const_iterator begin() const noexcept
+            {
+                return const_cast<flat_table*>(this)->begin();
+            }
+
+            const_iterator end() const noexcept
+            {
+                return const_cast<flat_table*>(this)->end();
+            }
+
+            const_iterator cbegin() const noexcept
+            {
+                return begin();
+            }
+
+            const_iterator cend() const noexcept
+            {
+                return end();
+            }
+
+            bool empty() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            size_type size() const noexcept
+            {
+                return size_;
+            }
+
+            size_type bucket_count() const noexcept
+            {
+                return capacity_;
+            }
+
+            float load_factor() const noexcept
+            {
+                return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / capacity_;
+            }
+
+            float max_load_factor() const noexcept
+            {
+                return 7.0f / 8.0f;
+            }
+
+            /// makes room for count elements without further rehashing
+            void reserve(size_type count)
+            {
+                if (count > size_ + growth_left_)
+                {
+                    resize(normalize_capacity(growth_to_capacity(count)));
+                }
+            }
+
+            void rehash(size_type count)
+            {
+                if (count == 0 && size_ == 0)
+                {
+                    destroy();
+                    reset_empty();
+                    return;
+                }
+
+                resize(normalize_capacity(std::max(count, growth_to_capacity(size_))));
+            }
+
+            void clear() noexcept
+            {
+                if (capacity_ == 0)
+                {
+                    return;
+                }
+
+                destroy_values();
+                reset_ctrl();
+                size_ = 0;
+                growth_left_ = capacity_to_growth(capacity_);
+            }
+
+            iterator find(const key_type& key)
+            {
+                return find_impl(key, hash_of(key));
+            }
+
+            const_iterator find(const key_type& key) const
+            {
+                return const_cast<flat_table*>(this)->find_impl(key, hash_of(key));
+            }
+
+            /// finds key, whose hash_of() was computed before
+            iterator find(const key_type& key, size_type hash)
+            {
+                return find_impl(key, hash);
+            }
+
+            const_iterator find(const key_type& key, size_type hash) const
+            {
+                return const_cast<flat_table*>(this)->find_impl(key, hash);
+            }
+
+            /// finds a key of another type, needs a transparent hasher and key_equal
+            template <typename K, typename H = Hash, typename E = KeyEqual,
+                      typename = typename H::is_transparent, typename = typename E::is_transparent>
+            iterator find(const K& key)
+            {
+                return find_impl(key, hash_of(key));
+            }
+
+            template <typename K, typename H = Hash, typename E = KeyEqual,
+                      typename = typename H::is_transparent, typename = typename E::is_transparent>
+            const_iterator find(const K& key) const
+            {
+                return const_cast<flat_table*>(this)->find_impl(key, hash_of(key));
+            }
+
+            bool contains(const key_type& key) const
+            {
+                return find(key) != end();
+            }
+
+            template <typename K, typename H = Hash, typename E = KeyEqual,
+                      typename = typename H::is_transparent, typename = typename E::is_transparent>
+            bool contains(const K& key) const
+            {
+                return find<K>(key) != end();
+            }
+
+            size_type count(const key_type& key) const
+            {
+                return contains(key) ? 1 : 0;
+            }
+
+            template <typename K, typename H = Hash, typename E = KeyEqual,
+                      typename = typename H::is_transparent, typename = typename E::is_transparent>
+            size_type count(const K& key) const
+            {
+                return contains<K>(key) ? 1 : 0;
+            }
+
+            iterator erase(const_iterator pos)
+            {
+                iterator it(pos.ctrl_, pos.slot_);
+                erase_at(static_cast<size_type>(it.ctrl_ - ctrl_));
+                ++it;
+                return it;
+            }
+
+            iterator erase(iterator pos)
+            {
+                return erase(const_iterator(pos));
+            }
+
+            size_type erase(const key_type& key)
+            {
+                return erase(key, hash_of(key));
+            }
+
+            /// erases key, whose hash_of() was computed before
+            size_type erase(const key_type& key, size_type hash)
+            {
+                auto it = find_impl(key, hash);
+
+                if (it == end())
+                {
+                    return 0;
+                }
+
+                erase_at(static_cast<size_type>(it.ctrl_ - ctrl_));
+                return 1;
+            }
+
+            hasher hash_function() const
+            {
+                return hash_;
+            }
+
+            /// the hash of key as used by the table, for the overloads taking a precomputed hash
+            template <typename K>
+            size_type hash_of(const K& key) const
+            {
+                return flat_hash(hash_, key);
+            }
+
+            key_equal key_eq() const
+            {
+                return equal_;
+            }
+
+            allocator_type get_allocator() const noexcept
+            {
+                return allocator_type(allocator_);
+            }
+
+            friend bool operator==(const flat_table& a, const flat_table& b)
+            {
+                if (a.size() != b.size())
+                {
+                    return false;
+                }
+
+                for (const auto& value : a)
+                {
+                    auto it = b.find(Policy::key(value));
+
+                    if (it == b.end() || !Policy::equal_values(*it, value))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            friend bool operator!=(const flat_table& a, const flat_table& b)
+            {
+                return !(a == b);
+            }
+
+        protected:
+            /// finds key or constructs a new value with args, if it is missing
+            template <typename K, typename... Args>
+            std::pair<iterator, bool> emplace_key(const K& key, Args&&... args)
+            {
+                return emplace_hashed(hash_of(key), key, std::forward<Args>(args)...);
+            }
+
+            template <typename K, typename... Args>
+            std::pair<iterator, bool> emplace_hashed(size_type hash, const K& key, Args&&... args)
+            {
+                auto it = find_impl(key, hash);
+
+                if (it != end())
+                {
+                    return { it, false };
+                }
+
+                return { insert_new(hash, std::forward<Args>(args)...), true };
+            }
+
+            template <typename K>
+            iterator find_impl(const K& key, size_type hash)
+            {
+                auto h2 = static_cast<flat_ctrl>(hash & 0x7f);
+                auto offset = (hash >> 7) & capacity_;
+
+                for (size_type step = group::width;; step += group::width)
+                {
+                    group g(ctrl_ + offset);
+
+                    for (auto match = g.match(h2); match; match.clear_lowest())
+                    {
+                        auto index = (offset + match.lowest()) & capacity_;
+
+                        if (equal_(key_of(slots_[index]), key))
+                        {
+                            return iterator(ctrl_ + index, slots_ + index);
+                        }
+                    }
+
+                    if (g.match_empty())
+                    {
+                        return end();
+                    }
+
+                    // triangular numbers of groups visit every group in power of two tables
+                    offset = (offset + step) & capacity_;
+                }
+            }
+
+        private:
+            static const key_type& key_of(const slot_type& slot) noexcept
+            {
+                return Policy::key(Policy::value(slot));
+            }
+
+            // adopts the storage of other, whose allocator is either propagated or equal to ours
+            void take(flat_table& other, std::true_type) noexcept
+            {
+                destroy();
+                allocator_ = std::move(other.allocator_);
+                steal(other);
+            }
+
+            void take(flat_table& other, std::false_type) noexcept
+            {
+                destroy();
+                steal(other);
+            }
+
+            void move_assign(flat_table& other, std::true_type) noexcept
+            {
+                take(other, std::true_type());
+            }
+
+            void move_assign(flat_table& other, std::false_type)
+            {
+                if (allocator_ == other.allocator_)
+                {
+                    take(other, std::false_type());
+                    return;
+                }
+
+                // the storage of other belongs to another allocator, so we can only move values
+                clear();
+                reserve(other.size_);
+
+                for (size_type i = 0; i < other.capacity_; i++)
+                {
+                    if (other.ctrl_[i] >= 0)
+                    {
+                        insert_new(hash_of(key_of(other.slots_[i])), Policy::move(other.slots_[i]));
+                    }
+                }
+
+                other.clear();
+            }
+
+            void swap_allocator(flat_table& other, std::true_type) noexcept
+            {
+                using std::swap;
+                swap(allocator_, other.allocator_);
+            }
+
+            void swap_allocator(flat_table&, std::false_type) noexcept
+            {
+                // like for std containers, swapping tables with unequal allocators is undefined
+            }
+
+            template <typename... Args>
+            iterator insert_new(size_type hash, Args&&... args)
+            {
+                auto index = prepare_insert(hash);
+
+                try
+                {
+                    Policy::construct(allocator_, slots_ + index, std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    set_ctrl(index, flat_deleted);
+                    --size_;
+                    throw;
+                }
+
+                return iterator(ctrl_ + index, slots_ + index);
+            }
+
+            static size_type capacity_to_growth(size_type capacity) noexcept
+            {
+                // a maximal load factor of 7/8, but small tables keep one empty slot
+                if (group::width == 8 && capacity == 7)
+                {
+                    return 6;
+                }
+
+                return capacity - capacity / 8;
+            }
+
+            static size_type growth_to_capacity(size_type growth) noexcept
+            {
+                if (group::width == 8 && growth == 7)
+                {
+                    return 8;
+                }
+
+                return growth + (growth == 0 ? 0 : (growth - 1) / 7);
+            }
+
+            // capacities are 2^n - 1, so they double as the mask for the probing
+            static size_type normalize_capacity(size_type count) noexcept
+            {
+                size_type capacity = 1;
+
+                while (capacity < count)
+                {
+                    capacity = capacity * 2 + 1;
+                }
+
+                return capacity;
+            }
+
+            size_type find_first_non_full(size_type hash) const noexcept
+            {
+                auto offset = (hash >> 7) & capacity_;
+
+                for (size_type step = group::width;; step += group::width)
+                {
+                    auto match = group(ctrl_ + offset).match_empty_or_deleted();
+
+                    if (match)
+                    {
+                        return (offset + match.lowest()) & capacity_;
+                    }
+
+                    offset = (offset + step) & capacity_;
+                }
+            }
+
+            /// returns the index of a slot for a new value with the given hash
+            size_type prepare_insert(size_type hash)
+            {
+                auto index = find_first_non_full(hash);
+
+                if (growth_left_ == 0 && ctrl_[index] != flat_deleted)
+                {
+                    grow();
+                    index = find_first_non_full(hash);
+                }
+
+                ++size_;
+                growth_left_ -= ctrl_[index] == flat_empty ? 1 : 0;
+                set_ctrl(index, static_cast<flat_ctrl>(hash & 0x7f));
+
+                return index;
+            }
+
+            void grow()
+            {
+                if (capacity_ == 0)
+                {
+                    resize(1);
+                }
+                else if (size_ <= capacity_to_growth(capacity_) / 2)
+                {
+                    // mostly deleted slots, so get rid of those instead of growing
+                    resize(capacity_);
+                }
+                else
+                {
+                    resize(capacity_ * 2 + 1);
+                }
+            }
+
+            void resize(size_type capacity)
+            {
+                auto old_ctrl = ctrl_;
+                auto old_slots = slots_;
+                auto old_capacity = capacity_;
+
+                allocate(capacity);
+
+                for (size_type i = 0; i < old_capacity; i++)
+                {
+                    if (old_ctrl[i] >= 0)
+                    {
+                        auto hash = hash_of(key_of(old_slots[i]));
+                        auto index = find_first_non_full(hash);
+
+                        set_ctrl(index, static_cast<flat_ctrl>(hash & 0x7f));
+                        Policy::construct(allocator_, slots_ + index, Policy::move(old_slots[i]));
+                        Policy::destroy(allocator_, old_slots + i);
+                    }
+                }
+
+                growth_left_ -= size_;
+
+                if (old_capacity != 0)
+                {
+                    deallocate(old_ctrl, old_slots, old_capacity);
+                }
+            }
+
+            void allocate(size_type capacity)
+            {
+                ctrl_allocator ctrl_alloc(allocator_);
+
+                auto ctrl = ctrl_allocator_traits::allocate(ctrl_alloc, capacity + group::width);
+
+                try
+                {
+                    slots_ = allocator_traits::allocate(allocator_, capacity);
+                }
+                catch (...)
+                {
+                    ctrl_allocator_traits::deallocate(ctrl_alloc, ctrl, capacity + group::width);
+                    throw;
+                }
+
+                ctrl_ = ctrl;
+                capacity_ = capacity;
+                growth_left_ = capacity_to_growth(capacity);
+                reset_ctrl();
+            }
+
+            void deallocate(const flat_ctrl* ctrl, slot_type* slots, size_type capacity) noexcept
+            {
+                ctrl_allocator ctrl_alloc(allocator_);
+
+                ctrl_allocator_traits::deallocate(ctrl_alloc, const_cast<flat_ctrl*>(ctrl),
+                                                  capacity + group::width);
+                allocator_traits::deallocate(allocator_, slots, capacity);
+            }
+
+            void reset_ctrl() noexcept
+            {
+                auto ctrl = const_cast<flat_ctrl*>(ctrl_);
+
+                std::memset(ctrl, flat_empty, capacity_ + group::width);
+                ctrl[capacity_] = flat_sentinel;
+            }
+
+            // The first width - 1 control bytes are mirrored after the sentinel, so a group can be
+            // loaded starting at any slot.
+            void set_ctrl(size_type index, flat_ctrl h) noexcept
+            {
+                auto ctrl = const_cast<flat_ctrl*>(ctrl_);
+
+                ctrl[index] = h;
+                ctrl[((index - (group::width - 1)) & capacity_) +
+                     ((group::width - 1) & capacity_)] = h;
+            }
+
+            void erase_at(size_type index) noexcept
+            {
+                Policy::destroy(allocator_, slots_ + index);
+
+                // the slot might be part of a probing sequence, so it can't become empty again
+                set_ctrl(index, flat_deleted);
+                --size_;
+            }
+
+            void destroy_values() noexcept
+            {
+                for (size_type i = 0; i < capacity_; i++)
+                {
+                    if (ctrl_[i] >= 0)
+                    {
+                        Policy::destroy(allocator_, slots_ + i);
+                    }
+                }
+            }
+
+            void destroy() noexcept
+            {
+                if (capacity_ != 0)
+                {
+                    destroy_values();
+                    deallocate(ctrl_, slots_, capacity_);
+                }
+            }
+
+            void reset_empty() noexcept
+            {
+                ctrl_ = flat_empty_group();
+                slots_ = nullptr;
+                size_ = 0;
+                capacity_ = 0;
+                growth_left_ = 0;
+            }
+
+            void steal(flat_table& other) noexcept
+            {
+                ctrl_ = other.ctrl_;
+                slots_ = other.slots_;
+                size_ = other.size_;
+                capacity_ = other.capacity_;
+                growth_left_ = other.growth_left_;
+
+                other.reset_empty();
+            }
+
+            Hash hash_;
+            KeyEqual equal_;
+            slot_allocator allocator_;
+
+            const flat_ctrl* ctrl_ = flat_empty_group();
+            slot_type* slots_ = nullptr;
+            size_type size_ = 0;
+            size_type capacity_ = 0;
+            size_type growth_left_ = 0;
+        };
+    } // namespace detail
+} // namespace lang
+} // namespace nitro
@@ -28,15 +28,21 @@
 
 #pragma once
 
-#include <nitro/meta/std_hashable.hpp>
+#include <nitro/lang/string_ref.hpp>
 
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if __cplusplus >= 201703L
+#include <string_view>
 #include <variant>
 #endif
 
@@ -50,9 +56,169 @@ namespace lang
     {
     };
 
+    namespace detail
+    {
+        // The secrets and mixing functions of wyhash (final version 4), see
+        // https://github.com/wangyi-fudan/wyhash
+        constexpr std::uint64_t hash_secret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                                   0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+        // 64x64 -> 128 bit multiplication, a gets the low and b the high half
+        constexpr void hash_multiply(std::uint64_t& a, std::uint64_t& b)
+        {
+#ifdef __SIZEOF_INT128__
+            __extension__ using uint128 = unsigned __int128;
+
+            uint128 r = static_cast<uint128>(a) * b;
+            a = static_cast<std::uint64_t>(r);
+            b = static_cast<std::uint64_t>(r >> 64);
+#else
+            std::uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffff, lb = b & 0xffffffff;
+            std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            std::uint64_t t = rl + (rm0 << 32);
+            std::uint64_t c = t < rl;
+            std::uint64_t lo = t + (rm1 << 32);
+            c += lo < t;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+        }
+
+        constexpr std::uint64_t hash_mix(std::uint64_t a, std::uint64_t b)
+        {
+            hash_multiply(a, b);
+            return a ^ b;
+        }
+
+        // Little endian reads, compilers turn these into plain loads. Unlike memcpy, this also
+        // works in constant expressions.
+        template <typename Byte>
+        constexpr std::uint64_t hash_read8(const Byte* p)
+        {
+            return static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[1])) << 8 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[2])) << 16 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[3])) << 24 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[4])) << 32 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[5])) << 40 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[6])) << 48 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[7])) << 56;
+        }
+
+        template <typename Byte>
+        constexpr std::uint64_t hash_read4(const Byte* p)
+        {
+            return static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[1])) << 8 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[2])) << 16 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[3])) << 24;
+        }
+
+        template <typename Byte>
+        constexpr std::uint64_t hash_read3(const Byte* p, std::size_t size)
+        {
+            return static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[size >> 1])) << 8 |
+                   static_cast<std::uint64_t>(static_cast<unsigned char>(p[size - 1]));
+        }
+    } // namespace detail
+
+    /**
+     * \brief Hashes size bytes starting at data
+     *
+     * This is wyhash, which processes 48 bytes per iteration in three independent lanes. For
+     * pointers to char types, this works in constant expressions.
+     */
+    template <typename Byte>
+    constexpr std::enable_if_t<std::is_integral<Byte>::value && sizeof(Byte) == 1, std::uint64_t>
+    hash_bytes(const Byte* data, std::size_t size, std::uint64_t seed = 0)
+    {
+        using detail::hash_mix;
+        using detail::hash_secret;
+
+        const Byte* p = data;
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+
+        seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+
+        if (size <= 16)
+        {
+            if (size >= 4)
+            {
+                a = (detail::hash_read4(p) << 32) | detail::hash_read4(p + ((size >> 3) << 2));
+                b = (detail::hash_read4(p + size - 4) << 32) |
+                    detail::hash_read4(p + size - 4 - ((size >> 3) << 2));
+            }
+            else if (size > 0)
+            {
+                a = detail::hash_read3(p, size);
+            }
+        }
+        else
+        {
+            std::size_t i = size;
+
+            if (i > 48)
+            {
+                std::uint64_t seed1 = seed;
+                std::uint64_t seed2 = seed;
+
+                do
+                {
+                    seed = hash_mix(detail::hash_read8(p) ^ hash_secret[1],
+                                    detail::hash_read8(p + 8) ^ seed);
+                    seed1 = hash_mix(detail::hash_read8(p + 16) ^ hash_secret[2],
+                                     detail::hash_read8(p + 24) ^ seed1);
+                    seed2 = hash_mix(detail::hash_read8(p + 32) ^ hash_secret[3],
+                                     detail::hash_read8(p + 40) ^ seed2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (i > 16)
+            {
+                seed = hash_mix(detail::hash_read8(p) ^ hash_secret[1],
+                                detail::hash_read8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+
+            a = detail::hash_read8(p + i - 16);
+            b = detail::hash_read8(p + i - 8);
+        }
+
+        a ^= hash_secret[1];
+        b ^= seed;
+        detail::hash_multiply(a, b);
+
+        return hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]);
+    }
+
+    inline std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed = 0)
+    {
+        return hash_bytes(static_cast<const unsigned char*>(data), size, seed);
+    }
+
+    /**
+     * \brief Hashes a 64 bit integer, unlike std::hash, every input bit affects every output bit
+     */
+    constexpr std::uint64_t hash_int(std::uint64_t value, std::uint64_t seed = 0)
+    {
+        return detail::hash_mix(value ^ seed ^ detail::hash_secret[0],
+                                detail::hash_mix(seed ^ detail::hash_secret[1],
+                                                 detail::hash_secret[2]));
+    }
+
 #if __cplusplus >= 201703L
     template <typename... T>
     inline auto hash(const std::variant<T...>& t);
+
+    template <typename Char, typename Traits>
+    inline std::size_t hash(const std::basic_string_view<Char, Traits>& s);
 #endif
 
     template <typename... T>
@@ -62,9 +228,25 @@ namespace lang
     inline auto hash(const std::pair<T, U>& t);
 
     template <typename T>
-    inline typename std::enable_if<meta::std_hashable<T>::value, std::size_t>::type
+    inline std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value, std::size_t>
     hash(const T& t);
 
+    template <typename T>
+    inline std::enable_if_t<std::is_floating_point<T>::value, std::size_t> hash(const T& t);
+
+    template <typename Char, typename Traits, typename Allocator>
+    inline std::size_t hash(const std::basic_string<Char, Traits, Allocator>& s);
+
+    inline std::size_t hash(const char* s);
+
+    inline std::size_t hash(const string_ref& s);
+
+    template <typename T, typename Allocator>
+    inline std::size_t hash(const std::vector<T, Allocator>& v);
+
+    template <typename T, std::size_t N>
+    inline std::size_t hash(const std::array<T, N>& a);
+
     template <typename T>
     inline typename std::enable_if<std::is_base_of<hashable, T>::value, std::size_t>::type
     hash(const T& t);
@@ -80,7 +262,115 @@ namespace lang
         template <typename HashT>
         inline void hash_combine_impl(HashT& seed, HashT value)
         {
-            seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed = static_cast<HashT>(
+                hash_mix(static_cast<std::uint64_t>(seed) ^ hash_secret[0],
+                         static_cast<std::uint64_t>(value) ^ hash_secret[1]));
+        }
+
+        inline std::uint64_t hash_float(float f)
+        {
+            // -0.0 == 0.0, so they must have the same hash
+            f = f == 0 ? 0 : f;
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return hash_int(bits);
+        }
+
+        inline std::uint64_t hash_float(double d)
+        {
+            d = d == 0 ? 0 : d;
+
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return hash_int(bits);
+        }
+
+        inline std::uint64_t hash_float(long double d)
+        {
+            // the representation of long double may contain padding bytes
+            return hash_int(std::hash<long double>()(d));
+        }
+
+        // Types, which can be hashed by their bits. Floating point values need a normalized -0.0
+        // first, long double may have padding.
+        template <typename T>
+        struct is_packable
+        : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value ||
+                                           std::is_same<T, float>::value ||
+                                           std::is_same<T, double>::value>
+        {
+        };
+
+        template <typename... T>
+        struct all_packable;
+
+        template <>
+        struct all_packable<> : std::true_type
+        {
+        };
+
+        template <typename T, typename... U>
+        struct all_packable<T, U...>
+        : std::integral_constant<bool, is_packable<std::decay_t<T>>::value &&
+                                           all_packable<U...>::value>
+        {
+        };
+
+        template <typename T>
+        inline std::enable_if_t<!std::is_floating_point<T>::value, std::uint64_t> hash_pack(T t)
+        {
+            return static_cast<std::uint64_t>(t);
+        }
+
+        inline std::uint64_t hash_pack(float f)
+        {
+            f = f == 0 ? 0 : f;
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return bits;
+        }
+
+        inline std::uint64_t hash_pack(double d)
+        {
+            d = d == 0 ? 0 : d;
+
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return bits;
+        }
+
+        // Widens all elements to 64 bit words and hashes those in one pass. Words instead of
+        // tightly packed bytes keep the reads aligned with the writes before, which is much
+        // faster than reading across several small writes.
+        template <typename... T, std::size_t... I>
+        inline std::size_t hash_packed(const std::tuple<T...>& t, std::index_sequence<I...>)
+        {
+            std::uint64_t words[sizeof...(T) == 0 ? 1 : sizeof...(T)] = {
+                hash_pack(std::get<I>(t))...
+            };
+
+            return static_cast<std::size_t>(
+                hash_bytes(static_cast<const void*>(words), sizeof...(T) * sizeof(std::uint64_t)));
+        }
+
+        template <typename T>
+        inline std::size_t hash_range(const T* data, std::size_t size)
+        {
+            if (std::is_integral<T>::value || std::is_enum<T>::value)
+            {
+                return hash_bytes(static_cast<const void*>(data), size * sizeof(T));
+            }
+
+            std::size_t seed = hash_int(size);
+
+            for (std::size_t i = 0; i < size; i++)
+            {
+                hash_combine_impl(seed, static_cast<std::size_t>(hash(data[i])));
+            }
+
+            return seed;
         }
 
         template <std::size_t I, typename T>
@@ -93,10 +383,24 @@ namespace lang
         inline typename std::enable_if<(I < std::tuple_size<T>::value), void>::type
         hash_combine_tuple(std::size_t& seed, const T& v)
         {
-            hash_combine_impl(seed, hash(std::get<I>(v)));
+            hash_combine_impl(seed, static_cast<std::size_t>(hash(std::get<I>(v))));
             hash_combine_tuple<I + 1>(seed, v);
         }
 
+        template <typename... T>
+        inline std::size_t hash_tuple(const std::tuple<T...>& t, std::true_type)
+        {
+            return hash_packed(t, std::index_sequence_for<T...>());
+        }
+
+        template <typename... T>
+        inline std::size_t hash_tuple(const std::tuple<T...>& t, std::false_type)
+        {
+            std::size_t seed = 0;
+            hash_combine_tuple<0>(seed, t);
+            return seed;
+        }
+
 #if __cplusplus >= 201703L
         template <std::size_t I, typename T>
         inline typename std::enable_if_t<(I == std::variant_size<T>::value), void>
@@ -131,17 +435,13 @@ namespace lang
     template <typename... T>
     inline auto hash(const std::tuple<T...>& t)
     {
-        std::size_t seed = 0;
-        detail::hash_combine_tuple<0>(seed, t);
-        return seed;
+        return detail::hash_tuple(t, detail::all_packable<T...>());
     }
 
     template <typename T, typename U>
     inline auto hash(const std::pair<T, U>& t)
     {
-        std::size_t seed = hash(t.first);
-        detail::hash_combine_impl(seed, hash(t.second));
-        return seed;
+        return hash(std::tie(t.first, t.second));
     }
 
 #if __cplusplus >= 201703L
@@ -169,9 +469,56 @@ namespace lang
     }
 
     template <typename T>
-    inline typename std::enable_if<meta::std_hashable<T>::value, std::size_t>::type hash(const T& t)
+    inline std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value, std::size_t>
+    hash(const T& t)
+    {
+        return static_cast<std::size_t>(hash_int(static_cast<std::uint64_t>(t)));
+    }
+
+    template <typename T>
+    inline std::enable_if_t<std::is_floating_point<T>::value, std::size_t> hash(const T& t)
+    {
+        return static_cast<std::size_t>(detail::hash_float(t));
+    }
+
+    template <typename Char, typename Traits, typename Allocator>
+    inline std::size_t hash(const std::basic_string<Char, Traits, Allocator>& s)
+    {
+        return static_cast<std::size_t>(
+            hash_bytes(static_cast<const void*>(s.data()), s.size() * sizeof(Char)));
+    }
+
+#if __cplusplus >= 201703L
+    template <typename Char, typename Traits>
+    inline std::size_t hash(const std::basic_string_view<Char, Traits>& s)
+    {
+        return static_cast<std::size_t>(
+            hash_bytes(static_cast<const void*>(s.data()), s.size() * sizeof(Char)));
+    }
+#endif
+
+    /// hashes the characters, so it gives the same hash as the equal std::string
+    inline std::size_t hash(const char* s)
+    {
+        return s == nullptr ? hash(std::string()) :
+                              static_cast<std::size_t>(hash_bytes(s, std::strlen(s)));
+    }
+
+    inline std::size_t hash(const string_ref& s)
+    {
+        return static_cast<std::size_t>(hash_bytes(s.data(), s.size()));
+    }
+
+    template <typename T, typename Allocator>
+    inline std::size_t hash(const std::vector<T, Allocator>& v)
     {
-        return std::hash<T>()(t);
+        return detail::hash_range(v.data(), v.size());
+    }
+
+    template <typename T, std::size_t N>
+    inline std::size_t hash(const std::array<T, N>& a)
+    {
+        return detail::hash_range(a.data(), N);
     }
 
     template <typename T>
@@ -184,10 +531,173 @@ namespace lang
     template <typename T>
     struct hash_wrapper
     {
+        hash_wrapper() = default;
+
+        /// a seeded hash_wrapper gives different hashes, e.g., against hash flooding
+        explicit hash_wrapper(std::uint64_t seed) : seed_(seed)
+        {
+        }
+
         auto operator()(const T& t) const
         {
-            return hash(t);
+            if (seed_ == 0)
+            {
+                return static_cast<std::size_t>(hash(t));
+            }
+
+            return static_cast<std::size_t>(hash_int(hash(t), seed_));
+        }
+
+    private:
+        std::uint64_t seed_ = 0;
+    };
+
+    namespace detail
+    {
+        // all string types are hashed and compared as the same characters
+        struct string_chars
+        {
+            const char* data;
+            std::size_t size;
+        };
+
+        template <typename Traits, typename Allocator>
+        inline string_chars as_string_chars(const std::basic_string<char, Traits, Allocator>& s)
+        {
+            return { s.data(), s.size() };
+        }
+
+#if __cplusplus >= 201703L
+        template <typename Traits>
+        inline string_chars as_string_chars(const std::basic_string_view<char, Traits>& s)
+        {
+            return { s.data(), s.size() };
+        }
+#endif
+
+        inline string_chars as_string_chars(const char* s)
+        {
+            return { s, s == nullptr ? 0 : std::strlen(s) };
         }
+
+        inline string_chars as_string_chars(const string_ref& s)
+        {
+            return { s.data(), s.size() };
+        }
+    } // namespace detail
+
+    /**
+     * \brief Transparent hash for std::string, std::string_view, lang::string_ref and const char*
+     *
+     * Equal strings have the same hash regardless of their type, so containers using string_hash
+     * and string_equal can be searched without building a temporary std::string.
+     */
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        string_hash() = default;
+
+        explicit string_hash(std::uint64_t seed) : seed_(seed)
+        {
+        }
+
+        template <typename String>
+        auto operator()(const String& s) const
+            -> decltype(detail::as_string_chars(s), std::size_t())
+        {
+            auto chars = detail::as_string_chars(s);
+            auto result = hash_bytes(chars.data, chars.size);
+
+            if (seed_ == 0)
+            {
+                return static_cast<std::size_t>(result);
+            }
+
+            return static_cast<std::size_t>(hash_int(result, seed_));
+        }
+
+    private:
+        std::uint64_t seed_ = 0;
+    };
+
+    /// transparent equality for the same string types as string_hash
+    struct string_equal
+    {
+        using is_transparent = void;
+
+        template <typename A, typename B>
+        auto operator()(const A& a, const B& b) const
+            -> decltype(detail::as_string_chars(a), detail::as_string_chars(b), bool())
+        {
+            auto left = detail::as_string_chars(a);
+            auto right = detail::as_string_chars(b);
+
+            return left.size == right.size &&
+                   (left.size == 0 || std::memcmp(left.data, right.data, left.size) == 0);
+        }
+    };
+
+    template <typename Traits, typename Allocator>
+    struct hash_wrapper<std::basic_string<char, Traits, Allocator>> : string_hash
+    {
+        using string_hash::string_hash;
+    };
+
+    template <>
+    struct hash_wrapper<string_ref> : string_hash
+    {
+        using string_hash::string_hash;
+    };
+
+#if __cplusplus >= 201703L
+    template <typename Traits>
+    struct hash_wrapper<std::basic_string_view<char, Traits>> : string_hash
+    {
+        using string_hash::string_hash;
     };
+#endif
+
+    namespace detail
+    {
+        // the key comparison used with hash_wrapper, transparent for string keys
+        template <typename Key>
+        struct default_key_equal
+        {
+            using type = std::equal_to<Key>;
+        };
+
+        template <typename Traits, typename Allocator>
+        struct default_key_equal<std::basic_string<char, Traits, Allocator>>
+        {
+            using type = string_equal;
+        };
+
+        template <>
+        struct default_key_equal<string_ref>
+        {
+            using type = string_equal;
+        };
+
+#if __cplusplus >= 201703L
+        template <typename Traits>
+        struct default_key_equal<std::basic_string_view<char, Traits>>
+        {
+            using type = string_equal;
+        };
+#endif
+    } // namespace detail
 } // namespace lang
 } // namespace nitro
+
+namespace std
+{
+template <>
+struct hash<nitro::lang::string_ref>
+{
+    size_t operator()(const nitro::lang::string_ref& s) const
+    {
+        return nitro::lang::hash(s);
+    }
+};
+} // namespace std
@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/arena.hpp>
+#include <nitro/lang/hash.hpp>
+#include <nitro/lang/string_ref.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief A string with its hash, which can be computed at compile time
+     *
+     * Interning a symbol_key skips hashing the string. For literals, the hash can be computed
+     * at compile time, but that is only guaranteed for a constexpr variable, e.g.,
+     * static constexpr symbol_key tag("tag"), or "tag"_sym in another constant expression.
+     * Passed directly, as in intern("tag") or intern("tag"_sym), the string is hashed at run
+     * time, unless the optimizer folds it.
+     */
+    class symbol_key
+    {
+    public:
+        template <std::size_t N>
+        constexpr symbol_key(const char (&str)[N])
+        : data_(str), size_(N - 1), hash_(hash_bytes(str, N - 1))
+        {
+        }
+
+        constexpr symbol_key(const char* data, std::size_t size)
+        : data_(data), size_(size), hash_(hash_bytes(data, size))
+        {
+        }
+
+        symbol_key(string_ref str) : symbol_key(str.data(), str.size())
+        {
+        }
+
+        constexpr const char* data() const noexcept
+        {
+            return data_;
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        constexpr std::uint64_t hash() const noexcept
+        {
+            return hash_;
+        }
+
+    private:
+        const char* data_;
+        std::size_t size_;
+        std::uint64_t hash_;
+    };
+
+    class symbol;
+
+    inline symbol intern(const symbol_key& key);
+
+    namespace detail
+    {
+        // the characters follow the entry, null-terminated
+        struct intern_entry
+        {
+            std::uint64_t hash;
+            std::size_t size;
+            std::uint32_t id;
+
+            const char* data() const noexcept
+            {
+                return reinterpret_cast<const char*>(this + 1);
+            }
+        };
+
+        /**
+         * \brief An append-only table of interned strings
+         *
+         * Lookups of existing strings probe an open addressing table of atomic entry pointers
+         * without locking. Inserting takes a mutex, and the table is replaced by a larger copy,
+         * once it is half full. Old tables, entries and characters are never freed, so readers
+         * can keep using them.
+         */
+        class intern_pool
+        {
+            struct table
+            {
+                explicit table(std::size_t capacity)
+                : mask(capacity - 1), slots(new std::atomic<const intern_entry*>[capacity])
+                {
+                    for (std::size_t i = 0; i < capacity; i++)
+                    {
+                        slots[i].store(nullptr, std::memory_order_relaxed);
+                    }
+                }
+
+                std::size_t mask;
+                std::unique_ptr<std::atomic<const intern_entry*>[]> slots;
+            };
+
+            // ids are mapped to entries by segments of doubling size, which never move
+            static constexpr std::size_t first_segment_size = 1024;
+            static constexpr std::size_t segment_count = 32;
+
+        public:
+            intern_pool() : strings_(64 * 1024)
+            {
+                tables_.emplace_back(new table(2 * first_segment_size));
+                table_.store(tables_.back().get(), std::memory_order_release);
+
+                // the empty string is the default symbol
+                std::lock_guard<std::mutex> lock(mutex_);
+                insert(symbol_key("", 0));
+            }
+
+            intern_pool(const intern_pool&) = delete;
+            intern_pool& operator=(const intern_pool&) = delete;
+
+            std::uint32_t intern(const symbol_key& key)
+            {
+                if (auto entry = find(*table_.load(std::memory_order_acquire), key))
+                {
+                    return entry->id;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                // another thread could have inserted it in the meantime
+                if (auto entry = find(*table_.load(std::memory_order_relaxed), key))
+                {
+                    return entry->id;
+                }
+
+                return insert(key);
+            }
+
+            const intern_entry& entry(std::uint32_t id) const noexcept
+            {
+                auto segment = segment_of(id);
+                return *segments_[segment][id - segment_begin(segment)];
+            }
+
+            std::size_t size() const
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return size_;
+            }
+
+        private:
+            static const intern_entry* find(const table& t, const symbol_key& key)
+            {
+                for (auto index = static_cast<std::size_t>(key.hash()) & t.mask;;
+                     index = (index + 1) & t.mask)
+                {
+                    auto entry = t.slots[index].load(std::memory_order_acquire);
+
+                    if (entry == nullptr)
+                    {
+                        return nullptr;
+                    }
+
+                    if (entry->hash == key.hash() && entry->size == key.size() &&
+                        std::memcmp(entry->data(), key.data(), key.size()) == 0)
+                    {
+                        return entry;
+                    }
+                }
+            }
+
+            static std::size_t segment_of(std::size_t id) noexcept
+            {
+                std::size_t segment = 0;
+
+                for (auto x = id / first_segment_size + 1; x > 1; x >>= 1)
+                {
+                    ++segment;
+                }
+
+                return segment;
+            }
+
+            static std::size_t segment_begin(std::size_t segment) noexcept
+            {
+                return first_segment_size * ((std::size_t(1) << segment) - 1);
+            }
+
+            std::uint32_t insert(const symbol_key& key)
+            {
+                auto id = static_cast<std::uint32_t>(size_);
+                auto segment = segment_of(id);
+
+                if (segment >= segment_count)
+                {
+                    raise("Too many interned strings");
+                }
+
+                if (segments_[segment] == nullptr)
+                {
+                    segments_[segment] = strings_.allocate<const intern_entry*>(
+                        first_segment_size << segment);
+                }
+
+                auto memory = static_cast<char*>(strings_.allocate(
+                    sizeof(intern_entry) + key.size() + 1, alignof(intern_entry)));
+
+                auto entry = new (memory) intern_entry{ key.hash(), key.size(), id };
+                auto chars = memory + sizeof(intern_entry);
+                if (key.size() > 0)
+                {
+                    std::memcpy(chars, key.data(), key.size());
+                }
+                chars[key.size()] = '\0';
+
+                segments_[segment][id - segment_begin(segment)] = entry;
+                ++size_;
+
+                auto current = table_.load(std::memory_order_relaxed);
+
+                if (2 * size_ > current->mask + 1)
+                {
+                    grow(2 * (current->mask + 1));
+                }
+                else
+                {
+                    publish(*current, entry);
+                }
+
+                return id;
+            }
+
+            void grow(std::size_t capacity)
+            {
+                tables_.emplace_back(new table(capacity));
+                auto& bigger = *tables_.back();
+
+                for (std::uint32_t id = 0; id < size_; id++)
+                {
+                    publish(bigger, &entry(id));
+                }
+
+                table_.store(&bigger, std::memory_order_release);
+            }
+
+            static void publish(table& t, const intern_entry* entry)
+            {
+                auto index = static_cast<std::size_t>(entry->hash) & t.mask;
+
+                while (t.slots[index].load(std::memory_order_relaxed) != nullptr)
+                {
+                    index = (index + 1) & t.mask;
+                }
+
+                t.slots[index].store(entry, std::memory_order_release);
+            }
+
+            mutable std::mutex mutex_;
+            std::atomic<table*> table_;
+            std::vector<std::unique_ptr<table>> tables_;
+            const intern_entry** segments_[segment_count] = {};
+            std::size_t size_ = 0;
+            arena strings_;
+        };
+
+        // never destroyed, so symbols stay valid during static destruction
+        inline intern_pool& global_intern_pool()
+        {
+            static intern_pool* pool = new intern_pool();
+            return *pool;
+        }
+    } // namespace detail
+
+    /**
+     * \brief An interned string, which compares and hashes as an integer
+     *
+     * Equal strings are interned to the same symbol. The string of a symbol stays valid until
+     * the end of the program. The default symbol is the empty string.
+     */
+    class symbol : public hashable
+    {
+    public:
+        constexpr symbol() noexcept = default;
+
+        std::uint32_t id() const noexcept
+        {
+            return id_;
+        }
+
+        string_ref str() const noexcept
+        {
+            const auto& entry = detail::global_intern_pool().entry(id_);
+            return { entry.data(), entry.size };
+        }
+
+        const char* c_str() const noexcept
+        {
+            return detail::global_intern_pool().entry(id_).data();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return detail::global_intern_pool().entry(id_).size;
+        }
+
+        bool empty() const noexcept
+        {
+            return id_ == 0;
+        }
+
+        std::size_t hash() const noexcept
+        {
+            return static_cast<std::size_t>(hash_int(id_));
+        }
+
+        friend bool operator==(symbol a, symbol b) noexcept
+        {
+            return a.id_ == b.id_;
+        }
+
+        friend bool operator!=(symbol a, symbol b) noexcept
+        {
+            return a.id_ != b.id_;
+        }
+
+        /// orders by id, i.e., by the time of interning, not alphabetically
+        friend bool operator<(symbol a, symbol b) noexcept
+        {
+            return a.id_ < b.id_;
+        }
+
+        friend std::ostream& operator<<(std::ostream& s, symbol sym)
+        {
+            return s << sym.str();
+        }
+
+    private:
+        friend symbol intern(const symbol_key& key);
+
+        explicit symbol(std::uint32_t id) noexcept : id_(id)
+        {
+        }
+
+        std::uint32_t id_ = 0;
+    };
+
+    /**
+     * \brief Returns the symbol for the string, thread-safe and lock-free, if it was interned
+     * before
+     *
+     * Only a symbol_key skips hashing. To intern a literal on a hot path, keep its key in a
+     * static constexpr variable and pass that.
+     */
+    inline symbol intern(const symbol_key& key)
+    {
+        return symbol(detail::global_intern_pool().intern(key));
+    }
+
+    inline symbol intern(string_ref str)
+    {
+        return intern(symbol_key(str));
+    }
+
+    inline symbol intern(const std::string& str)
+    {
+        return intern(symbol_key(str.data(), str.size()));
+    }
+
+    inline symbol intern(const char* str)
+    {
+        return intern(symbol_key(string_ref(str)));
+    }
+
+#if __cplusplus >= 201703L
+    inline symbol intern(std::string_view str)
+    {
+        return intern(symbol_key(str.data(), str.size()));
+    }
+#endif
+} // namespace lang
+} // namespace nitro
+
+namespace std
+{
+template <>
+struct hash<nitro::lang::symbol>
+{
+    size_t operator()(nitro::lang::symbol s) const noexcept
+    {
+        return s.hash();
+    }
+};
+} // namespace std
+
+constexpr nitro::lang::symbol_key operator""_sym(const char* str, std::size_t size)
+{
+    return nitro::lang::symbol_key(str, size);
+}
@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/detail/queue_event.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief A bounded lock-free queue for any number of producer and consumer threads
+     *
+     * This is the queue of Dmitry Vyukov: every cell has a sequence number, which tells the
+     * producers and consumers, whose turn it is. Claiming a cell is a single CAS on the shared
+     * index, and try_push_n()/try_pop_n() claim as many consecutive cells as possible with one
+     * CAS. The capacity is rounded up to a power of two, but at least 2.
+     *
+     * A claimed cell must be released, or the queue stalls, so T must be nothrow move
+     * constructible. If constructing a T from the arguments may throw, it is constructed before
+     * claiming a cell, so try_emplace() consumes rvalue arguments even if the queue is full. If
+     * writing a popped element to the output throws, try_pop_n() still releases the remaining
+     * claimed cells, but their elements are lost.
+     */
+    template <typename T>
+    class mpmc_queue
+    {
+        static_assert(std::is_nothrow_move_constructible<T>::value &&
+                          std::is_nothrow_destructible<T>::value,
+                      "mpmc_queue requires a nothrow move constructible and destructible T");
+
+        struct cell
+        {
+            std::atomic<std::size_t> sequence;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+            T& value() noexcept
+            {
+                return *reinterpret_cast<T*>(&storage);
+            }
+        };
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        explicit mpmc_queue(size_type capacity)
+        : capacity_(detail::queue_capacity(std::max<size_type>(capacity, 2))),
+          mask_(capacity_ - 1), cells_(new cell[capacity_])
+        {
+            for (size_type i = 0; i < capacity_; i++)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue()
+        {
+            auto head = dequeue_pos_.load(std::memory_order_relaxed);
+            auto tail = enqueue_pos_.load(std::memory_order_relaxed);
+
+            for (; head != tail; ++head)
+            {
+                cells_[head & mask_].value().~T();
+            }
+        }
+
+        size_type capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        /// only exact, if no thread is pushing or popping
+        size_type size() const noexcept
+        {
+            auto head = dequeue_pos_.load(std::memory_order_acquire);
+            auto tail = enqueue_pos_.load(std::memory_order_acquire);
+
+            return tail > head ? std::min(tail - head, capacity_) : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        template <typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+            return try_emplace(nothrow_constructible<Args&&...>(), std::forward<Args>(args)...);
+        }
+
+        bool try_push(const T& value)
+        {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        /// pushes as many of the count elements starting at first as fit, returns that number
+        template <typename InputIt>
+        size_type try_push_n(InputIt first, size_type count)
+        {
+            return try_push_n(first, count, nothrow_constructible<decltype(*first)>());
+        }
+
+        bool try_pop(T& value)
+        {
+            auto pos = claim(dequeue_pos_, 1, 1);
+
+            if (pos.second == 0)
+            {
+                return false;
+            }
+
+            value = take(pos.first);
+
+            not_full_.notify();
+            return true;
+        }
+
+        /// pops up to count elements to out, returns their number
+        template <typename OutputIt>
+        size_type try_pop_n(OutputIt out, size_type count)
+        {
+            auto pos = claim(dequeue_pos_, count, 1);
+            size_type i = 0;
+
+            try
+            {
+                for (; i < pos.second; ++i)
+                {
+                    auto value = take(pos.first + i);
+                    *out = std::move(value);
+                    ++out;
+                }
+            }
+            catch (...)
+            {
+                // cell i is released already, the others must be released as well
+                for (++i; i < pos.second; ++i)
+                {
+                    take(pos.first + i);
+                }
+
+                not_full_.notify();
+                throw;
+            }
+
+            if (pos.second > 0)
+            {
+                not_full_.notify();
+            }
+
+            return pos.second;
+        }
+
+        /// waits for room, if the queue is full
+        template <typename... Args>
+        void emplace(Args&&... args)
+        {
+            emplace(nothrow_constructible<Args&&...>(), std::forward<Args>(args)...);
+        }
+
+        void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        void push(T&& value)
+        {
+            emplace(std::move(value));
+        }
+
+        /// waits for an element, if the queue is empty
+        void pop(T& value)
+        {
+            if (!try_pop(value))
+            {
+                not_empty_.wait_until([this, &value]() { return try_pop(value); });
+            }
+        }
+
+        T pop()
+        {
+            T value;
+            pop(value);
+            return value;
+        }
+
+    private:
+        // a plain bool_constant, so it selects the tagged overloads below
+        template <typename... Args>
+        using nothrow_constructible =
+            std::integral_constant<bool, std::is_nothrow_constructible<T, Args...>::value>;
+
+        template <typename... Args>
+        bool try_emplace(std::true_type, Args&&... args)
+        {
+            auto pos = claim(enqueue_pos_, 1, 0);
+
+            if (pos.second == 0)
+            {
+                return false;
+            }
+
+            auto& c = cells_[pos.first & mask_];
+            new (&c.storage) T(std::forward<Args>(args)...);
+            c.sequence.store(pos.first + 1, std::memory_order_release);
+
+            not_empty_.notify();
+            return true;
+        }
+
+        template <typename... Args>
+        bool try_emplace(std::false_type, Args&&... args)
+        {
+            T value(std::forward<Args>(args)...);
+            return try_emplace(std::true_type(), std::move(value));
+        }
+
+        template <typename InputIt>
+        size_type try_push_n(InputIt first, size_type count, std::true_type)
+        {
+            auto pos = claim(enqueue_pos_, count, 0);
+
+            for (size_type i = 0; i < pos.second; ++i, ++first)
+            {
+                auto& c = cells_[(pos.first + i) & mask_];
+                new (&c.storage) T(*first);
+                c.sequence.store(pos.first + i + 1, std::memory_order_release);
+            }
+
+            if (pos.second > 0)
+            {
+                not_empty_.notify();
+            }
+
+            return pos.second;
+        }
+
+        // constructing an element may throw, so claim one cell per element, once it exists
+        template <typename InputIt>
+        size_type try_push_n(InputIt first, size_type count, std::false_type)
+        {
+            size_type pushed = 0;
+
+            for (; pushed < count; ++pushed, ++first)
+            {
+                if (!try_emplace(std::false_type(), *first))
+                {
+                    break;
+                }
+            }
+
+            return pushed;
+        }
+
+        template <typename... Args>
+        void emplace(std::true_type, Args&&... args)
+        {
+            if (!try_emplace(std::true_type(), std::forward<Args>(args)...))
+            {
+                // the arguments are only used, once a cell was claimed
+                not_full_.wait_until(
+                    [&]() { return try_emplace(std::true_type(), std::forward<Args>(args)...); });
+            }
+        }
+
+        template <typename... Args>
+        void emplace(std::false_type, Args&&... args)
+        {
+            T value(std::forward<Args>(args)...);
+            emplace(std::true_type(), std::move(value));
+        }
+
+        /**
+         * \brief Claims up to count consecutive cells at index, returns the first position and
+         * the number of claimed cells
+         *
+         * A cell at position pos is ready for producers, if its sequence is pos, and for
+         * consumers, if it is pos + 1, i.e., offset is 0 or 1.
+         */
+        std::pair<size_type, size_type> claim(std::atomic<size_type>& index, size_type count,
+                                              size_type offset)
+        {
+            auto pos = index.load(std::memory_order_relaxed);
+
+            while (count > 0)
+            {
+                size_type ready = 0;
+
+                for (; ready < count; ready++)
+                {
+                    auto& c = cells_[(pos + ready) & mask_];
+                    auto seq = c.sequence.load(std::memory_order_acquire);
+
+                    if (seq != pos + ready + offset)
+                    {
+                        if (ready == 0)
+                        {
+                            auto diff = static_cast<std::intptr_t>(seq - (pos + offset));
+
+                            // the queue is full or empty
+                            if (diff < 0)
+                            {
+                                return { pos, 0 };
+                            }
+
+                            // another thread claimed the cell already
+                            pos = index.load(std::memory_order_relaxed);
+                        }
+
+                        break;
+                    }
+                }
+
+                if (ready > 0 && index.compare_exchange_weak(pos, pos + ready,
+                                                              std::memory_order_relaxed))
+                {
+                    return { pos, ready };
+                }
+            }
+
+            return { pos, 0 };
+        }
+
+        /// moves the element out of a claimed cell and releases the cell, can't throw
+        T take(size_type pos) noexcept
+        {
+            auto& c = cells_[pos & mask_];
+
+            T value(std::move(c.value()));
+            c.value().~T();
+            c.sequence.store(pos + capacity_, std::memory_order_release);
+
+            return value;
+        }
+
+        const size_type capacity_;
+        const size_type mask_;
+        std::unique_ptr<cell[]> cells_;
+
+        char padding_producers_[detail::queue_padding];
+
+        std::atomic<size_type> enqueue_pos_{ 0 };
+        detail::queue_event not_empty_;
+
+        char padding_consumers_[detail::queue_padding];
+
+        std::atomic<size_type> dequeue_pos_{ 0 };
+        detail::queue_event not_full_;
+
+        char padding_end_[detail::queue_padding];
+    };
+} // namespace lang
+} // namespace nitro
@@ -31,78 +31,301 @@
 
 #include <nitro/except/raise.hpp>
 
-#include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace nitro
 {
 namespace lang
 {
+    namespace detail
+    {
+        // For trivially copyable types, the defaulted copy and move operations copy the bytes of
+        // the value and the engaged flag, so optional<T> is trivially copyable as well.
+        template <typename T, bool Trivial = std::is_trivially_copyable<T>::value>
+        class optional_storage
+        {
+        protected:
+            constexpr optional_storage() noexcept : empty_(), engaged_(false)
+            {
+            }
+
+            template <typename... Args>
+            void construct(Args&&... args)
+            {
+                ::new (static_cast<void*>(&value_)) T(std::forward<Args>(args)...);
+                engaged_ = true;
+            }
+
+            void destroy() noexcept
+            {
+                engaged_ = false;
+            }
+
+            union
+            {
+                char empty_;
+                T value_;
+            };
+
+            bool engaged_;
+        };
+
+        template <typename T>
+        class optional_storage<T, false>
+        {
+        protected:
+            optional_storage() noexcept : empty_(), engaged_(false)
+            {
+            }
+
+            optional_storage(const optional_storage& other) : empty_(), engaged_(false)
+            {
+                if (other.engaged_)
+                {
+                    construct(other.value_);
+                }
+            }
+
+            optional_storage(optional_storage&& other) noexcept(
+                std::is_nothrow_move_constructible<T>::value)
+            : empty_(), engaged_(false)
+            {
+                if (other.engaged_)
+                {
+                    construct(std::move(other.value_));
+                }
+            }
+
+            optional_storage& operator=(const optional_storage& other)
+            {
+                if (other.engaged_)
+                {
+                    assign(other.value_);
+                }
+                else
+                {
+                    destroy();
+                }
+
+                return *this;
+            }
 
+            optional_storage& operator=(optional_storage&& other) noexcept(
+                std::is_nothrow_move_assignable<T>::value&&
+                    std::is_nothrow_move_constructible<T>::value)
+            {
+                if (other.engaged_)
+                {
+                    assign(std::move(other.value_));
+                }
+                else
+                {
+                    destroy();
+                }
+
+                return *this;
+            }
+
+            ~optional_storage()
+            {
+                destroy();
+            }
+
+            template <typename... Args>
+            void construct(Args&&... args)
+            {
+                ::new (static_cast<void*>(&value_)) T(std::forward<Args>(args)...);
+                engaged_ = true;
+            }
+
+            void destroy() noexcept
+            {
+                if (engaged_)
+                {
+                    value_.~T();
+                    engaged_ = false;
+                }
+            }
+
+            union
+            {
+                char empty_;
+                T value_;
+            };
+
+            bool engaged_;
+
+        private:
+            template <typename U>
+            void assign(U&& value)
+            {
+                if (engaged_)
+                {
+                    value_ = std::forward<U>(value);
+                }
+                else
+                {
+                    construct(std::forward<U>(value));
+                }
+            }
+        };
+    } // namespace detail
+
+    /**
+     * \brief An optional value, stored inline without an allocation
+     *
+     * Accessing the value of an empty optional raises an exception.
+     */
     template <typename T>
-    class optional
+    class optional : private detail::optional_storage<T>
     {
+        using base = detail::optional_storage<T>;
+        using base::construct;
+        using base::destroy;
+        using base::engaged_;
+        using base::value_;
+
     public:
+        using value_type = T;
+
         optional() = default;
 
-        optional(const optional& other)
+        optional(const T& data)
         {
-            if (other)
-            {
-                data_ = std::make_unique<T>(*other);
-            }
+            construct(data);
         }
 
-        optional(const T& data) : data_(std::make_unique<T>(data))
+        optional(T&& data)
         {
+            construct(std::move(data));
         }
 
-        optional(T&& data) : data_(std::make_unique<T>(std::move(data)))
+        optional& operator=(const T& data)
         {
+            assign(data);
+
+            return *this;
         }
 
-        optional& operator=(const optional& other)
+        optional& operator=(T&& data)
         {
-            if (other)
-            {
-                data_ = std::make_unique<T>(*other);
-            }
+            assign(std::move(data));
 
             return *this;
         }
 
-        optional& operator=(const T& data)
+        template <typename... Args>
+        T& emplace(Args&&... args)
         {
-            data_ = std::make_unique<T>(data);
+            destroy();
+            construct(std::forward<Args>(args)...);
 
-            return *this;
+            return value_;
         }
 
-        optional& operator=(T&& data)
+        void reset() noexcept
         {
-            data_ = std::make_unique<T>(std::move(data));
-
-            return *this;
+            destroy();
         }
 
     public:
-        explicit operator bool() const
+        bool has_value() const noexcept
         {
-            return static_cast<bool>(data_);
+            return engaged_;
         }
 
-        const T& operator*() const
+        explicit operator bool() const noexcept
         {
-            if (data_)
+            return engaged_;
+        }
+
+        const T& operator*() const&
+        {
+            return value();
+        }
+
+        T& operator*() &
+        {
+            return value();
+        }
+
+        T&& operator*() &&
+        {
+            return std::move(value());
+        }
+
+        const T* operator->() const
+        {
+            return &value();
+        }
+
+        T* operator->()
+        {
+            return &value();
+        }
+
+        const T& value() const&
+        {
+            if (engaged_)
             {
-                return *data_;
+                return value_;
             }
 
             raise("No value set");
         }
 
+        T& value() &
+        {
+            if (engaged_)
+            {
+                return value_;
+            }
+
+            raise("No value set");
+        }
+
+        T&& value() &&
+        {
+            return std::move(value());
+        }
+
+        template <typename U>
+        T value_or(U&& default_value) const&
+        {
+            if (engaged_)
+            {
+                return value_;
+            }
+
+            return static_cast<T>(std::forward<U>(default_value));
+        }
+
+        template <typename U>
+        T value_or(U&& default_value) &&
+        {
+            if (engaged_)
+            {
+                return std::move(value_);
+            }
+
+            return static_cast<T>(std::forward<U>(default_value));
+        }
+
     private:
-        std::unique_ptr<T> data_;
+        template <typename U>
+        void assign(U&& data)
+        {
+            if (engaged_)
+            {
+                value_ = std::forward<U>(data);
+            }
+            else
+            {
+                construct(std::forward<U>(data));
+            }
+        }
     };
 } // namespace lang
 } // namespace nitro
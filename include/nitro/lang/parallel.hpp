@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/enumerate.hpp>
+#include <nitro/lang/thread_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        template <typename Iterator>
+        struct chunk_element_size
+        : std::integral_constant<std::size_t,
+                                 sizeof(typename std::iterator_traits<Iterator>::value_type)>
+        {
+        };
+
+        // enumerate adds the index, but the elements in memory are the underlying ones
+        template <typename Iterator>
+        struct chunk_element_size<enumerate_iterator<Iterator>> : chunk_element_size<Iterator>
+        {
+        };
+
+        /// a part of a random access range, for enumerate ranges with the global indices
+        template <typename Iterator>
+        class chunk
+        {
+        public:
+            using iterator = Iterator;
+
+            chunk(Iterator begin, Iterator end) : begin_(begin), end_(end)
+            {
+            }
+
+            Iterator begin() const
+            {
+                return begin_;
+            }
+
+            Iterator end() const
+            {
+                return end_;
+            }
+
+            std::size_t size() const
+            {
+                return static_cast<std::size_t>(end_ - begin_);
+            }
+
+        private:
+            Iterator begin_;
+            Iterator end_;
+        };
+
+        template <typename Iterator>
+        class chunk_range
+        {
+            using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = chunk<Iterator>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = chunk<Iterator>;
+
+                iterator(Iterator it, Iterator end, difference_type chunk_size)
+                : it_(it), end_(end), chunk_size_(chunk_size)
+                {
+                }
+
+                chunk<Iterator> operator*() const
+                {
+                    return { it_, it_ + std::min(chunk_size_, end_ - it_) };
+                }
+
+                iterator& operator++()
+                {
+                    it_ += std::min(chunk_size_, end_ - it_);
+                    return *this;
+                }
+
+                iterator operator++(int)
+                {
+                    auto orig = *this;
+                    ++(*this);
+                    return orig;
+                }
+
+                friend bool operator==(const iterator& a, const iterator& b)
+                {
+                    return a.it_ == b.it_;
+                }
+
+                friend bool operator!=(const iterator& a, const iterator& b)
+                {
+                    return !(a == b);
+                }
+
+            private:
+                Iterator it_;
+                Iterator end_;
+                difference_type chunk_size_;
+            };
+
+            chunk_range(Iterator begin, Iterator end, std::size_t chunk_size)
+            : begin_(begin), end_(end), chunk_size_(static_cast<difference_type>(chunk_size))
+            {
+                if (chunk_size == 0)
+                {
+                    chunk_size_ = 1;
+                }
+            }
+
+            iterator begin() const
+            {
+                return { begin_, end_, chunk_size_ };
+            }
+
+            iterator end() const
+            {
+                return { end_, end_, chunk_size_ };
+            }
+
+            std::size_t size() const
+            {
+                return static_cast<std::size_t>((end_ - begin_ + chunk_size_ - 1) / chunk_size_);
+            }
+
+            /// the i-th chunk, in O(1)
+            chunk<Iterator> operator[](std::size_t i) const
+            {
+                auto first = begin_ + static_cast<difference_type>(i) * chunk_size_;
+                return { first, first + std::min(chunk_size_, end_ - first) };
+            }
+
+        private:
+            Iterator begin_;
+            Iterator end_;
+            difference_type chunk_size_;
+        };
+
+        template <typename Range>
+        using range_iterator_t = decltype(std::begin(std::declval<Range&>()));
+
+        /**
+         * \brief Picks chunks of a few per thread, rounded up to a multiple of 64 bytes of elements
+         *
+         * Chunk boundaries are counted from the beginning of the range, so chunks on different
+         * threads only stay in separate cache lines, if the range starts at a cache line.
+         */
+        template <typename Iterator>
+        std::size_t default_chunk_size(std::size_t size, std::size_t threads)
+        {
+            constexpr std::size_t cache_line = 64;
+            constexpr std::size_t element_size = chunk_element_size<Iterator>::value;
+            constexpr std::size_t granule =
+                element_size >= cache_line ? 1 : cache_line / element_size;
+
+            auto chunk_size = (size + 4 * threads - 1) / (4 * threads);
+
+            return std::max<std::size_t>((chunk_size + granule - 1) / granule * granule, 1);
+        }
+
+#ifdef _OPENMP
+        inline std::size_t parallel_threads()
+        {
+            return static_cast<std::size_t>(omp_get_max_threads());
+        }
+
+        template <typename Iterator, typename F>
+        void run_chunks(const chunk_range<Iterator>& chunks, F& f)
+        {
+            parallel_exception error;
+            auto tasks = static_cast<long long>(chunks.size());
+
+            auto run_chunk = [&chunks, &f, &error](std::size_t i) {
+                error.run([&]() {
+                    for (auto&& element : chunks[i])
+                    {
+                        f(std::forward<decltype(element)>(element));
+                    }
+                });
+            };
+
+            if (omp_in_parallel())
+            {
+#pragma omp taskgroup
+                {
+#pragma omp taskloop grainsize(1)
+                    for (long long i = 0; i < tasks; i++)
+                    {
+                        run_chunk(static_cast<std::size_t>(i));
+                    }
+                }
+            }
+            else
+            {
+#pragma omp parallel
+#pragma omp single
+                {
+#pragma omp taskloop grainsize(1)
+                    for (long long i = 0; i < tasks; i++)
+                    {
+                        run_chunk(static_cast<std::size_t>(i));
+                    }
+                }
+            }
+
+            error.rethrow();
+        }
+#endif
+    } // namespace detail
+
+    /**
+     * \brief Splits a random access range into chunks of chunk_size elements, the last one
+     * might be smaller
+     *
+     * The chunks of enumerate ranges keep the indices of the whole range.
+     */
+    template <typename Range>
+    inline auto chunked(Range&& range, std::size_t chunk_size)
+    {
+        using iterator = detail::range_iterator_t<Range>;
+
+        using category = typename std::iterator_traits<iterator>::iterator_category;
+
+        static_assert(std::is_base_of<std::random_access_iterator_tag, category>::value,
+                      "chunked needs a random access range");
+
+        return detail::chunk_range<iterator>(std::begin(range), std::end(range), chunk_size);
+    }
+
+    /// like parallel_for_each, but runs the chunks as tasks in the given thread_pool
+    template <typename Range, typename F>
+    inline void parallel_for_each(thread_pool& pool, Range&& range, F&& f,
+                                  std::size_t chunk_size = 0)
+    {
+        using iterator = detail::range_iterator_t<Range>;
+
+        auto size = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+
+        if (size == 0)
+        {
+            return;
+        }
+
+        if (chunk_size == 0)
+        {
+            chunk_size = detail::default_chunk_size<iterator>(size, pool.size());
+        }
+
+        auto chunks = chunked(range, chunk_size);
+
+        pool.parallel_for(0, chunks.size(),
+                          [&chunks, &f](std::size_t i) {
+                              for (auto&& element : chunks[i])
+                              {
+                                  f(std::forward<decltype(element)>(element));
+                              }
+                          },
+                          1);
+    }
+
+    /**
+     * \brief Calls f for every element of a random access range, in parallel
+     *
+     * The range is split into chunks, which run as OpenMP tasks, if compiled with OpenMP, or
+     * else as tasks in default_thread_pool(). To use another thread_pool, pass it as the first
+     * argument. There is no order between the calls, and an exception thrown by f is rethrown
+     * once all chunks are done. A chunk_size of 0 picks a few chunks per thread.
+     */
+    template <typename Range, typename F>
+    inline void parallel_for_each(Range&& range, F&& f, std::size_t chunk_size = 0)
+    {
+#ifdef _OPENMP
+        using iterator = detail::range_iterator_t<Range>;
+
+        auto size = static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+
+        if (size == 0)
+        {
+            return;
+        }
+
+        if (chunk_size == 0)
+        {
+            chunk_size = detail::default_chunk_size<iterator>(size, detail::parallel_threads());
+        }
+
+        detail::run_chunks(chunked(range, chunk_size), f);
+#else
+        parallel_for_each(default_thread_pool(), std::forward<Range>(range), std::forward<F>(f),
+                          chunk_size);
+#endif
+    }
+} // namespace lang
+} // namespace nitro
@@ -0,0 +1,662 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+#include <nitro/lang/span.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    /// what ring_buffer::push_back() does, if the buffer is full
+    enum class ring_policy
+    {
+        overwrite_oldest,
+        reject_new
+    };
+
+    namespace detail
+    {
+        /// random access over the logical order of a ring_buffer, i.e., from oldest to newest
+        template <typename Buffer, typename Value>
+        class ring_buffer_iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::remove_const_t<Value>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+
+            ring_buffer_iterator() = default;
+
+            ring_buffer_iterator(Buffer* buffer, std::size_t index) : buffer_(buffer), index_(index)
+            {
+            }
+
+            template <typename OtherBuffer, typename OtherValue,
+                      typename = std::enable_if_t<std::is_convertible<OtherValue*, Value*>::value>>
+            ring_buffer_iterator(const ring_buffer_iterator<OtherBuffer, OtherValue>& other)
+            : buffer_(other.buffer_), index_(other.index_)
+            {
+            }
+
+            std::size_t index() const
+            {
+                return index_;
+            }
+
+            reference operator*() const
+            {
+                return (*buffer_)[index_];
+            }
+
+            pointer operator->() const
+            {
+                return &(*buffer_)[index_];
+            }
+
+            reference operator[](difference_type n) const
+            {
+                return (*buffer_)[index_ + n];
+            }
+
+            ring_buffer_iterator& operator++()
+            {
+                ++index_;
+                return *this;
+            }
+
+            ring_buffer_iterator operator++(int)
+            {
+                auto result = *this;
+                ++index_;
+                return result;
+            }
+
+            ring_buffer_iterator& operator--()
+            {
+                --index_;
+                return *this;
+            }
+
+            ring_buffer_iterator operator--(int)
+            {
+                auto result = *this;
+                --index_;
+                return result;
+            }
+
+            ring_buffer_iterator& operator+=(difference_type n)
+            {
+                index_ += n;
+                return *this;
+            }
+
+            ring_buffer_iterator& operator-=(difference_type n)
+            {
+                index_ -= n;
+                return *this;
+            }
+
+            friend ring_buffer_iterator operator+(ring_buffer_iterator it, difference_type n)
+            {
+                return it += n;
+            }
+
+            friend ring_buffer_iterator operator+(difference_type n, ring_buffer_iterator it)
+            {
+                return it += n;
+            }
+
+            friend ring_buffer_iterator operator-(ring_buffer_iterator it, difference_type n)
+            {
+                return it -= n;
+            }
+
+            friend difference_type operator-(const ring_buffer_iterator& a,
+                                             const ring_buffer_iterator& b)
+            {
+                return static_cast<difference_type>(a.index_) -
+                       static_cast<difference_type>(b.index_);
+            }
+
+            friend bool operator==(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ == b.index_;
+            }
+
+            friend bool operator!=(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ != b.index_;
+            }
+
+            friend bool operator<(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ < b.index_;
+            }
+
+            friend bool operator>(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ > b.index_;
+            }
+
+            friend bool operator<=(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ <= b.index_;
+            }
+
+            friend bool operator>=(const ring_buffer_iterator& a, const ring_buffer_iterator& b)
+            {
+                return a.index_ >= b.index_;
+            }
+
+        private:
+            template <typename, typename>
+            friend class ring_buffer_iterator;
+
+            Buffer* buffer_ = nullptr;
+            std::size_t index_ = 0;
+        };
+    } // namespace detail
+
+    /**
+     * \brief A circular buffer with a capacity fixed at construction
+     *
+     * Like fixed_vector, the storage for capacity elements is allocated once from Allocator and
+     * elements are only constructed on insertion. push_back() and pop_front() are O(1), so it
+     * suits rolling windows. Once the buffer is full, push_back() either replaces the oldest
+     * element or rejects the new one, depending on the ring_policy.
+     *
+     * Element i in the logical order is found by masking, if the capacity is a power of two, and
+     * by a single compare otherwise.
+     */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class ring_buffer
+    {
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+    public:
+        using allocator_type = Allocator;
+        using value_type = T;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = detail::ring_buffer_iterator<ring_buffer, value_type>;
+        using const_iterator = detail::ring_buffer_iterator<const ring_buffer, const value_type>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        explicit ring_buffer(size_type capacity, ring_policy policy = ring_policy::overwrite_oldest,
+                             const allocator_type& alloc = allocator_type())
+        : capacity_(capacity), mask_(capacity - 1),
+          power_of_two_(capacity != 0 && (capacity & (capacity - 1)) == 0), policy_(policy),
+          allocator_(alloc), data_(allocate(capacity))
+        {
+        }
+
+        ring_buffer(const ring_buffer& other)
+        : ring_buffer(other, allocator_traits::select_on_container_copy_construction(
+                                 other.allocator_))
+        {
+        }
+
+        ring_buffer(const ring_buffer& other, const allocator_type& alloc)
+        : ring_buffer(other.capacity_, other.policy_, alloc)
+        {
+            append(other.begin(), other.end());
+        }
+
+        ring_buffer(ring_buffer&& other) noexcept
+        : size_(other.size_), head_(other.head_), capacity_(other.capacity_), mask_(other.mask_),
+          power_of_two_(other.power_of_two_), policy_(other.policy_),
+          allocator_(std::move(other.allocator_)), data_(other.data_)
+        {
+            other.size_ = 0;
+            other.head_ = 0;
+            other.data_ = nullptr;
+        }
+
+        ring_buffer& operator=(const ring_buffer& other)
+        {
+            if (this != &other)
+            {
+                clear();
+
+                if (capacity_ != other.capacity_ ||
+                    (allocator_traits::propagate_on_container_copy_assignment::value &&
+                     allocator_ != other.allocator_))
+                {
+                    deallocate(data_, capacity_);
+                    data_ = nullptr;
+                    set_capacity(other.capacity_);
+                }
+
+                if (allocator_traits::propagate_on_container_copy_assignment::value)
+                {
+                    allocator_ = other.allocator_;
+                }
+
+                policy_ = other.policy_;
+                append(other.begin(), other.end());
+            }
+
+            return *this;
+        }
+
+        ring_buffer& operator=(ring_buffer&& other) noexcept(
+            allocator_traits::propagate_on_container_move_assignment::value ||
+            allocator_traits::is_always_equal::value)
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+
+            clear();
+            policy_ = other.policy_;
+
+            if (allocator_traits::propagate_on_container_move_assignment::value ||
+                allocator_ == other.allocator_)
+            {
+                deallocate(data_, capacity_);
+
+                if (allocator_traits::propagate_on_container_move_assignment::value)
+                {
+                    allocator_ = std::move(other.allocator_);
+                }
+
+                size_ = other.size_;
+                head_ = other.head_;
+                set_capacity(other.capacity_);
+                data_ = other.data_;
+
+                other.size_ = 0;
+                other.head_ = 0;
+                other.data_ = nullptr;
+            }
+            else
+            {
+                // the storage of other belongs to another allocator, so we can only move elements
+                if (capacity_ != other.capacity_)
+                {
+                    deallocate(data_, capacity_);
+                    data_ = nullptr;
+                    set_capacity(other.capacity_);
+                }
+
+                append(std::make_move_iterator(other.begin()),
+                       std::make_move_iterator(other.end()));
+                other.clear();
+            }
+
+            return *this;
+        }
+
+        ~ring_buffer()
+        {
+            clear();
+            deallocate(data_, capacity_);
+        }
+
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        bool full() const noexcept
+        {
+            return size_ == capacity_;
+        }
+
+        size_type size() const noexcept
+        {
+            return size_;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        ring_policy policy() const noexcept
+        {
+            return policy_;
+        }
+
+        /// the i-th oldest element
+        reference operator[](size_type i) noexcept
+        {
+            return data_[slot(i)];
+        }
+
+        const_reference operator[](size_type i) const noexcept
+        {
+            return data_[slot(i)];
+        }
+
+        reference at(size_type i)
+        {
+            if (i >= size_)
+                raise("Key is larger than size!");
+
+            return data_[slot(i)];
+        }
+
+        const_reference at(size_type i) const
+        {
+            if (i >= size_)
+                raise("Key is larger than size!");
+
+            return data_[slot(i)];
+        }
+
+        /// the oldest element
+        reference front() noexcept
+        {
+            return data_[head_];
+        }
+
+        const_reference front() const noexcept
+        {
+            return data_[head_];
+        }
+
+        /// the newest element
+        reference back() noexcept
+        {
+            return data_[slot(size_ - 1)];
+        }
+
+        const_reference back() const noexcept
+        {
+            return data_[slot(size_ - 1)];
+        }
+
+        /// appends a new element, returns false, if it was rejected, because the buffer is full
+        template <typename... Args>
+        bool emplace_back(Args&&... args)
+        {
+            if (size_ < capacity_)
+            {
+                construct(slot(size_), std::forward<Args>(args)...);
+                ++size_;
+
+                return true;
+            }
+
+            if (policy_ == ring_policy::reject_new || capacity_ == 0)
+            {
+                return false;
+            }
+
+            // the arguments might refer to the oldest element, which is destroyed below
+            value_type value(std::forward<Args>(args)...);
+
+            // drop the oldest first, so a throwing constructor leaves a consistent buffer
+            destroy(head_);
+            head_ = slot(1);
+            --size_;
+
+            construct(slot(size_), std::move(value));
+            ++size_;
+
+            return true;
+        }
+
+        bool push_back(const_reference value)
+        {
+            return emplace_back(value);
+        }
+
+        bool push_back(value_type&& value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        void pop_front()
+        {
+            if (size_ == 0)
+                raise("Container is empty!");
+
+            destroy(head_);
+            head_ = slot(1);
+            --size_;
+
+            if (size_ == 0)
+            {
+                head_ = 0;
+            }
+        }
+
+        void pop_back()
+        {
+            if (size_ == 0)
+                raise("Container is empty!");
+
+            --size_;
+            destroy(slot(size_));
+
+            if (size_ == 0)
+            {
+                head_ = 0;
+            }
+        }
+
+        void clear() noexcept
+        {
+            while (size_ > 0)
+            {
+                destroy(slot(--size_));
+            }
+
+            head_ = 0;
+        }
+
+        /**
+         * \brief The elements in logical order as at most two contiguous pieces
+         *
+         * The second span is empty, unless the elements wrap around the end of the storage. Use
+         * this for bulk copies, e.g., with memcpy() or writev().
+         */
+        std::array<span<value_type>, 2> as_spans() noexcept
+        {
+            return spans<value_type>(data_);
+        }
+
+        std::array<span<const value_type>, 2> as_spans() const noexcept
+        {
+            return spans<const value_type>(data_);
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() noexcept
+        {
+            return iterator(this, size_);
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return allocator_;
+        }
+
+    private:
+        /// the storage index of the i-th oldest element, for i < capacity
+        size_type slot(size_type i) const noexcept
+        {
+            auto index = head_ + i;
+
+            if (power_of_two_)
+            {
+                return index & mask_;
+            }
+
+            return index < capacity_ ? index : index - capacity_;
+        }
+
+        void set_capacity(size_type capacity) noexcept
+        {
+            capacity_ = capacity;
+            mask_ = capacity - 1;
+            power_of_two_ = capacity != 0 && (capacity & (capacity - 1)) == 0;
+        }
+
+        template <typename Value>
+        std::array<span<Value>, 2> spans(Value* data) const noexcept
+        {
+            if (head_ + size_ <= capacity_)
+            {
+                return { { span<Value>(data + head_, size_), span<Value>() } };
+            }
+
+            auto first = capacity_ - head_;
+            return { { span<Value>(data + head_, first), span<Value>(data, size_ - first) } };
+        }
+
+        template <typename Iter>
+        void append(Iter first, Iter last)
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        pointer allocate(size_type capacity)
+        {
+            if (capacity == 0)
+                return nullptr;
+
+            return allocator_traits::allocate(allocator_, capacity);
+        }
+
+        void deallocate(pointer data, size_type capacity) noexcept
+        {
+            if (data != nullptr)
+                allocator_traits::deallocate(allocator_, data, capacity);
+        }
+
+        template <class... Args>
+        void construct(size_type index, Args&&... args)
+        {
+            if (data_ == nullptr)
+                data_ = allocate(capacity_);
+
+            allocator_traits::construct(allocator_, data_ + index, std::forward<Args>(args)...);
+        }
+
+        void destroy(size_type index) noexcept
+        {
+            allocator_traits::destroy(allocator_, data_ + index);
+        }
+
+        size_type size_ = 0;
+        size_type head_ = 0;
+        size_type capacity_;
+        size_type mask_;
+        bool power_of_two_;
+        ring_policy policy_;
+
+        allocator_type allocator_;
+        pointer data_ = nullptr;
+    };
+
+#if __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+    namespace pmr
+    {
+        template <typename T>
+        using ring_buffer = lang::ring_buffer<T, std::pmr::polymorphic_allocator<T>>;
+    } // namespace pmr
+#endif
+#endif
+
+} // namespace lang
+} // namespace nitro
@@ -0,0 +1,614 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+#include <nitro/lang/span.hpp>
+#include <nitro/lang/tuple_foreach.hpp>
+#include <nitro/lang/tuple_operators.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        /// allocates storage aligned to Alignment bytes, e.g., a cache line for SIMD loads
+        template <typename T, std::size_t Alignment = 64>
+        struct aligned_allocator
+        {
+            static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+            static constexpr std::size_t alignment =
+                Alignment < alignof(T) ? alignof(T) : Alignment;
+
+            using value_type = T;
+
+            template <typename U>
+            struct rebind
+            {
+                using other = aligned_allocator<U, Alignment>;
+            };
+
+            aligned_allocator() = default;
+
+            template <typename U>
+            aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+            {
+            }
+
+            T* allocate(std::size_t n)
+            {
+                if (n > (static_cast<std::size_t>(-1) - alignment - sizeof(void*)) / sizeof(T))
+                    throw std::bad_alloc();
+
+#if __cpp_aligned_new >= 201606L
+                return static_cast<T*>(
+                    ::operator new(n * sizeof(T), static_cast<std::align_val_t>(alignment)));
+#else
+                // over-allocate and keep the original pointer right before the aligned block
+                auto raw = ::operator new(n * sizeof(T) + alignment + sizeof(void*));
+                auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+                auto aligned =
+                    reinterpret_cast<void**>((address + alignment - 1) & ~(alignment - 1));
+
+                aligned[-1] = raw;
+                return reinterpret_cast<T*>(aligned);
+#endif
+            }
+
+            void deallocate(T* p, std::size_t) noexcept
+            {
+#if __cpp_aligned_new >= 201606L
+                ::operator delete(p, static_cast<std::align_val_t>(alignment));
+#else
+                ::operator delete(reinterpret_cast<void**>(p)[-1]);
+#endif
+            }
+
+            template <typename U>
+            friend bool operator==(const aligned_allocator&,
+                                   const aligned_allocator<U, Alignment>&) noexcept
+            {
+                return true;
+            }
+
+            template <typename U>
+            friend bool operator!=(const aligned_allocator&,
+                                   const aligned_allocator<U, Alignment>&) noexcept
+            {
+                return false;
+            }
+        };
+
+        template <typename T>
+        using soa_fields = decltype(lang::as_tuple(std::declval<T&>()));
+
+        template <typename... Fields>
+        constexpr bool soa_has_bool()
+        {
+            bool result = false;
+
+            for (bool is_bool : { std::is_same<std::decay_t<Fields>, bool>::value... })
+            {
+                result = result || is_bool;
+            }
+
+            return result;
+        }
+
+        template <typename Tuple>
+        struct soa_columns;
+
+        template <typename... Fields>
+        struct soa_columns<std::tuple<Fields...>>
+        {
+            static_assert(sizeof...(Fields) > 0, "as_tuple() must return at least one field");
+            static_assert(!soa_has_bool<Fields...>(),
+                          "bool fields are not supported, as std::vector<bool> isn't contiguous");
+
+            using type = std::tuple<std::vector<std::decay_t<Fields>,
+                                                aligned_allocator<std::decay_t<Fields>>>...>;
+            using references = std::tuple<std::decay_t<Fields>&...>;
+            using const_references = std::tuple<const std::decay_t<Fields>&...>;
+        };
+    } // namespace detail
+
+    /**
+     * \brief Behaves like a T&, that refers to one row of a soa_vector
+     *
+     * Converts to a T, can be assigned a T and assigns through, when assigned another reference.
+     * Like the types with tuple_operators, it exposes the fields with as_tuple().
+     */
+    template <typename T, typename References>
+    class soa_reference
+    {
+    public:
+        explicit soa_reference(const References& fields) : fields_(fields)
+        {
+        }
+
+        soa_reference(const soa_reference&) = default;
+
+        template <typename OtherReferences,
+                  typename = std::enable_if_t<
+                      std::is_convertible<const OtherReferences&, References>::value>>
+        soa_reference(const soa_reference<T, OtherReferences>& other)
+        : fields_(other.as_tuple())
+        {
+        }
+
+        const soa_reference& operator=(const soa_reference& other) const
+        {
+            fields_ = other.fields_;
+            return *this;
+        }
+
+        const soa_reference& operator=(const T& value) const
+        {
+            fields_ = lang::as_tuple(value);
+            return *this;
+        }
+
+        operator T() const
+        {
+            T result;
+            lang::as_tuple(result) = fields_;
+            return result;
+        }
+
+        const References& as_tuple() const
+        {
+            return fields_;
+        }
+
+        template <std::size_t I>
+        auto& get() const
+        {
+            return std::get<I>(fields_);
+        }
+
+        friend void swap(const soa_reference& a, const soa_reference& b)
+        {
+            T tmp = a;
+            a = b;
+            b = tmp;
+        }
+
+    private:
+        // mutable, because a const proxy is still a reference to non-const fields
+        mutable References fields_;
+    };
+
+    namespace detail
+    {
+        template <typename Vector, typename Reference>
+        class soa_iterator
+        {
+        public:
+            // like std::vector<bool>, the reference is a proxy
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = typename std::remove_const_t<Vector>::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Reference;
+
+            soa_iterator() = default;
+
+            soa_iterator(Vector* vector, std::size_t index) : vector_(vector), index_(index)
+            {
+            }
+
+            template <typename OtherVector, typename OtherReference,
+                      typename =
+                          std::enable_if_t<std::is_convertible<OtherVector*, Vector*>::value>>
+            soa_iterator(const soa_iterator<OtherVector, OtherReference>& other)
+            : vector_(other.vector_), index_(other.index_)
+            {
+            }
+
+            std::size_t index() const
+            {
+                return index_;
+            }
+
+            reference operator*() const
+            {
+                return (*vector_)[index_];
+            }
+
+            reference operator[](difference_type n) const
+            {
+                return (*vector_)[index_ + n];
+            }
+
+            soa_iterator& operator++()
+            {
+                ++index_;
+                return *this;
+            }
+
+            soa_iterator operator++(int)
+            {
+                auto result = *this;
+                ++index_;
+                return result;
+            }
+
+            soa_iterator& operator--()
+            {
+                --index_;
+                return *this;
+            }
+
+            soa_iterator operator--(int)
+            {
+                auto result = *this;
+                --index_;
+                return result;
+            }
+
+            soa_iterator& operator+=(difference_type n)
+            {
+                index_ += n;
+                return *this;
+            }
+
+            soa_iterator& operator-=(difference_type n)
+            {
+                index_ -= n;
+                return *this;
+            }
+
+            friend soa_iterator operator+(soa_iterator it, difference_type n)
+            {
+                return it += n;
+            }
+
+            friend soa_iterator operator+(difference_type n, soa_iterator it)
+            {
+                return it += n;
+            }
+
+            friend soa_iterator operator-(soa_iterator it, difference_type n)
+            {
+                return it -= n;
+            }
+
+            friend difference_type operator-(const soa_iterator& a, const soa_iterator& b)
+            {
+                return static_cast<difference_type>(a.index_) -
+                       static_cast<difference_type>(b.index_);
+            }
+
+            friend bool operator==(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ == b.index_;
+            }
+
+            friend bool operator!=(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ != b.index_;
+            }
+
+            friend bool operator<(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ < b.index_;
+            }
+
+            friend bool operator>(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ > b.index_;
+            }
+
+            friend bool operator<=(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ <= b.index_;
+            }
+
+            friend bool operator>=(const soa_iterator& a, const soa_iterator& b)
+            {
+                return a.index_ >= b.index_;
+            }
+
+        private:
+            template <typename, typename>
+            friend class soa_iterator;
+
+            Vector* vector_ = nullptr;
+            std::size_t index_ = 0;
+        };
+    } // namespace detail
+
+    /**
+     * \brief A vector of T, that stores each field of T in its own contiguous array
+     *
+     * The fields are those returned by as_tuple(), see tuple_operators. Each column is aligned to
+     * a cache line and column<I>() exposes it as a span, so scans over a few fields only load
+     * those fields. Elements are accessed through soa_reference proxies, converting one to a T
+     * requires T to be default constructible.
+     */
+    template <typename T>
+    class soa_vector
+    {
+        using columns_traits = detail::soa_columns<detail::soa_fields<T>>;
+        using columns_type = typename columns_traits::type;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = soa_reference<T, typename columns_traits::references>;
+        using const_reference = soa_reference<T, typename columns_traits::const_references>;
+        using iterator = detail::soa_iterator<soa_vector, reference>;
+        using const_iterator = detail::soa_iterator<const soa_vector, const_reference>;
+
+        static constexpr size_type column_count = std::tuple_size<columns_type>::value;
+
+        template <size_type I>
+        using column_type = typename std::tuple_element_t<I, columns_type>::value_type;
+
+        soa_vector() = default;
+
+        soa_vector(std::initializer_list<value_type> list)
+        {
+            append(list.begin(), list.end());
+        }
+
+        size_type size() const noexcept
+        {
+            return std::get<0>(columns_).size();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return std::get<0>(columns_).capacity();
+        }
+
+        void reserve(size_type capacity)
+        {
+            tuple_foreach(columns_, [capacity](auto& column) { column.reserve(capacity); });
+        }
+
+        /// new elements have value-initialized fields
+        void resize(size_type size)
+        {
+            reserve(size);
+            tuple_foreach(columns_, [size](auto& column) { column.resize(size); });
+        }
+
+        void clear() noexcept
+        {
+            tuple_foreach(columns_, [](auto& column) { column.clear(); });
+        }
+
+        /// the I-th field of all elements as one contiguous array
+        template <size_type I>
+        span<column_type<I>> column() noexcept
+        {
+            auto& c = std::get<I>(columns_);
+            return span<column_type<I>>(c.data(), c.size());
+        }
+
+        template <size_type I>
+        span<const column_type<I>> column() const noexcept
+        {
+            auto& c = std::get<I>(columns_);
+            return span<const column_type<I>>(c.data(), c.size());
+        }
+
+        reference operator[](size_type i) noexcept
+        {
+            return make_reference<reference>(columns_, i, indices());
+        }
+
+        const_reference operator[](size_type i) const noexcept
+        {
+            return make_reference<const_reference>(columns_, i, indices());
+        }
+
+        reference at(size_type i)
+        {
+            if (i >= size())
+                raise("Key is larger than size!");
+
+            return (*this)[i];
+        }
+
+        const_reference at(size_type i) const
+        {
+            if (i >= size())
+                raise("Key is larger than size!");
+
+            return (*this)[i];
+        }
+
+        reference front() noexcept
+        {
+            return (*this)[0];
+        }
+
+        const_reference front() const noexcept
+        {
+            return (*this)[0];
+        }
+
+        reference back() noexcept
+        {
+            return (*this)[size() - 1];
+        }
+
+        const_reference back() const noexcept
+        {
+            return (*this)[size() - 1];
+        }
+
+        void push_back(const value_type& value)
+        {
+            emplace_fields(lang::as_tuple(value), indices());
+        }
+
+        /// appends one element given by its fields in the order of as_tuple()
+        template <typename... Args>
+        void emplace_back(Args&&... fields)
+        {
+            static_assert(sizeof...(Args) == column_count, "emplace_back() takes one per field");
+
+            emplace_fields(std::forward_as_tuple(std::forward<Args>(fields)...), indices());
+        }
+
+        /// appends [first, last), reserving all columns once for forward iterators
+        template <typename Iter>
+        void append(Iter first, Iter last)
+        {
+            append(first, last, typename std::iterator_traits<Iter>::iterator_category());
+        }
+
+        void pop_back()
+        {
+            if (empty())
+                raise("Container is empty!");
+
+            tuple_foreach(columns_, [](auto& column) { column.pop_back(); });
+        }
+
+        iterator begin() noexcept
+        {
+            return iterator(this, 0);
+        }
+
+        iterator end() noexcept
+        {
+            return iterator(this, size());
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator(this, size());
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+    private:
+        using indices = std::make_index_sequence<column_count>;
+
+        template <typename Reference, typename Columns, std::size_t... Is>
+        static Reference make_reference(Columns& columns, size_type i, std::index_sequence<Is...>)
+        {
+            return Reference(std::tie(std::get<Is>(columns)[i]...));
+        }
+
+        template <typename Fields, std::size_t... Is>
+        void emplace_fields(Fields&& fields, std::index_sequence<Is...>)
+        {
+            auto old_size = size();
+
+            if (old_size == capacity())
+            {
+                reserve(std::max<size_type>(2 * old_size, 16));
+            }
+
+            try
+            {
+                auto l = { (std::get<Is>(columns_).emplace_back(
+                                std::get<Is>(std::forward<Fields>(fields))),
+                            0)... };
+                (void)l;
+            }
+            catch (...)
+            {
+                // keep all columns the same length
+                tuple_foreach(columns_, [old_size](auto& column) {
+                    if (column.size() > old_size)
+                        column.pop_back();
+                });
+                throw;
+            }
+        }
+
+        template <typename Iter>
+        void append(Iter first, Iter last, std::input_iterator_tag)
+        {
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+        }
+
+        template <typename Iter>
+        void append(Iter first, Iter last, std::forward_iterator_tag)
+        {
+            auto count = static_cast<size_type>(std::distance(first, last));
+
+            if (size() + count > capacity())
+            {
+                reserve(std::max(size() + count, 2 * capacity()));
+            }
+
+            append(first, last, std::input_iterator_tag());
+        }
+
+        columns_type columns_;
+    };
+
+#if __cplusplus < 201703L
+    template <typename T>
+    constexpr typename soa_vector<T>::size_type soa_vector<T>::column_count;
+#endif
+} // namespace lang
+} // namespace nitro
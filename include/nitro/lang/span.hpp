@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief A non-owning view of size contiguous elements starting at data
+     *
+     * A minimal stand-in for std::span, which is C++20. Like the latter, it is cheap to copy and
+     * doesn't extend the lifetime of the elements.
+     */
+    template <typename T>
+    class span
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        constexpr span() noexcept = default;
+
+        constexpr span(pointer data, size_type size) noexcept : data_(data), size_(size)
+        {
+        }
+
+        template <typename U,
+                  typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+        constexpr span(const span<U>& other) noexcept : data_(other.data()), size_(other.size())
+        {
+        }
+
+        constexpr pointer data() const noexcept
+        {
+            return data_;
+        }
+
+        constexpr size_type size() const noexcept
+        {
+            return size_;
+        }
+
+        constexpr size_type size_bytes() const noexcept
+        {
+            return size_ * sizeof(T);
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        constexpr reference operator[](size_type index) const noexcept
+        {
+            return data_[index];
+        }
+
+        constexpr reference front() const noexcept
+        {
+            return data_[0];
+        }
+
+        constexpr reference back() const noexcept
+        {
+            return data_[size_ - 1];
+        }
+
+        constexpr iterator begin() const noexcept
+        {
+            return data_;
+        }
+
+        constexpr iterator end() const noexcept
+        {
+            return data_ + size_;
+        }
+
+    private:
+        pointer data_ = nullptr;
+        size_type size_ = 0;
+    };
+} // namespace lang
+} // namespace nitro
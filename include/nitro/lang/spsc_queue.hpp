@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/lang/detail/queue_event.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nitro
+{
+namespace lang
+{
+    /**
+     * \brief A bounded lock-free queue for exactly one producer and one consumer thread
+     *
+     * The capacity is rounded up to a power of two. Each side caches the index of the other
+     * side and only reloads it, when the queue looks full or empty. The try_ functions never
+     * block, push() and pop() wait for room or an element.
+     */
+    template <typename T>
+    class spsc_queue
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        explicit spsc_queue(size_type capacity)
+        : capacity_(detail::queue_capacity(capacity)), mask_(capacity_ - 1),
+          data_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+        {
+        }
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue()
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+            auto tail = tail_.load(std::memory_order_relaxed);
+
+            for (; head != tail; ++head)
+            {
+                data_[head & mask_].~T();
+            }
+
+            ::operator delete(data_);
+        }
+
+        size_type capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        /// only exact, if neither side is running
+        size_type size() const noexcept
+        {
+            auto tail = tail_.load(std::memory_order_acquire);
+            auto head = head_.load(std::memory_order_acquire);
+
+            return tail - head;
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        template <typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+            auto tail = tail_.load(std::memory_order_relaxed);
+
+            if (tail - cached_head_ == capacity_)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+
+                if (tail - cached_head_ == capacity_)
+                {
+                    return false;
+                }
+            }
+
+            new (data_ + (tail & mask_)) T(std::forward<Args>(args)...);
+            publish_tail(tail, 1);
+
+            return true;
+        }
+
+        bool try_push(const T& value)
+        {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        /// pushes as many of the count elements starting at first as fit, returns that number
+        template <typename InputIt>
+        size_type try_push_n(InputIt first, size_type count)
+        {
+            auto tail = tail_.load(std::memory_order_relaxed);
+
+            if (capacity_ - (tail - cached_head_) < count)
+            {
+                cached_head_ = head_.load(std::memory_order_acquire);
+            }
+
+            count = std::min(count, capacity_ - (tail - cached_head_));
+
+            size_type pushed = 0;
+
+            try
+            {
+                for (; pushed < count; ++pushed, ++first)
+                {
+                    new (data_ + ((tail + pushed) & mask_)) T(*first);
+                }
+            }
+            catch (...)
+            {
+                // publish the elements constructed so far
+                publish_tail(tail, pushed);
+                throw;
+            }
+
+            publish_tail(tail, count);
+
+            return count;
+        }
+
+        bool try_pop(T& value)
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+
+            if (head == cached_tail_)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+
+                if (head == cached_tail_)
+                {
+                    return false;
+                }
+            }
+
+            auto& slot = data_[head & mask_];
+            value = std::move(slot);
+            slot.~T();
+
+            publish_head(head, 1);
+
+            return true;
+        }
+
+        /// pops up to count elements to out, returns their number
+        template <typename OutputIt>
+        size_type try_pop_n(OutputIt out, size_type count)
+        {
+            auto head = head_.load(std::memory_order_relaxed);
+
+            if (cached_tail_ - head < count)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+            }
+
+            count = std::min(count, cached_tail_ - head);
+
+            size_type popped = 0;
+
+            try
+            {
+                for (; popped < count; ++popped, ++out)
+                {
+                    auto& slot = data_[(head + popped) & mask_];
+                    *out = std::move(slot);
+                    slot.~T();
+                }
+            }
+            catch (...)
+            {
+                // the element, whose assignment threw, stays in the queue
+                publish_head(head, popped);
+                throw;
+            }
+
+            publish_head(head, count);
+
+            return count;
+        }
+
+        /// waits for room, if the queue is full
+        template <typename... Args>
+        void emplace(Args&&... args)
+        {
+            if (!has_room())
+            {
+                not_full_.wait_until([this]() { return has_room(); });
+            }
+
+            try_emplace(std::forward<Args>(args)...);
+        }
+
+        void push(const T& value)
+        {
+            emplace(value);
+        }
+
+        void push(T&& value)
+        {
+            emplace(std::move(value));
+        }
+
+        /// waits for an element, if the queue is empty
+        void pop(T& value)
+        {
+            if (!try_pop(value))
+            {
+                not_empty_.wait_until([this, &value]() { return try_pop(value); });
+            }
+        }
+
+        T pop()
+        {
+            T value;
+            pop(value);
+            return value;
+        }
+
+    private:
+        void publish_tail(size_type tail, size_type count)
+        {
+            if (count > 0)
+            {
+                tail_.store(tail + count, std::memory_order_release);
+                not_empty_.notify();
+            }
+        }
+
+        void publish_head(size_type head, size_type count)
+        {
+            if (count > 0)
+            {
+                head_.store(head + count, std::memory_order_release);
+                not_full_.notify();
+            }
+        }
+
+        bool has_room()
+        {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            cached_head_ = head_.load(std::memory_order_acquire);
+
+            return tail - cached_head_ < capacity_;
+        }
+
+        const size_type capacity_;
+        const size_type mask_;
+        T* data_;
+
+        char padding_consumer_[detail::queue_padding];
+
+        // written by the consumer
+        std::atomic<size_type> head_{ 0 };
+        size_type cached_tail_ = 0;
+        detail::queue_event not_full_;
+
+        char padding_producer_[detail::queue_padding];
+
+        // written by the producer
+        std::atomic<size_type> tail_{ 0 };
+        size_type cached_head_ = 0;
+        detail::queue_event not_empty_;
+
+        char padding_end_[detail::queue_padding];
+    };
+} // namespace lang
+} // namespace nitro
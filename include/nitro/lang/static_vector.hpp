@@ -0,0 +1,547 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        // Trivial types live in a plain array, so static_vector stays usable in constant
+        // expressions. Those need every element initialized, so before C++20, the whole array
+        // is zeroed on every construction, which costs O(N) even for an empty vector. Since
+        // C++20, this only happens during constant evaluation.
+        template <typename T, std::size_t N, bool Trivial = std::is_trivial<T>::value>
+        class static_vector_storage
+        {
+        protected:
+#ifdef __cpp_lib_is_constant_evaluated
+            constexpr static_vector_storage() noexcept
+            {
+                if (std::is_constant_evaluated())
+                {
+                    for (auto& value : data_)
+                    {
+                        value = T();
+                    }
+                }
+            }
+#else
+            constexpr static_vector_storage() = default;
+#endif
+
+            constexpr T* ptr(std::size_t i) noexcept
+            {
+                return data_ + i;
+            }
+
+            constexpr const T* ptr(std::size_t i) const noexcept
+            {
+                return data_ + i;
+            }
+
+            template <typename... Args>
+            constexpr void construct(std::size_t i, Args&&... args)
+            {
+                data_[i] = T(std::forward<Args>(args)...);
+            }
+
+            constexpr void destroy(std::size_t) noexcept
+            {
+            }
+
+            std::size_t size_ = 0;
+#ifdef __cpp_lib_is_constant_evaluated
+            T data_[N == 0 ? 1 : N];
+#else
+            T data_[N == 0 ? 1 : N] = {};
+#endif
+        };
+
+        // Everything else lives in uninitialized storage, elements are only constructed once
+        // they are added and destroyed once they are removed.
+        template <typename T, std::size_t N>
+        class static_vector_storage<T, N, false>
+        {
+        protected:
+            static_vector_storage() = default;
+
+            // delegating to the default constructor makes the destructor clean up, if a copy throws
+            static_vector_storage(const static_vector_storage& other) : static_vector_storage()
+            {
+                for (; size_ < other.size_; ++size_)
+                {
+                    construct(size_, *other.ptr(size_));
+                }
+            }
+
+            static_vector_storage(static_vector_storage&& other) noexcept(
+                std::is_nothrow_move_constructible<T>::value)
+            : static_vector_storage()
+            {
+                for (; size_ < other.size_; ++size_)
+                {
+                    construct(size_, std::move(*other.ptr(size_)));
+                }
+            }
+
+            static_vector_storage& operator=(const static_vector_storage& other)
+            {
+                if (this != &other)
+                {
+                    assign(other, [](const T& t) -> const T& { return t; });
+                }
+
+                return *this;
+            }
+
+            static_vector_storage& operator=(static_vector_storage&& other) noexcept(
+                std::is_nothrow_move_assignable<T>::value&&
+                    std::is_nothrow_move_constructible<T>::value)
+            {
+                if (this != &other)
+                {
+                    assign(other, [](T& t) -> T&& { return std::move(t); });
+                }
+
+                return *this;
+            }
+
+            ~static_vector_storage()
+            {
+                while (size_ > 0)
+                {
+                    destroy(--size_);
+                }
+            }
+
+            T* ptr(std::size_t i) noexcept
+            {
+                return reinterpret_cast<T*>(data_) + i;
+            }
+
+            const T* ptr(std::size_t i) const noexcept
+            {
+                return reinterpret_cast<const T*>(data_) + i;
+            }
+
+            template <typename... Args>
+            void construct(std::size_t i, Args&&... args)
+            {
+                ::new (static_cast<void*>(ptr(i))) T(std::forward<Args>(args)...);
+            }
+
+            void destroy(std::size_t i) noexcept
+            {
+                ptr(i)->~T();
+            }
+
+            std::size_t size_ = 0;
+
+        private:
+            template <typename Storage, typename Cast>
+            void assign(Storage& other, Cast cast)
+            {
+                std::size_t i = 0;
+
+                for (; i < size_ && i < other.size_; ++i)
+                {
+                    *ptr(i) = cast(*other.ptr(i));
+                }
+
+                for (; i < other.size_; ++i, ++size_)
+                {
+                    construct(i, cast(*other.ptr(i)));
+                }
+
+                while (size_ > other.size_)
+                {
+                    destroy(--size_);
+                }
+            }
+
+            alignas(T) unsigned char data_[(N == 0 ? 1 : N) * sizeof(T)];
+        };
+    } // namespace detail
+
+    /**
+     * \brief A vector with a compile time capacity and inline storage
+     *
+     * Offers the same interface as fixed_vector, but never allocates. Elements are constructed
+     * on insertion and destroyed on removal, so T does not need to be default constructible.
+     */
+    template <typename T, std::size_t N>
+    class static_vector : private detail::static_vector_storage<T, N>
+    {
+        using base = detail::static_vector_storage<T, N>;
+        using base::ptr;
+        using base::construct;
+        using base::destroy;
+        using base::size_;
+
+    public:
+        using value_type = T;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using size_type = std::size_t;
+        using iterator = value_type*;
+        using const_iterator = const value_type*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr static_vector() = default;
+
+        template <typename Iterabel>
+        constexpr explicit static_vector(const Iterabel& array)
+        {
+            push_back(array.begin(), array.end());
+        }
+
+        constexpr static_vector(std::initializer_list<value_type> list)
+        {
+            push_back(list.begin(), list.end());
+        }
+
+        constexpr static_vector(const static_vector&) = default;
+        constexpr static_vector(static_vector&&) = default;
+
+        static_vector& operator=(const static_vector&) = default;
+        static_vector& operator=(static_vector&&) = default;
+
+        constexpr static_vector& operator=(std::initializer_list<value_type> list)
+        {
+            clear();
+            push_back(list.begin(), list.end());
+
+            return *this;
+        }
+
+        constexpr bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        constexpr size_type size() const
+        {
+            return size_;
+        }
+
+        static constexpr size_type capacity()
+        {
+            return N;
+        }
+
+        constexpr reference operator[](const size_type& key)
+        {
+            return *ptr(key);
+        }
+
+        constexpr const_reference operator[](const size_type& key) const
+        {
+            return *ptr(key);
+        }
+
+        constexpr reference at(const size_type& key)
+        {
+            if (key >= N)
+                raise("Key is larger than capacity!");
+
+            if (key >= size_)
+                raise("Key is larger than size, use emplace_back() instead!");
+
+            return *ptr(key);
+        }
+
+        constexpr const_reference at(const size_type& key) const
+        {
+            if (key >= N)
+                raise("Key is larger than capacity!");
+
+            if (key >= size_)
+                raise("Key is larger than size, use emplace_back() instead!");
+
+            return *ptr(key);
+        }
+
+        constexpr reference front() noexcept
+        {
+            return *ptr(0);
+        }
+
+        constexpr const_reference front() const noexcept
+        {
+            return *ptr(0);
+        }
+
+        constexpr reference back() noexcept
+        {
+            return *ptr(size_ - 1);
+        }
+
+        constexpr const_reference back() const noexcept
+        {
+            return *ptr(size_ - 1);
+        }
+
+        template <class... Args>
+        constexpr void emplace(const_iterator pos, Args&&... args)
+        {
+            size_type key = pos - begin();
+
+            if (key > size_)
+                raise("Key larger than size!");
+
+            if (size_ >= N)
+                raise("No capacity left!");
+
+            if (key == size_)
+            {
+                construct(size_, std::forward<Args>(args)...);
+                ++size_;
+                return;
+            }
+
+            // the arguments might refer to elements, which are moved below
+            value_type value(std::forward<Args>(args)...);
+
+            construct(size_, std::move(*ptr(size_ - 1)));
+            ++size_;
+
+            for (size_type i = size_ - 2; i > key; --i)
+            {
+                *ptr(i) = std::move(*ptr(i - 1));
+            }
+
+            *ptr(key) = std::move(value);
+        }
+
+        template <class... Args>
+        constexpr size_type emplace_back(Args&&... args)
+        {
+            if (size_ >= N)
+                raise("No capacity left!");
+
+            construct(size_, std::forward<Args>(args)...);
+            ++size_;
+
+            return size_ - 1;
+        }
+
+        constexpr size_type insert(const_reference value)
+        {
+            return emplace_back(value);
+        }
+
+        constexpr size_type insert(value_type&& value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        /// Writes [start, end) starting at pos, overwriting elements and appending the rest
+        template <typename Iter>
+        constexpr void insert(const_iterator pos, Iter start, Iter end)
+        {
+            size_type key = pos - begin();
+
+            if (key > size_)
+                raise("Key larger than size!");
+
+            for (; start != end; ++start, ++key)
+            {
+                if (key >= N)
+                    raise("No capacity left!");
+
+                if (key < size_)
+                {
+                    *ptr(key) = *start;
+                }
+                else
+                {
+                    construct(key, *start);
+                    ++size_;
+                }
+            }
+        }
+
+        constexpr void insert(const_iterator pos, std::initializer_list<value_type> list)
+        {
+            insert(pos, list.begin(), list.end());
+        }
+
+        constexpr size_type push_back(const_reference value)
+        {
+            return emplace_back(value);
+        }
+
+        constexpr size_type push_back(value_type&& value)
+        {
+            return emplace_back(std::move(value));
+        }
+
+        template <typename Iter>
+        constexpr void push_back(Iter start, Iter end)
+        {
+            insert(this->end(), start, end);
+        }
+
+        constexpr void pop_back()
+        {
+            if (size_ == 0)
+                raise("Container is empty!");
+
+            --size_;
+            destroy(size_);
+        }
+
+        constexpr void erase(const_iterator pos)
+        {
+            size_type key = pos - begin();
+
+            if (key >= size_)
+                raise("Key does not exist!");
+
+            for (; key + 1 < size_; ++key)
+            {
+                *ptr(key) = std::move(*ptr(key + 1));
+            }
+
+            --size_;
+            destroy(size_);
+        }
+
+        constexpr void clear() noexcept
+        {
+            while (size_ > 0)
+            {
+                destroy(--size_);
+            }
+        }
+
+        constexpr iterator begin() noexcept
+        {
+            return ptr(0);
+        }
+
+        constexpr iterator end() noexcept
+        {
+            return ptr(size_);
+        }
+
+        constexpr const_iterator begin() const noexcept
+        {
+            return ptr(0);
+        }
+
+        constexpr const_iterator end() const noexcept
+        {
+            return ptr(size_);
+        }
+
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return ptr(0);
+        }
+
+        constexpr const_iterator cend() const noexcept
+        {
+            return ptr(size_);
+        }
+
+        reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+
+        reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+
+        const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        const_reverse_iterator crbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator crend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        constexpr pointer data() noexcept
+        {
+            return ptr(0);
+        }
+
+        constexpr const_pointer data() const noexcept
+        {
+            return ptr(0);
+        }
+    };
+
+} // namespace lang
+} // namespace nitro
+
+namespace std
+{
+template <size_t I, typename T, size_t N>
+T& get(nitro::lang::static_vector<T, N>& c) noexcept
+{
+    static_assert(I < N, "Index out of bounds");
+    return c[I];
+}
+
+template <size_t I, typename T, size_t N>
+const T& get(const nitro::lang::static_vector<T, N>& c) noexcept
+{
+    static_assert(I < N, "Index out of bounds");
+    return c[I];
+}
+} // namespace std
@@ -29,48 +29,164 @@
 #pragma once
 
 #include <nitro/except/raise.hpp>
+#include <nitro/lang/detail/bits.hpp>
 
+#include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
 namespace nitro
 {
 namespace lang
 {
-    template <typename InputIterator>
-    std::string join(InputIterator begin, InputIterator end,
-                     const std::string& infix = std::string(" "))
+    namespace detail
     {
-        if (begin == end)
-            return {};
+        struct join_chars
+        {
+            const char* data;
+            std::size_t size;
+        };
 
-        std::stringstream s;
+        template <typename Traits, typename Allocator>
+        inline join_chars as_join_chars(const std::basic_string<char, Traits, Allocator>& s)
+        {
+            return { s.data(), s.size() };
+        }
 
-        auto it = begin;
+#if __cplusplus >= 201703L
+        template <typename Traits>
+        inline join_chars as_join_chars(const std::basic_string_view<char, Traits>& s)
+        {
+            return { s.data(), s.size() };
+        }
+#endif
 
-        for (; it + 1 != end; ++it)
+        inline join_chars as_join_chars(const char* s)
         {
-            auto pos = s.tellp();
+            return { s, s == nullptr ? 0 : std::strlen(s) };
+        }
 
-            s << *it;
+        template <typename T, typename = void>
+        struct is_joined_directly : std::false_type
+        {
+        };
 
-            if (s.tellp() != pos)
+        template <typename T>
+        struct is_joined_directly<T, decltype(as_join_chars(std::declval<const T&>()), void())>
+        : std::true_type
+        {
+        };
+
+        // strings are measured first, so the result is allocated once
+        template <typename ForwardIterator>
+        std::string join(ForwardIterator begin, ForwardIterator end, const std::string& infix,
+                         std::true_type)
+        {
+            std::size_t size = 0;
+            std::size_t count = 0;
+
+            for (auto it = begin; it != end; ++it)
+            {
+                const auto& value = *it;
+                auto chars = as_join_chars(value);
+
+                if (chars.size > 0)
+                {
+                    size += chars.size;
+                    ++count;
+                }
+            }
+
+            std::string result;
+
+            if (count == 0)
             {
-                s << infix;
+                return result;
             }
-        }
 
-        s << *it;
+            result.reserve(size + (count - 1) * infix.size());
 
-        auto str = s.str();
+            for (auto it = begin; it != end; ++it)
+            {
+                const auto& value = *it;
+                auto chars = as_join_chars(value);
 
-        if (!str.empty() && str.back() == ' ')
+                if (chars.size == 0)
+                {
+                    continue;
+                }
+
+                if (!result.empty())
+                {
+                    result.append(infix);
+                }
+
+                result.append(chars.data, chars.size);
+            }
+
+            return result;
+        }
+
+        // everything else is formatted with operator<< into a reused stream
+        template <typename InputIterator>
+        std::string join(InputIterator begin, InputIterator end, const std::string& infix,
+                         std::false_type)
         {
-            return str.substr(0, str.size() - 1);
+            std::string result;
+            std::ostringstream s;
+
+            for (auto it = begin; it != end; ++it)
+            {
+                s.str(std::string());
+                s << *it;
+
+                auto piece = s.str();
+
+                if (piece.empty())
+                {
+                    continue;
+                }
+
+                if (!result.empty())
+                {
+                    result.append(infix);
+                }
+
+                result.append(piece);
+            }
+
+            return result;
         }
+    } // namespace detail
 
-        return str;
+    /**
+     * \brief Joins the elements of the range with infix between them, skipping empty elements
+     *
+     * Strings are copied directly into the presized result, other elements are formatted with
+     * operator<<.
+     */
+    template <typename InputIterator>
+    std::string join(InputIterator begin, InputIterator end,
+                     const std::string& infix = std::string(" "))
+    {
+        using traits = std::iterator_traits<InputIterator>;
+
+        // measuring the strings first needs a second pass over the range
+        using presized = std::integral_constant<
+            bool, detail::is_joined_directly<typename traits::value_type>::value &&
+                      std::is_base_of<std::forward_iterator_tag,
+                                      typename traits::iterator_category>::value>;
+
+        return detail::join(begin, end, infix, presized());
     }
 
     inline std::string join(const std::vector<std::string>& strs,
@@ -79,38 +195,245 @@ namespace lang
         return join(strs.begin(), strs.end(), infix);
     }
 
-    inline std::vector<std::string> split(const std::string& haystack, const std::string& needle)
+    namespace detail
     {
-        if (needle.empty())
+        constexpr std::size_t string_npos = static_cast<std::size_t>(-1);
+
+        /**
+         * \brief Returns the first position of needle in data at or after from, or string_npos
+         *
+         * Candidates for the first character are found with memchr, which the C library
+         * vectorizes. If the first character is common, so that many candidates don't match,
+         * SSE2 compares the first and last character of the needle at 16 positions at once
+         * instead, and only compares the candidates matching both in full.
+         */
+        inline std::size_t find_substring(const char* data, std::size_t size, const char* needle,
+                                          std::size_t needle_size, std::size_t from = 0)
         {
-            raise("needle must not be empty");
-        }
+            if (needle_size > size || from > size - needle_size)
+            {
+                return string_npos;
+            }
 
-        std::vector<std::string> result;
+            auto last_start = size - needle_size;
+            auto pos = from;
+            std::size_t misses = 0;
 
-        std::string::size_type start = 0;
+#ifdef NITRO_LANG_SSE2
+            const auto first = _mm_set1_epi8(needle[0]);
+            const auto last = _mm_set1_epi8(needle[needle_size - 1]);
+#endif
 
-        while (true)
+            while (pos <= last_start)
+            {
+#ifdef NITRO_LANG_SSE2
+                // single character needles never miss, so needle_size is at least 2 here
+                if (misses >= 8 && last_start - pos >= 15)
+                {
+                    auto block_first =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                    auto block_last = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + pos + needle_size - 1));
+
+                    auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+                        _mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+
+                    for (; mask != 0; mask &= mask - 1)
+                    {
+                        auto candidate = pos + static_cast<std::size_t>(countr_zero(mask));
+
+                        if (std::memcmp(data + candidate + 1, needle + 1, needle_size - 2) == 0)
+                        {
+                            return candidate;
+                        }
+                    }
+
+                    pos += 16;
+                    continue;
+                }
+#endif
+
+                auto hit = static_cast<const char*>(
+                    std::memchr(data + pos, needle[0], last_start - pos + 1));
+
+                if (hit == nullptr)
+                {
+                    return string_npos;
+                }
+
+                pos = static_cast<std::size_t>(hit - data);
+
+                if (std::memcmp(data + pos + 1, needle + 1, needle_size - 1) == 0)
+                {
+                    return pos;
+                }
+
+                ++pos;
+                ++misses;
+            }
+
+            return string_npos;
+        }
+
+        // walks the pieces between the occurrences of the needle, including empty ones
+        class split_cursor
         {
-            auto pos = haystack.find(needle, start);
-            if (pos != std::string::npos)
+        public:
+            split_cursor() = default;
+
+            split_cursor(const char* data, std::size_t size, const char* needle,
+                         std::size_t needle_size)
+            : data_(data), size_(size), needle_(needle), needle_size_(needle_size), done_(false)
             {
-                if (start < pos)
+                if (needle_size == 0)
                 {
-                    result.emplace_back(haystack.substr(start, pos - start));
+                    raise("needle must not be empty");
                 }
-                else
+
+                find_end();
+            }
+
+            const char* data() const noexcept
+            {
+                return data_ + begin_;
+            }
+
+            std::size_t size() const noexcept
+            {
+                return end_ - begin_;
+            }
+
+            bool done() const noexcept
+            {
+                return done_;
+            }
+
+            void advance()
+            {
+                if (end_ == size_)
                 {
-                    result.emplace_back(std::string());
+                    done_ = true;
+                    return;
                 }
 
-                start = pos + needle.size();
+                begin_ = end_ + needle_size_;
+                find_end();
             }
-            else
+
+            friend bool operator==(const split_cursor& a, const split_cursor& b) noexcept
             {
-                result.emplace_back(haystack.substr(start));
-                break;
+                return a.done_ == b.done_ && (a.done_ || a.begin_ == b.begin_);
             }
+
+        private:
+            void find_end()
+            {
+                end_ = find_substring(data_, size_, needle_, needle_size_, begin_);
+
+                if (end_ == string_npos)
+                {
+                    end_ = size_;
+                }
+            }
+
+            const char* data_ = nullptr;
+            std::size_t size_ = 0;
+            const char* needle_ = nullptr;
+            std::size_t needle_size_ = 0;
+            std::size_t begin_ = 0;
+            std::size_t end_ = 0;
+            bool done_ = true;
+        };
+    } // namespace detail
+
+#if __cplusplus >= 201703L
+    /**
+     * \brief A lazy range of the pieces of haystack between the occurrences of needle
+     *
+     * The pieces are views into haystack, so haystack and needle have to outlive the split_view.
+     * Like split, it yields empty pieces between adjacent needles and at either end.
+     */
+    class split_view
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = std::string_view;
+
+            iterator() = default;
+
+            std::string_view operator*() const noexcept
+            {
+                return { cursor_.data(), cursor_.size() };
+            }
+
+            iterator& operator++()
+            {
+                cursor_.advance();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+
+            friend bool operator==(const iterator& a, const iterator& b) noexcept
+            {
+                return a.cursor_ == b.cursor_;
+            }
+
+            friend bool operator!=(const iterator& a, const iterator& b) noexcept
+            {
+                return !(a == b);
+            }
+
+        private:
+            friend class split_view;
+
+            explicit iterator(const detail::split_cursor& cursor) : cursor_(cursor)
+            {
+            }
+
+            detail::split_cursor cursor_;
+        };
+
+        split_view(std::string_view haystack, std::string_view needle)
+        : first_(haystack.data(), haystack.size(), needle.data(), needle.size())
+        {
+        }
+
+        iterator begin() const
+        {
+            return iterator(first_);
+        }
+
+        iterator end() const
+        {
+            return {};
+        }
+
+    private:
+        detail::split_cursor first_;
+    };
+#endif
+
+    inline std::vector<std::string> split(const std::string& haystack, const std::string& needle)
+    {
+        std::vector<std::string> result;
+
+        for (detail::split_cursor cursor(haystack.data(), haystack.size(), needle.data(),
+                                         needle.size());
+             !cursor.done(); cursor.advance())
+        {
+            result.emplace_back(cursor.data(), cursor.size());
         }
 
         return result;
@@ -121,15 +444,126 @@ namespace lang
         return full.find(beginning) == 0;
     }
 
+    /// replaces every occurrence of to_replace in str, occurrences in replacement are kept
     inline void replace_all(std::string& str, const std::string& to_replace,
                             const std::string& replacement)
     {
-        size_t start_pos = 0;
-        while ((start_pos = str.find(to_replace, start_pos)) != std::string::npos)
+        if (to_replace.empty())
+        {
+            return;
+        }
+
+        auto pos =
+            detail::find_substring(str.data(), str.size(), to_replace.data(), to_replace.size());
+
+        if (pos == detail::string_npos)
+        {
+            return;
+        }
+
+        if (to_replace.size() == replacement.size())
+        {
+            for (; pos != detail::string_npos;
+                 pos = detail::find_substring(str.data(), str.size(), to_replace.data(),
+                                              to_replace.size(), pos + to_replace.size()))
+            {
+                str.replace(pos, to_replace.size(), replacement);
+            }
+
+            return;
+        }
+
+        std::string result;
+        result.reserve(str.size());
+
+        std::size_t start = 0;
+
+        for (; pos != detail::string_npos;
+             pos = detail::find_substring(str.data(), str.size(), to_replace.data(),
+                                          to_replace.size(), start))
+        {
+            result.append(str, start, pos - start);
+            result.append(replacement);
+            start = pos + to_replace.size();
+        }
+
+        result.append(str, start, std::string::npos);
+        str.swap(result);
+    }
+
+    /**
+     * \brief Replaces the occurrences of several patterns in a single scan of str
+     *
+     * At each position, the earliest occurrence of any pattern is replaced, on ties the first
+     * listed pattern wins. Replacements are not scanned again.
+     */
+    inline void replace_all(std::string& str,
+                            const std::vector<std::pair<std::string, std::string>>& replacements)
+    {
+        // the next occurrence of every pattern, empty patterns never occur
+        std::vector<std::size_t> next;
+        next.reserve(replacements.size());
+
+        for (const auto& replacement : replacements)
+        {
+            next.push_back(replacement.first.empty() ?
+                               detail::string_npos :
+                               detail::find_substring(str.data(), str.size(),
+                                                      replacement.first.data(),
+                                                      replacement.first.size()));
+        }
+
+        std::string result;
+        std::size_t start = 0;
+
+        while (true)
+        {
+            auto earliest = detail::string_npos;
+            std::size_t index = 0;
+
+            for (std::size_t i = 0; i < next.size(); i++)
+            {
+                if (next[i] < earliest)
+                {
+                    earliest = next[i];
+                    index = i;
+                }
+            }
+
+            if (earliest == detail::string_npos)
+            {
+                break;
+            }
+
+            if (result.empty())
+            {
+                result.reserve(str.size());
+            }
+
+            result.append(str, start, earliest - start);
+            result.append(replacements[index].second);
+            start = earliest + replacements[index].first.size();
+
+            // occurrences overlapping the replaced one are skipped
+            for (std::size_t i = 0; i < next.size(); i++)
+            {
+                if (next[i] != detail::string_npos && next[i] < start)
+                {
+                    next[i] = detail::find_substring(str.data(), str.size(),
+                                                     replacements[i].first.data(),
+                                                     replacements[i].first.size(), start);
+                }
+            }
+        }
+
+        // every replaced occurrence moves start, so nothing was replaced
+        if (start == 0)
         {
-            str.replace(start_pos, to_replace.length(), replacement);
-            start_pos += replacement.length();
+            return;
         }
+
+        result.append(str, start, std::string::npos);
+        str.swap(result);
     }
 } // namespace lang
 } // namespace nitro
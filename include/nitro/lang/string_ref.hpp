@@ -30,16 +30,32 @@
 #define INCLUDE_NITRO_LANG_STRING_REF_HPP
 
 #include <nitro/except/raise.hpp>
+#include <nitro/lang/string.hpp>
 
+#include <algorithm>
+#include <ostream>
 #include <string>
+#include <type_traits>
 
+#include <cstddef>
 #include <cstring>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
 namespace nitro
 {
 namespace lang
 {
 
+    /**
+     * \brief A non-owning reference to a string, which knows its length
+     *
+     * A string_ref created from a std::string or a C string is null-terminated, so get() can be
+     * passed to C functions. Substrings and string_refs created from a std::string_view or an
+     * explicit length generally are not.
+     */
     class string_ref
     {
 
@@ -48,13 +64,26 @@ namespace lang
     public:
         using iterator = const char*;
 
-        string_ref(const std::string& str) : ptr_(str.c_str())
+        static constexpr std::size_t npos = std::string::npos;
+
+        string_ref(const std::string& str) : ptr_(str.c_str()), size_(str.size())
+        {
+        }
+
+        string_ref(const char* const pstr)
+        : ptr_(pstr), size_(pstr == nullptr ? 0 : std::strlen(pstr))
+        {
+        }
+
+        string_ref(const char* const pstr, std::size_t size) : ptr_(pstr), size_(size)
         {
         }
 
-        string_ref(const char* const pstr) : ptr_(pstr)
+#if __cplusplus >= 201703L
+        string_ref(std::string_view str) : ptr_(str.data()), size_(str.size())
         {
         }
+#endif
 
     public:
         char at(std::size_t i) const
@@ -74,12 +103,12 @@ namespace lang
 
         std::size_t size() const noexcept
         {
-            return std::strlen(const_cast<pointer_type>(ptr_));
+            return size_;
         }
 
         bool empty() const
         {
-            return ptr_ == nullptr ? true : ptr_[0] == '\0';
+            return size_ == 0;
         }
 
         iterator begin() const noexcept
@@ -89,12 +118,12 @@ namespace lang
 
         iterator end() const noexcept
         {
-            return ptr_ + size();
+            return ptr_ + size_;
         }
 
         std::string str() const
         {
-            return { ptr_ };
+            return ptr_ == nullptr ? std::string() : std::string(ptr_, size_);
         }
 
         pointer_type get() const
@@ -102,12 +131,63 @@ namespace lang
             return ptr_;
         }
 
+        pointer_type data() const noexcept
+        {
+            return ptr_;
+        }
+
+        /// the part of this string starting at pos with at most count characters
+        string_ref substr(std::size_t pos, std::size_t count = npos) const
+        {
+            if (pos > size_)
+            {
+                raise("Position to large for given string");
+            }
+
+            return { ptr_ + pos, std::min(count, size_ - pos) };
+        }
+
+        std::size_t find(string_ref needle, std::size_t pos = 0) const noexcept
+        {
+            if (needle.empty())
+            {
+                return pos <= size_ ? pos : npos;
+            }
+
+            return detail::find_substring(ptr_, size_, needle.ptr_, needle.size_, pos);
+        }
+
+        std::size_t find(char c, std::size_t pos = 0) const noexcept
+        {
+            return find(string_ref(&c, 1), pos);
+        }
+
+        bool starts_with(string_ref prefix) const noexcept
+        {
+            return prefix.size_ <= size_ &&
+                   (prefix.size_ == 0 || std::memcmp(ptr_, prefix.ptr_, prefix.size_) == 0);
+        }
+
+        bool ends_with(string_ref suffix) const noexcept
+        {
+            return suffix.size_ <= size_ &&
+                   (suffix.size_ == 0 ||
+                    std::memcmp(ptr_ + size_ - suffix.size_, suffix.ptr_, suffix.size_) == 0);
+        }
+
     public:
         operator std::string() const
         {
             return str();
         }
 
+#if __cplusplus >= 201703L
+        operator std::string_view() const noexcept
+        {
+            return { ptr_, size_ };
+        }
+#endif
+
         explicit operator bool() const
         {
             return !empty();
@@ -119,6 +199,7 @@ namespace lang
 
     private:
         pointer_type ptr_;
+        std::size_t size_;
     };
 
     inline bool operator==(const string_ref& a, const string_ref& b)
@@ -127,7 +208,8 @@ namespace lang
         {
             return false;
         }
-        return std::strcmp(a.ptr_, b.ptr_) == 0;
+
+        return a.size_ == b.size_ && (a.size_ == 0 || std::memcmp(a.ptr_, b.ptr_, a.size_) == 0);
     }
 
     inline bool operator!=(const string_ref& a, const string_ref& b)
@@ -135,9 +217,43 @@ namespace lang
         return !(a == b);
     }
 
+#if __cplusplus >= 201703L
+    namespace detail
+    {
+        template <typename View>
+        using if_string_view = std::enable_if_t<std::is_same<View, std::string_view>::value>;
+    } // namespace detail
+
+    // string_ref and std::string_view convert into each other, so these resolve the ambiguity.
+    // They are templates, so std::string and C strings still convert to string_ref.
+    template <typename View, typename = detail::if_string_view<View>>
+    inline bool operator==(const string_ref& a, const View& b)
+    {
+        return a == string_ref(b);
+    }
+
+    template <typename View, typename = detail::if_string_view<View>>
+    inline bool operator==(const View& a, const string_ref& b)
+    {
+        return string_ref(a) == b;
+    }
+
+    template <typename View, typename = detail::if_string_view<View>>
+    inline bool operator!=(const string_ref& a, const View& b)
+    {
+        return !(a == b);
+    }
+
+    template <typename View, typename = detail::if_string_view<View>>
+    inline bool operator!=(const View& a, const string_ref& b)
+    {
+        return !(a == b);
+    }
+#endif
+
     inline std::ostream& operator<<(std::ostream& s, const string_ref& str)
     {
-        return s << str.ptr_;
+        return s.write(str.ptr_, static_cast<std::streamsize>(str.size_));
     }
 } // namespace lang
 } // namespace nitro
@@ -0,0 +1,654 @@
+/*
+ * Copyright (c) 2015-2021, Technische Universität Dresden, Germany
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted
+ * provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of
+ *    conditions and the following disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to
+ *    endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY
+ * WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <nitro/except/raise.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nitro
+{
+namespace lang
+{
+    namespace detail
+    {
+        class pool_task
+        {
+        public:
+            virtual ~pool_task() = default;
+            virtual void run() = 0;
+        };
+
+        template <typename F>
+        class pool_task_impl : public pool_task
+        {
+        public:
+            explicit pool_task_impl(F&& f) : f_(std::move(f))
+            {
+            }
+
+            void run() override
+            {
+                f_();
+            }
+
+        private:
+            F f_;
+        };
+
+        /**
+         * \brief The work-stealing deque of Chase and Lev, with the memory orders of Lê et al.,
+         * "Correct and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013
+         *
+         * The owner pushes and takes at the bottom, other threads steal from the top. Only the
+         * owner may call push() and take(). Replaced buffers are kept until the deque is
+         * destroyed, as thieves might still read from them.
+         */
+        class work_stealing_deque
+        {
+            struct buffer
+            {
+                explicit buffer(std::int64_t capacity)
+                : mask(capacity - 1), slots(new std::atomic<pool_task*>[capacity])
+                {
+                }
+
+                pool_task* get(std::int64_t i) const noexcept
+                {
+                    return slots[i & mask].load(std::memory_order_relaxed);
+                }
+
+                void put(std::int64_t i, pool_task* task) noexcept
+                {
+                    slots[i & mask].store(task, std::memory_order_relaxed);
+                }
+
+                std::int64_t mask;
+                std::unique_ptr<std::atomic<pool_task*>[]> slots;
+            };
+
+        public:
+            explicit work_stealing_deque(std::int64_t capacity = 256)
+            {
+                buffers_.emplace_back(new buffer(capacity));
+                buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+            }
+
+            void push(pool_task* task)
+            {
+                auto b = bottom_.load(std::memory_order_relaxed);
+                auto t = top_.load(std::memory_order_acquire);
+                auto a = buffer_.load(std::memory_order_relaxed);
+
+                if (b - t > a->mask)
+                {
+                    a = grow(a, t, b);
+                }
+
+                a->put(b, task);
+                bottom_.store(b + 1, std::memory_order_release);
+            }
+
+            pool_task* take()
+            {
+                auto b = bottom_.load(std::memory_order_relaxed) - 1;
+                auto a = buffer_.load(std::memory_order_relaxed);
+
+                // the store of bottom has to be ordered before the load of top
+                bottom_.store(b, std::memory_order_seq_cst);
+                auto t = top_.load(std::memory_order_seq_cst);
+
+                if (t > b)
+                {
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                auto task = a->get(b);
+
+                if (t == b)
+                {
+                    // the last task, race against the thieves for it
+                    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+                    {
+                        task = nullptr;
+                    }
+
+                    bottom_.store(b + 1, std::memory_order_relaxed);
+                }
+
+                return task;
+            }
+
+            pool_task* steal()
+            {
+                auto t = top_.load(std::memory_order_seq_cst);
+                auto b = bottom_.load(std::memory_order_seq_cst);
+
+                if (t >= b)
+                {
+                    return nullptr;
+                }
+
+                auto task = buffer_.load(std::memory_order_acquire)->get(t);
+
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed))
+                {
+                    return nullptr;
+                }
+
+                return task;
+            }
+
+        private:
+            buffer* grow(buffer* old, std::int64_t t, std::int64_t b)
+            {
+                buffers_.emplace_back(new buffer(2 * (old->mask + 1)));
+                auto bigger = buffers_.back().get();
+
+                for (auto i = t; i < b; i++)
+                {
+                    bigger->put(i, old->get(i));
+                }
+
+                buffer_.store(bigger, std::memory_order_release);
+                return bigger;
+            }
+
+            // thieves write top and the owner writes bottom, keep them on different cache lines
+            std::atomic<std::int64_t> top_{ 0 };
+            char padding_[64];
+            std::atomic<std::int64_t> bottom_{ 0 };
+            std::atomic<buffer*> buffer_;
+            std::vector<std::unique_ptr<buffer>> buffers_;
+        };
+
+        // the first exception of any task is rethrown once all of them are done
+        class parallel_exception
+        {
+        public:
+            template <typename F>
+            void run(F&& f) noexcept
+            {
+                try
+                {
+                    f();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!exception_)
+                    {
+                        exception_ = std::current_exception();
+                    }
+                }
+            }
+
+            void rethrow()
+            {
+                if (exception_)
+                {
+                    std::rethrow_exception(exception_);
+                }
+            }
+
+        private:
+            std::mutex mutex_;
+            std::exception_ptr exception_;
+        };
+
+        /// the CPUs this process may run on, empty if unknown
+        inline std::vector<int> affinity_cpus()
+        {
+            std::vector<int> cpus;
+
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                {
+                    if (CPU_ISSET(cpu, &set))
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+#endif
+
+            return cpus;
+        }
+
+        inline void pin_current_thread(int cpu)
+        {
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+            (void)cpu;
+#endif
+        }
+    } // namespace detail
+
+    /**
+     * \brief Counts outstanding work, wait() blocks until it is done
+     *
+     * Call add() before starting work and done() when each part finishes.
+     */
+    class wait_group
+    {
+    public:
+        explicit wait_group(std::size_t count = 0) : count_(count)
+        {
+        }
+
+        wait_group(const wait_group&) = delete;
+        wait_group& operator=(const wait_group&) = delete;
+
+        void add(std::size_t count = 1)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count_ += count;
+        }
+
+        void done()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (--count_ == 0)
+            {
+                finished_.notify_all();
+            }
+        }
+
+        bool finished() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return count_ == 0;
+        }
+
+        void wait() const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            finished_.wait(lock, [this]() { return count_ == 0; });
+        }
+
+        /// returns whether the work is done
+        template <typename Rep, typename Period>
+        bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return finished_.wait_for(lock, timeout, [this]() { return count_ == 0; });
+        }
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::condition_variable finished_;
+        std::size_t count_;
+    };
+
+    /**
+     * \brief A thread pool, where every worker has its own work-stealing deque
+     *
+     * Tasks submitted by a worker go to its own deque and run in LIFO order, while idle workers
+     * steal the oldest tasks of others. Tasks from other threads go to a shared queue. Waiting
+     * for a wait_group with wait() runs other tasks in the meantime, so tasks may wait for
+     * tasks they started.
+     *
+     * shutdown(), also called by the destructor, runs all tasks already submitted before it
+     * joins the workers.
+     */
+    class thread_pool
+    {
+        struct worker
+        {
+            detail::work_stealing_deque deque;
+            std::thread thread;
+        };
+
+        struct current
+        {
+            thread_pool* pool;
+            std::size_t index;
+        };
+
+        static current& this_worker()
+        {
+            static thread_local current c{ nullptr, 0 };
+            return c;
+        }
+
+    public:
+        /// threads == 0 starts one thread for each CPU this process may use
+        explicit thread_pool(std::size_t threads = 0, bool pin_threads = false)
+        {
+            auto cpus = detail::affinity_cpus();
+
+            if (threads == 0)
+            {
+                threads = cpus.empty() ?
+                              std::max<std::size_t>(std::thread::hardware_concurrency(), 1) :
+                              cpus.size();
+            }
+
+            if (cpus.empty())
+            {
+                pin_threads = false;
+            }
+
+            for (std::size_t i = 0; i < threads; i++)
+            {
+                workers_.emplace_back(new worker());
+            }
+
+            for (std::size_t i = 0; i < threads; i++)
+            {
+                int cpu = pin_threads ? cpus[i % cpus.size()] : -1;
+                workers_[i]->thread = std::thread([this, i, cpu]() { work(i, cpu); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            shutdown();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        /// runs f() in the pool without a way to wait for it, f must not throw
+        template <typename F>
+        void post(F&& f)
+        {
+            push(new detail::pool_task_impl<std::decay_t<F>>(std::forward<F>(f)));
+        }
+
+        /// runs f() in the pool, the future returns its result or exception
+        template <typename F>
+        auto submit(F&& f) -> std::future<decltype(f())>
+        {
+            using result_type = decltype(f());
+
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(f));
+            auto result = task->get_future();
+
+            post([task]() { (*task)(); });
+
+            return result;
+        }
+
+        /// waits for the wait_group, and runs tasks from the pool meanwhile
+        void wait(const wait_group& group)
+        {
+            auto& self = this_worker();
+            auto index = self.pool == this ? self.index : workers_.size();
+
+            while (!group.finished())
+            {
+                if (auto task = find_task(index))
+                {
+                    run(task);
+                }
+                else
+                {
+                    group.wait_for(std::chrono::microseconds(100));
+                }
+            }
+        }
+
+        /**
+         * \brief Calls f(i) for all i in [begin, end) in the pool and waits for it
+         *
+         * The range is split into tasks of grain_size indices, 0 picks a few tasks per thread.
+         * If f throws, the first exception is rethrown once all tasks are done.
+         */
+        template <typename F>
+        void parallel_for(std::size_t begin, std::size_t end, F&& f, std::size_t grain_size = 0)
+        {
+            if (begin >= end)
+            {
+                return;
+            }
+
+            auto count = end - begin;
+
+            if (grain_size == 0)
+            {
+                grain_size = std::max<std::size_t>((count + 4 * size() - 1) / (4 * size()), 1);
+            }
+
+            auto tasks = (count + grain_size - 1) / grain_size;
+
+            wait_group group(tasks);
+            detail::parallel_exception error;
+
+            for (std::size_t t = 0; t < tasks; t++)
+            {
+                auto first = begin + t * grain_size;
+                auto last = std::min(first + grain_size, end);
+
+                post([first, last, &f, &group, &error]() {
+                    error.run([&]() {
+                        for (auto i = first; i < last; i++)
+                        {
+                            f(i);
+                        }
+                    });
+
+                    group.done();
+                });
+            }
+
+            wait(group);
+            error.rethrow();
+        }
+
+        /// runs all submitted tasks and stops the workers, no tasks may be submitted after it
+        void shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (stopping_)
+                {
+                    return;
+                }
+
+                stopping_ = true;
+            }
+
+            wake_.notify_all();
+
+            for (auto& w : workers_)
+            {
+                if (w->thread.joinable())
+                {
+                    w->thread.join();
+                }
+            }
+        }
+
+    private:
+        void push(detail::pool_task* task)
+        {
+            auto& self = this_worker();
+
+            if (self.pool == this)
+            {
+                workers_[self.index]->deque.push(task);
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (stopping_)
+                {
+                    delete task;
+                    raise("thread_pool is shut down");
+                }
+
+                shared_.push_back(task);
+            }
+
+            queued_.fetch_add(1, std::memory_order_seq_cst);
+
+            if (sleeping_.load(std::memory_order_seq_cst) > 0)
+            {
+                // taking the lock makes sure a worker about to sleep sees queued_
+                std::lock_guard<std::mutex> lock(mutex_);
+                wake_.notify_one();
+            }
+        }
+
+        // index == size() for threads outside the pool
+        detail::pool_task* find_task(std::size_t index)
+        {
+            detail::pool_task* task = nullptr;
+
+            if (index < workers_.size())
+            {
+                task = workers_[index]->deque.take();
+            }
+
+            if (task == nullptr && queued_.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (!shared_.empty())
+                {
+                    task = shared_.front();
+                    shared_.pop_front();
+                }
+            }
+
+            for (std::size_t i = 1; task == nullptr && i <= workers_.size(); i++)
+            {
+                task = workers_[(index + i) % workers_.size()]->deque.steal();
+            }
+
+            if (task != nullptr)
+            {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            return task;
+        }
+
+        static void run(detail::pool_task* task)
+        {
+            std::unique_ptr<detail::pool_task> owner(task);
+            task->run();
+        }
+
+        void work(std::size_t index, int cpu)
+        {
+            if (cpu >= 0)
+            {
+                detail::pin_current_thread(cpu);
+            }
+
+            this_worker() = { this, index };
+
+            while (true)
+            {
+                if (auto task = find_task(index))
+                {
+                    run(task);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                sleeping_.fetch_add(1, std::memory_order_seq_cst);
+                wake_.wait(lock, [this]() {
+                    return queued_.load(std::memory_order_seq_cst) > 0 || stopping_;
+                });
+                sleeping_.fetch_sub(1, std::memory_order_relaxed);
+
+                if (stopping_ && queued_.load(std::memory_order_seq_cst) == 0)
+                {
+                    // wake the others, as nobody notifies them for the empty queues
+                    wake_.notify_all();
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<worker>> workers_;
+        std::deque<detail::pool_task*> shared_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> queued_{ 0 };
+        std::atomic<std::size_t> sleeping_{ 0 };
+        bool stopping_ = false;
+    };
+
+    /**
+     * \brief The process-wide pool with one thread per CPU, started on first use
+     *
+     * parallel_for_each runs on it when compiled without OpenMP. It shuts down at exit.
+     */
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+} // namespace lang
+} // namespace nitro
@@ -37,10 +37,14 @@ namespace nitro
 {
 namespace lang
 {
+    // for string keys, hash and key_equal are transparent, so since C++20, lookups with any
+    // string type don't need a temporary key
     template <typename Key, typename T>
-    using unordered_map = std::unordered_map<Key, T, nitro::lang::hash_wrapper<Key>>;
+    using unordered_map = std::unordered_map<Key, T, nitro::lang::hash_wrapper<Key>,
+                                             typename detail::default_key_equal<Key>::type>;
 
     template <typename T>
-    using unordered_set = std::unordered_set<T, nitro::lang::hash_wrapper<T>>;
+    using unordered_set = std::unordered_set<T, nitro::lang::hash_wrapper<T>,
+                                             typename detail::default_key_equal<T>::type>;
 } // namespace lang
 } // namespace nitro
@@ -34,6 +34,8 @@
 #include <nitro/log/detail/set_attribute.hpp>
 #include <nitro/log/severity.hpp>
 
+#include <nitro/format/traits.hpp>
+
 #include <nitro/lang/string_ref.hpp>
 
 #include <nitro/meta/callable.hpp>
@@ -102,11 +104,7 @@ namespace log
                 detail::set_tag(*r, tag);
                 detail::set_severity<Record>()(*r, Severity);
 
-                if (logger::will_log(*r))
-                {
-                    s.reset(new std::stringstream());
-                }
-                else
+                if (!logger::will_log(*r))
                 {
                     r.reset();
                 }
@@ -121,7 +119,10 @@ namespace log
                 if (r)
                 {
                     detail::set_timestamp(*r);
-                    r->message() = s->str();
+                    if (s)
+                    {
+                        r->message() += s->str();
+                    }
                     logger::log(Severity, *r);
                 }
             }
@@ -131,14 +132,62 @@ namespace log
                 return *r;
             }
 
+            // Values are appended to the message directly, as long as there is a formatter_traits
+            // specialization for them. Once anything else, e.g., a manipulator like std::hex, was
+            // written, all following values go through this stream, so the manipulators apply.
             std::stringstream& sstr()
             {
+                if (!s)
+                {
+                    s.reset(new std::stringstream());
+                }
+
                 return *s;
             }
 
+            template <typename T>
+            void write(const T& t)
+            {
+                write(t, has_formatter_traits<typename std::decay<T>::type>());
+            }
+
             operator bool() const
             {
-                return static_cast<bool>(s);
+                return static_cast<bool>(r);
+            }
+
+        private:
+            template <typename T>
+            void write(const T& t, std::true_type)
+            {
+                if (s)
+                {
+                    stream(t, nitro::detail::has_ostream_operator<typename std::decay<T>::type>());
+                }
+                else
+                {
+                    nitro::detail::write_formatted(r->message(), t, format_spec<char>());
+                }
+            }
+
+            template <typename T>
+            void write(const T& t, std::false_type)
+            {
+                sstr() << t;
+            }
+
+            template <typename T>
+            void stream(const T& t, std::true_type)
+            {
+                *s << t;
+            }
+
+            template <typename T>
+            void stream(const T& t, std::false_type)
+            {
+                std::string str;
+                nitro::detail::write_formatted(str, t, format_spec<char>());
+                *s << str;
             }
 
         private:
@@ -155,7 +204,7 @@ namespace log
         {
             if (s)
             {
-                s.sstr() << t();
+                s.write(t());
             }
 
             return s;
@@ -170,7 +219,7 @@ namespace log
         {
             if (s)
             {
-                s.sstr() << t();
+                s.write(t());
             }
 
             return std::move(s);
@@ -185,7 +234,7 @@ namespace log
         {
             if (s)
             {
-                s.sstr() << t;
+                s.write(t);
             }
 
             return std::move(s);
@@ -200,7 +249,7 @@ namespace log
         {
             if (s)
             {
-                s.sstr() << t;
+                s.write(t);
             }
 
             return s;
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/arena.hpp>
+#include <nitro/lang/fixed_vector.hpp>
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("arena allocates from chunks", "[lang]")
+{
+    nitro::lang::arena a(4096);
+
+    auto stats = a.stats();
+    REQUIRE(stats.bytes_used == 0);
+    REQUIRE(stats.chunks == 0);
+
+    auto x = a.allocate<std::int32_t>();
+    auto y = a.allocate<double>(4);
+    auto z = a.allocate(7, 64);
+
+    REQUIRE(reinterpret_cast<std::uintptr_t>(y) % alignof(double) == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(z) % 64 == 0);
+    REQUIRE(static_cast<void*>(y) > static_cast<void*>(x));
+
+    stats = a.stats();
+    REQUIRE(stats.chunks == 1);
+    REQUIRE(stats.bytes_used >= sizeof(std::int32_t) + 4 * sizeof(double) + 7);
+    REQUIRE(stats.bytes_reserved >= 4096);
+
+    // larger than a chunk
+    auto big = a.allocate<char>(10000);
+    big[9999] = 'x';
+    REQUIRE(a.stats().chunks == 2);
+}
+
+TEST_CASE("arena rewinds and resets", "[lang]")
+{
+    nitro::lang::arena a(1024);
+
+    a.allocate(100);
+    auto mark = a.save();
+    auto first = a.allocate(100);
+
+    for (int i = 0; i < 100; i++)
+    {
+        a.allocate(100);
+    }
+
+    auto chunks = a.stats().chunks;
+    REQUIRE(chunks > 1);
+
+    a.rewind(mark);
+    REQUIRE(a.stats().bytes_used == 100);
+    REQUIRE(a.allocate(100) == first);
+
+    a.reset();
+    REQUIRE(a.stats().bytes_used == 0);
+
+    // the chunks are reused
+    for (int i = 0; i < 100; i++)
+    {
+        a.allocate(100);
+    }
+    REQUIRE(a.stats().chunks == chunks);
+    REQUIRE(a.stats().chunks_allocated == chunks);
+
+    a.release();
+    REQUIRE(a.stats().chunks == 0);
+    REQUIRE(a.stats().bytes_reserved == 0);
+}
+
+TEST_CASE("arena chunks are cached per thread", "[lang]")
+{
+    void* first;
+
+    {
+        nitro::lang::arena a(8192);
+        first = a.allocate(1);
+    }
+
+    nitro::lang::arena b(8192);
+    REQUIRE(b.allocate(1) == first);
+}
+
+TEST_CASE("arena with huge pages", "[lang]")
+{
+    nitro::lang::arena a(1024 * 1024, true);
+
+    auto data = a.allocate<std::uint64_t>(1000);
+    data[999] = 42;
+
+    REQUIRE(a.stats().bytes_reserved >= 1024 * 1024);
+}
+
+TEST_CASE("arena allocator", "[lang]")
+{
+    nitro::lang::arena a;
+
+    std::vector<int, nitro::lang::arena_allocator<int>> v(a);
+    for (int i = 0; i < 1000; i++)
+    {
+        v.push_back(i);
+    }
+
+    REQUIRE(v[999] == 999);
+    REQUIRE(a.stats().chunks == 1);
+
+    nitro::lang::fixed_vector<double, nitro::lang::arena_allocator<double>> w(
+        100, nitro::lang::arena_allocator<double>(a));
+    w.emplace_back(1.0);
+    REQUIRE(w.back() == 1.0);
+}
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+TEST_CASE("arena memory resource", "[lang]")
+{
+    nitro::lang::arena a;
+    nitro::lang::arena_resource resource(a);
+
+    nitro::lang::pmr::fixed_vector<double> v(100, &resource);
+    v.emplace_back(1.0);
+
+    std::pmr::vector<std::pmr::string> strings(&resource);
+    strings.emplace_back("a string long enough to not fit into the small string buffer");
+
+    REQUIRE(a.stats().chunks == 1);
+    REQUIRE(a.stats().bytes_used >= 100 * sizeof(double));
+}
+#endif
@@ -0,0 +1,250 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/binary_archive.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <optional>
+#include <string_view>
+#include <variant>
+#endif
+
+namespace
+{
+enum class color : std::uint8_t
+{
+    red,
+    green
+};
+
+struct point
+{
+    float x;
+    float y;
+};
+
+bool operator==(const point& a, const point& b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+struct state : nitro::lang::tuple_operators<state>
+{
+    auto as_tuple()
+    {
+        return std::tie(id, name, samples, tags, position, colors, offset);
+    }
+
+    std::uint64_t id = 0;
+    std::string name;
+    std::vector<double> samples;
+    std::map<std::string, int> tags;
+    point position = { 0, 0 };
+    std::list<color> colors;
+    std::int32_t offset = 0;
+};
+
+state make_state()
+{
+    state s;
+    s.id = 42;
+    s.name = "checkpoint";
+    s.samples = { 1.5, 2.5, 3.5 };
+    s.tags = { { "a", 1 }, { "b", -2 } };
+    s.position = { 1.0f, 2.0f };
+    s.colors = { color::green, color::red };
+    s.offset = -7;
+    return s;
+}
+} // namespace
+
+TEST_CASE("binary archive round trips tuple_operators types", "[lang]")
+{
+    for (auto encoding :
+         { nitro::lang::binary_encoding::fixed, nitro::lang::binary_encoding::varint })
+    {
+        auto original = make_state();
+
+        nitro::lang::binary_archive ar(encoding);
+        ar << original;
+
+        nitro::lang::binary_reader reader(ar);
+        auto copy = reader.read<state>();
+
+        REQUIRE(reader.at_end());
+        REQUIRE(copy == original);
+        REQUIRE(copy.position.y == 2.0f);
+    }
+}
+
+TEST_CASE("binary archive works with tuple_operators::serialize", "[lang]")
+{
+    auto original = make_state();
+
+    nitro::lang::binary_archive direct;
+    direct << original;
+
+    nitro::lang::binary_archive serialized;
+    original.serialize(serialized, 0);
+
+    REQUIRE(std::vector<char>(direct.data(), direct.data() + direct.size()) ==
+            std::vector<char>(serialized.data(), serialized.data() + serialized.size()));
+
+    state copy;
+    nitro::lang::binary_reader reader(serialized);
+    copy.serialize(reader, 0);
+    REQUIRE(copy == original);
+}
+
+TEST_CASE("binary archive varints are compact", "[lang]")
+{
+    nitro::lang::binary_archive fixed;
+    nitro::lang::binary_archive varint(nitro::lang::binary_encoding::varint);
+
+    for (std::int64_t value : { 0, 1, -1, 63, -64, 300 })
+    {
+        fixed << value;
+        varint << value;
+    }
+
+    REQUIRE(fixed.size() == 6 * 8);
+    REQUIRE(varint.size() == 1 + 1 + 1 + 1 + 1 + 2);
+
+    varint << std::numeric_limits<std::int64_t>::min();
+    varint << std::numeric_limits<std::uint64_t>::max();
+
+    nitro::lang::binary_reader reader(varint);
+    for (std::int64_t value : { 0, 1, -1, 63, -64, 300 })
+    {
+        REQUIRE(reader.read<std::int64_t>() == value);
+    }
+    REQUIRE(reader.read<std::int64_t>() == std::numeric_limits<std::int64_t>::min());
+    REQUIRE(reader.read<std::uint64_t>() == std::numeric_limits<std::uint64_t>::max());
+    REQUIRE(reader.at_end());
+}
+
+TEST_CASE("binary archive reads views without copying", "[lang]")
+{
+    nitro::lang::binary_archive ar;
+    ar << std::string("text") << std::uint8_t(1) << std::vector<std::uint32_t>{ 1, 2, 3 };
+
+    nitro::lang::binary_reader reader(ar);
+
+    nitro::lang::string_ref text("");
+    nitro::lang::span<const std::uint32_t> numbers;
+    std::uint8_t byte;
+
+    reader >> text >> byte >> numbers;
+
+    REQUIRE(text == "text");
+    REQUIRE(text.data() >= ar.data());
+    REQUIRE(text.data() < ar.data() + ar.size());
+    REQUIRE(numbers.size() == 3);
+    REQUIRE(numbers[2] == 3);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(numbers.data()) % alignof(std::uint32_t) == 0);
+
+    // the view can also be read into a vector, the padding is the same
+    nitro::lang::binary_reader again(ar);
+    again.read<std::string>();
+    again.read<std::uint8_t>();
+    REQUIRE(again.read<std::vector<std::uint32_t>>() == std::vector<std::uint32_t>{ 1, 2, 3 });
+}
+
+TEST_CASE("binary archive handles standard types", "[lang]")
+{
+    nitro::lang::binary_archive ar(nitro::lang::binary_encoding::varint);
+
+    std::array<std::string, 2> names = { { "x", "y" } };
+    std::set<int> set = { 3, 1, 2 };
+    std::vector<bool> flags = { true, false, true };
+    auto tuple = std::make_tuple(1, std::string("two"), 3.0);
+
+    ar << names << set << flags << tuple << std::make_pair(color::green, true);
+    ar << nitro::lang::optional<std::string>("note") << nitro::lang::optional<std::string>();
+
+    nitro::lang::binary_reader reader(ar);
+
+    REQUIRE(reader.read<std::array<std::string, 2>>() == names);
+    REQUIRE(reader.read<std::set<int>>() == set);
+    REQUIRE(reader.read<std::vector<bool>>() == flags);
+    REQUIRE((reader.read<std::tuple<int, std::string, double>>() == tuple));
+    REQUIRE((reader.read<std::pair<color, bool>>() == std::make_pair(color::green, true)));
+    REQUIRE(*reader.read<nitro::lang::optional<std::string>>() == "note");
+    REQUIRE(!reader.read<nitro::lang::optional<std::string>>().has_value());
+    REQUIRE(reader.at_end());
+}
+
+TEST_CASE("binary reader rejects malformed data", "[lang]")
+{
+    nitro::lang::binary_archive ar;
+    ar << std::string("truncated");
+
+    nitro::lang::binary_reader short_reader(ar.data(), ar.size() - 1);
+    REQUIRE_THROWS_AS(short_reader.read<std::string>(), nitro::except::exception);
+
+    nitro::lang::binary_archive big(nitro::lang::binary_encoding::varint);
+    big << 300;
+
+    nitro::lang::binary_reader range_reader(big);
+    REQUIRE_THROWS_AS(range_reader.read<std::uint8_t>(), nitro::except::exception);
+
+    const char overlong[11] = { '\x80', '\x80', '\x80', '\x80', '\x80', '\x80',
+                                '\x80', '\x80', '\x80', '\x80', '\x01' };
+    nitro::lang::binary_reader varint_reader(overlong, sizeof(overlong),
+                                             nitro::lang::binary_encoding::varint);
+    REQUIRE_THROWS_AS(varint_reader.read<std::uint64_t>(), nitro::except::exception);
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("binary archive handles optional, variant and string_view", "[lang]")
+{
+    using value = std::variant<int, std::string>;
+
+    nitro::lang::binary_archive ar;
+    ar << std::optional<int>(5) << std::optional<int>() << value(std::string("v")) << value(3)
+       << std::string_view("view");
+
+    nitro::lang::binary_reader reader(ar);
+
+    REQUIRE(reader.read<std::optional<int>>() == 5);
+    REQUIRE(!reader.read<std::optional<int>>().has_value());
+    REQUIRE(std::get<std::string>(reader.read<value>()) == "v");
+    REQUIRE(std::get<int>(reader.read<value>()) == 3);
+    REQUIRE(reader.read<std::string_view>() == "view");
+    REQUIRE(reader.at_end());
+
+    nitro::lang::binary_archive bad;
+    bad.write_size(2);
+    nitro::lang::binary_reader bad_reader(bad);
+    REQUIRE_THROWS_AS(bad_reader.read<value>(), nitro::except::exception);
+}
+#endif
+
+TEST_CASE("binary archive rejects pointers", "[lang]")
+{
+    using nitro::lang::detail::archive_tag;
+    using nitro::lang::detail::archive_unsupported_tag;
+
+    static_assert(std::is_same<archive_tag<const char*>, archive_unsupported_tag>::value, "");
+    static_assert(std::is_same<archive_tag<int*>, archive_unsupported_tag>::value, "");
+    static_assert(std::is_same<archive_tag<std::nullptr_t>, archive_unsupported_tag>::value, "");
+    static_assert(!nitro::lang::detail::archive_is_bulk<double*>::value, "");
+
+    nitro::lang::binary_archive ar;
+    ar << nitro::lang::string_ref("hello");
+
+    nitro::lang::binary_reader reader(ar);
+    REQUIRE(reader.read<std::string>() == "hello");
+}
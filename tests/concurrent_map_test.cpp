@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/concurrent_map.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("concurrent map basic operations", "[lang]")
+{
+    nitro::lang::concurrent_map<std::string, int> m(5);
+
+    REQUIRE(m.shard_count() == 8);
+    REQUIRE(m.empty());
+    REQUIRE(!m.find("missing"));
+
+    REQUIRE(m.insert("one", 1));
+    REQUIRE(!m.insert("one", 2));
+    REQUIRE(m.insert_or_assign("two", 2));
+    REQUIRE(!m.insert_or_assign("one", 11));
+
+    REQUIRE(m.size() == 2);
+    REQUIRE(m.contains("one"));
+    REQUIRE(*m.find("one") == 11);
+
+    int seen = 0;
+    REQUIRE(m.visit("two", [&seen](const int& value) { seen = value; }));
+    REQUIRE(seen == 2);
+    REQUIRE(!m.visit("three", [&seen](const int&) { seen = -1; }));
+    REQUIRE(seen == 2);
+
+    REQUIRE(m.upsert("three", [](int& value) { value++; }, 3));
+    REQUIRE(!m.upsert("three", [](int& value) { value++; }, 3));
+    REQUIRE(*m.find("three") == 4);
+
+    int sum = 0;
+    m.for_each([&sum](const std::string&, int value) { sum += value; });
+    REQUIRE(sum == 17);
+
+    REQUIRE(m.erase("one"));
+    REQUIRE(!m.erase("one"));
+    REQUIRE(m.size() == 2);
+
+    m.clear();
+    REQUIRE(m.empty());
+}
+
+TEST_CASE("concurrent map spreads keys across shards", "[lang]")
+{
+    nitro::lang::concurrent_map<std::uint64_t, std::uint64_t> m(16);
+    m.reserve(4096);
+
+    for (std::uint64_t i = 0; i < 4096; i++)
+    {
+        m.insert(i, i);
+    }
+
+    REQUIRE(m.size() == 4096);
+
+    for (std::uint64_t i = 0; i < 4096; i++)
+    {
+        REQUIRE(*m.find(i) == i);
+    }
+}
+
+namespace
+{
+struct counting_hash
+{
+    std::size_t operator()(int key) const
+    {
+        ++*calls;
+        return std::hash<int>()(key);
+    }
+
+    int* calls;
+};
+} // namespace
+
+TEST_CASE("concurrent map hashes each key once", "[lang]")
+{
+    int calls = 0;
+    nitro::lang::concurrent_map<int, int, counting_hash> m(4, counting_hash{ &calls });
+    m.reserve(64);
+
+    m.insert(1, 1);
+    REQUIRE(calls == 1);
+
+    REQUIRE(*m.find(1) == 1);
+    REQUIRE(m.contains(1));
+    REQUIRE(m.visit(1, [](int) {}));
+    REQUIRE(!m.upsert(1, [](int& value) { value++; }, 0));
+    REQUIRE(!m.insert_or_assign(1, 3));
+    REQUIRE(m.erase(1));
+    REQUIRE(calls == 7);
+}
+
+TEST_CASE("concurrent map can be used from multiple threads", "[lang]")
+{
+    nitro::lang::concurrent_map<std::uint64_t, std::uint64_t> m;
+
+    const std::uint64_t threads = 4;
+    const std::uint64_t keys = 1000;
+    const std::uint64_t rounds = 10;
+
+    std::vector<std::thread> workers;
+
+    for (std::uint64_t t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&m, t, keys, rounds]() {
+            for (std::uint64_t round = 0; round < rounds; round++)
+            {
+                for (std::uint64_t i = 0; i < keys; i++)
+                {
+                    // shared counters, contended by all threads
+                    m.upsert(i, [](std::uint64_t& value) { value++; }, 1);
+
+                    // private keys, inserted and erased again
+                    auto own = (t + 1) << 32 | i;
+                    m.insert_or_assign(own, round);
+                    m.find(own);
+                    m.erase(own);
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    REQUIRE(m.size() == keys);
+
+    for (std::uint64_t i = 0; i < keys; i++)
+    {
+        REQUIRE(*m.find(i) == threads * rounds);
+    }
+}
@@ -4,6 +4,8 @@
 
 #include <array>
 #include <initializer_list>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
 using nitro::lang::enumerate;
@@ -311,3 +313,98 @@ TEST_CASE("Iterator which return a copy when dereferenced work")
         }
     }
 }
+
+namespace
+{
+struct copy_counter
+{
+    copy_counter(int value) : value(value)
+    {
+    }
+
+    copy_counter(const copy_counter& other) : value(other.value)
+    {
+        copies++;
+    }
+
+    copy_counter& operator=(const copy_counter& other) = default;
+
+    int value;
+    static int copies;
+};
+
+int copy_counter::copies = 0;
+} // namespace
+
+TEST_CASE("enumerated elements refer to the container", "[lang]")
+{
+    std::vector<copy_counter> input = { 1, 2, 3 };
+    copy_counter::copies = 0;
+
+    for (auto e : enumerate(input))
+    {
+        e.value().value *= 2;
+        CHECK(&e.value() == &input[e.index()]);
+    }
+
+    REQUIRE(copy_counter::copies == 0);
+    REQUIRE(input[2].value == 6);
+
+    const auto& const_input = input;
+    for (auto e : enumerate(const_input))
+    {
+        static_assert(std::is_same<decltype(e.value()), const copy_counter&>::value, "");
+        CHECK(e.value().value == 2 * static_cast<int>(e.index() + 1));
+    }
+
+    REQUIRE(copy_counter::copies == 0);
+}
+
+TEST_CASE("enumerate keeps random access", "[lang]")
+{
+    std::vector<int> input = { 0, 10, 20, 30, 40 };
+    auto range = enumerate(input);
+
+    using iterator = decltype(range.begin());
+    static_assert(std::is_same<std::iterator_traits<iterator>::iterator_category,
+                               std::random_access_iterator_tag>::value,
+                  "");
+
+    REQUIRE(range.end() - range.begin() == 5);
+    REQUIRE(std::distance(range.begin(), range.end()) == 5);
+
+    auto it = range.begin() + 3;
+    REQUIRE((*it).index() == 3);
+    REQUIRE((*it).value() == 30);
+    REQUIRE(range.begin()[4].value() == 40);
+    REQUIRE((*(range.end() - 1)).index() == 4);
+    REQUIRE((--it).index() == 2);
+    REQUIRE(range.begin() < it);
+    REQUIRE(it == range.begin() + 2);
+
+    std::size_t index = 0;
+    for (auto e : enumerate(std::vector<int>{ 1, 2, 3 }))
+    {
+        e.value() += 1;
+        CHECK(e.index() == index++);
+    }
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("enumerated elements can be bound with structured bindings", "[lang]")
+{
+    std::vector<int> input = { 0, 1, 2, 3 };
+
+    for (auto [index, value] : enumerate(input))
+    {
+        value = static_cast<int>(index * 10);
+    }
+
+    REQUIRE(input == std::vector<int>{ 0, 10, 20, 30 });
+
+    for (const auto& [index, value] : enumerate(Range<0, 3>()))
+    {
+        CHECK(static_cast<long>(index) == value);
+    }
+}
+#endif
@@ -1,7 +1,17 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <nitro/except/exception.hpp>
 #include <nitro/lang/fixed_vector.hpp>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+#include <cstddef>
+#include <memory_resource>
+#endif
 
 TEST_CASE("fixed vector init", "[lang]")
 {
@@ -163,6 +173,176 @@ TEST_CASE("fixed vector with unique ptr", "[lang]")
     REQUIRE_NOTHROW(v.erase(v.begin()));
 }
 
+TEST_CASE("fixed vector assignment", "[lang]")
+{
+    nitro::lang::fixed_vector<std::int64_t> v = { 1, 2, 3 };
+    nitro::lang::fixed_vector<std::int64_t> w(10);
+
+    w = v;
+    REQUIRE(w.size() == 3);
+    REQUIRE(w.capacity() == 3);
+    REQUIRE(w.back() == 3);
+
+    nitro::lang::fixed_vector<std::int64_t> x(1);
+    x = std::move(w);
+    REQUIRE(x.size() == 3);
+    REQUIRE(x.front() == 1);
+
+    x = { 4, 5 };
+    REQUIRE(x.size() == 2);
+    REQUIRE(x.back() == 5);
+
+    // a moved-from vector is still usable
+    w.emplace_back(6);
+    REQUIRE(w.front() == 6);
+}
+
+TEST_CASE("fixed vector bulk insert and erase of doubles", "[lang]")
+{
+    std::vector<double> values(1000);
+    std::iota(values.begin(), values.end(), 0.5);
+
+    nitro::lang::fixed_vector<double> v(2000);
+    v.push_back(values.data(), values.data() + values.size());
+    v.push_back(values.begin(), values.end());
+
+    REQUIRE(v.size() == 2000);
+    REQUIRE(v[999] == 999.5);
+    REQUIRE(v[1999] == 999.5);
+    REQUIRE_THROWS_AS(v.push_back(values.data(), values.data() + 1), nitro::except::exception);
+
+    v.erase(v.begin());
+    REQUIRE(v.size() == 1999);
+    REQUIRE(v.front() == 1.5);
+    REQUIRE(v[999] == 0.5);
+
+    v.erase_unordered(v.begin());
+    REQUIRE(v.size() == 1998);
+    REQUIRE(v.front() == 999.5);
+
+    v.emplace(v.begin() + 1, 42.0);
+    REQUIRE(v.size() == 1999);
+    REQUIRE(v[1] == 42.0);
+    REQUIRE(v[2] == 2.5);
+}
+
+TEST_CASE("fixed vector resize uninitialized", "[lang]")
+{
+    nitro::lang::fixed_vector<double> v(8);
+
+    v.resize_uninitialized(8);
+    std::fill(v.begin(), v.end(), 1.0);
+
+    REQUIRE(v.size() == 8);
+    REQUIRE(std::accumulate(v.begin(), v.end(), 0.0) == 8.0);
+    REQUIRE_THROWS_AS(v.resize_uninitialized(9), nitro::except::exception);
+}
+
+TEST_CASE("fixed vector with non-default constructible type", "[lang]")
+{
+    nitro::lang::fixed_vector<std::string> v(4);
+
+    v.emplace_back("a");
+    v.emplace_back("c");
+    v.emplace(v.begin() + 1, "b");
+    v.emplace_back("d");
+
+    REQUIRE(v[0] + v[1] + v[2] + v[3] == "abcd");
+
+    v.erase_unordered(v.begin());
+    REQUIRE(v[0] + v[1] + v[2] == "dbc");
+
+    v.pop_back();
+    REQUIRE(v.size() == 2);
+}
+
+namespace
+{
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    counting_allocator(std::size_t& allocations) : allocations(&allocations)
+    {
+    }
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& other) : allocations(other.allocations)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++*allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, std::size_t n)
+    {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    bool operator==(const counting_allocator& other) const
+    {
+        return allocations == other.allocations;
+    }
+
+    bool operator!=(const counting_allocator& other) const
+    {
+        return allocations != other.allocations;
+    }
+
+    std::size_t* allocations;
+};
+} // namespace
+
+TEST_CASE("fixed vector with allocator", "[lang]")
+{
+    std::size_t allocations = 0;
+    std::size_t other_allocations = 0;
+
+    using vector = nitro::lang::fixed_vector<std::int64_t, counting_allocator<std::int64_t>>;
+
+    vector v(10, counting_allocator<std::int64_t>(allocations));
+    v.emplace_back(1);
+    REQUIRE(allocations == 1);
+
+    vector w(v);
+    REQUIRE(allocations == 2);
+    REQUIRE(w.get_allocator() == v.get_allocator());
+
+    vector x(5, counting_allocator<std::int64_t>(other_allocations));
+    x = std::move(v);
+    REQUIRE(other_allocations == 2);
+    REQUIRE(x.size() == 1);
+    REQUIRE(x.capacity() == 10);
+}
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+TEST_CASE("fixed vector in a memory resource", "[lang]")
+{
+    std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                 std::pmr::null_memory_resource());
+
+    nitro::lang::pmr::fixed_vector<double> v(100, &resource);
+    v.emplace_back(1.0);
+
+    REQUIRE(v.get_allocator().resource() == &resource);
+    REQUIRE(static_cast<void*>(v.data()) >= static_cast<void*>(buffer));
+    REQUIRE(static_cast<void*>(v.data()) < static_cast<void*>(buffer + sizeof(buffer)));
+
+    nitro::lang::pmr::fixed_vector<std::pmr::string> s(2, &resource);
+    s.emplace_back("a string long enough to not fit into the small string buffer");
+
+    // elements are constructed with the allocator of the vector
+    REQUIRE(s.front().get_allocator().resource() == &resource);
+
+    REQUIRE_THROWS_AS(nitro::lang::pmr::fixed_vector<double>(1000, &resource), std::bad_alloc);
+}
+#endif
+
 // TEST_CASE("fixed vector references in storage test", "[lang]")
 // {
 //     nitro::lang::fixed_vector<std::reference_wrapper<std::int64_t>> v(6);
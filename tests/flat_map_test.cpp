@@ -0,0 +1,366 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/flat_map.hpp>
+#include <nitro/lang/flat_set.hpp>
+#include <nitro/lang/string_ref.hpp>
+#include <nitro/lang/tuple_operators.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+struct metric_key : nitro::lang::tuple_operators<metric_key>
+{
+    metric_key(std::int64_t node, std::int32_t metric) : node(node), metric(metric)
+    {
+    }
+
+    auto as_tuple()
+    {
+        return std::tie(node, metric);
+    }
+
+    std::int64_t node;
+    std::int32_t metric;
+};
+} // namespace
+
+TEST_CASE("flat map basic operations", "[lang]")
+{
+    nitro::lang::flat_map<std::string, int> m;
+
+    REQUIRE(m.empty());
+    REQUIRE(m.find("missing") == m.end());
+    REQUIRE(m.begin() == m.end());
+
+    REQUIRE(m.insert({ "one", 1 }).second);
+    REQUIRE(!m.insert({ "one", 2 }).second);
+    REQUIRE(m.emplace("two", 2).second);
+    REQUIRE(m.try_emplace("three", 3).second);
+    m["four"] = 4;
+    m.insert_or_assign("one", 11);
+
+    REQUIRE(m.size() == 4);
+    REQUIRE(m.at("one") == 11);
+    REQUIRE(m["two"] == 2);
+    REQUIRE(m.contains("three"));
+    REQUIRE(m.count("five") == 0);
+    REQUIRE_THROWS_AS(m.at("five"), nitro::except::exception);
+
+    REQUIRE(m.erase("two") == 1);
+    REQUIRE(m.erase("two") == 0);
+    REQUIRE(m.size() == 3);
+    REQUIRE(!m.contains("two"));
+
+    int sum = 0;
+    for (const auto& entry : m)
+    {
+        sum += entry.second;
+    }
+    REQUIRE(sum == 11 + 3 + 4);
+
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+}
+
+TEST_CASE("flat map matches std::unordered_map", "[lang]")
+{
+    nitro::lang::flat_map<std::uint64_t, std::uint64_t> m;
+    std::unordered_map<std::uint64_t, std::uint64_t> reference;
+
+    std::mt19937_64 rng(42);
+
+    for (int i = 0; i < 200000; i++)
+    {
+        auto key = rng() % 5000;
+
+        switch (rng() % 3)
+        {
+        case 0:
+            m[key] = i;
+            reference[key] = i;
+            break;
+        case 1:
+            REQUIRE(m.erase(key) == reference.erase(key));
+            break;
+        default:
+            auto it = m.find(key);
+            auto ref = reference.find(key);
+            REQUIRE((it == m.end()) == (ref == reference.end()));
+            if (ref != reference.end())
+            {
+                REQUIRE(it->second == ref->second);
+            }
+        }
+    }
+
+    REQUIRE(m.size() == reference.size());
+
+    std::size_t visited = 0;
+    for (auto& entry : m)
+    {
+        REQUIRE(reference.at(entry.first) == entry.second);
+        ++visited;
+    }
+    REQUIRE(visited == reference.size());
+}
+
+TEST_CASE("flat map erase while iterating", "[lang]")
+{
+    nitro::lang::flat_map<int, int> m;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        m[i] = i;
+    }
+
+    for (auto it = m.begin(); it != m.end();)
+    {
+        if (it->first % 2 == 0)
+        {
+            it = m.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    REQUIRE(m.size() == 500);
+    REQUIRE(!m.contains(10));
+    REQUIRE(m.contains(11));
+}
+
+TEST_CASE("flat map reserve avoids rehashing", "[lang]")
+{
+    nitro::lang::flat_map<int, std::unique_ptr<int>> m;
+    m.reserve(1000);
+
+    auto buckets = m.bucket_count();
+    REQUIRE(buckets >= 1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        m.try_emplace(i, std::make_unique<int>(i));
+    }
+
+    REQUIRE(m.bucket_count() == buckets);
+    REQUIRE(*m.at(999) == 999);
+    REQUIRE(m.load_factor() <= m.max_load_factor());
+}
+
+TEST_CASE("flat map with tuple_operators keys", "[lang]")
+{
+    nitro::lang::flat_map<metric_key, double> m;
+
+    for (int node = 0; node < 100; node++)
+    {
+        for (int metric = 0; metric < 10; metric++)
+        {
+            m[metric_key(node, metric)] += node * metric;
+        }
+    }
+
+    REQUIRE(m.size() == 1000);
+    REQUIRE(m.at(metric_key(7, 3)) == 21);
+}
+
+TEST_CASE("flat map with std::hash", "[lang]")
+{
+    // std::hash of integers is the identity, so the map mixes the hashes itself
+    nitro::lang::flat_map<std::uint64_t, int, std::hash<std::uint64_t>> m;
+
+    for (std::uint64_t i = 0; i < 10000; i++)
+    {
+        m[i << 32] = 1;
+    }
+
+    REQUIRE(m.size() == 10000);
+    REQUIRE(m.contains(std::uint64_t(42) << 32));
+}
+
+TEST_CASE("flat map copy and move", "[lang]")
+{
+    nitro::lang::flat_map<std::string, std::string> m = { { "a", "1" }, { "b", "2" } };
+
+    auto copy = m;
+    REQUIRE(copy == m);
+
+    copy["c"] = "3";
+    REQUIRE(copy != m);
+
+    auto moved = std::move(copy);
+    REQUIRE(moved.size() == 3);
+    REQUIRE(copy.empty());
+
+    copy = moved;
+    REQUIRE(copy.at("c") == "3");
+}
+
+TEST_CASE("flat map can be searched with any string type", "[lang]")
+{
+    nitro::lang::flat_map<std::string, int> m;
+    m["a metric name longer than the small string buffer"] = 1;
+    m["short"] = 2;
+
+    const char* chars = "a metric name longer than the small string buffer";
+    nitro::lang::string_ref ref("short");
+
+    REQUIRE(m.find(chars)->second == 1);
+    REQUIRE(m.find(ref)->second == 2);
+    REQUIRE(m.contains(ref));
+    REQUIRE(m.count("missing") == 0);
+    REQUIRE(m.at(chars) == 1);
+    REQUIRE_THROWS_AS(m.at(nitro::lang::string_ref("missing")), nitro::except::exception);
+
+#if __cplusplus >= 201703L
+    REQUIRE(m.find(std::string_view(chars, 8)) == m.end());
+    REQUIRE(std::as_const(m).find(std::string_view("short"))->second == 2);
+#endif
+
+    nitro::lang::flat_set<std::string> s = { "a", "b" };
+    REQUIRE(s.contains(nitro::lang::string_ref("a")));
+    REQUIRE(!s.contains("c"));
+}
+
+TEST_CASE("flat set basic operations", "[lang]")
+{
+    nitro::lang::flat_set<std::string> s = { "a", "b", "c" };
+
+    REQUIRE(s.size() == 3);
+    REQUIRE(!s.insert("a").second);
+    REQUIRE(s.emplace("d").second);
+    REQUIRE(s.contains("d"));
+    REQUIRE(s.erase("a") == 1);
+    REQUIRE(!s.contains("a"));
+
+    nitro::lang::flat_set<int> numbers;
+    for (int i = 0; i < 10000; i++)
+    {
+        numbers.insert(i % 100);
+    }
+    REQUIRE(numbers.size() == 100);
+}
+
+namespace
+{
+struct counted_key
+{
+    explicit counted_key(int value) : value(value)
+    {
+    }
+
+    counted_key(const counted_key& other) : value(other.value)
+    {
+        ++copies;
+    }
+
+    counted_key(counted_key&& other) noexcept : value(other.value)
+    {
+    }
+
+    counted_key& operator=(const counted_key&) = default;
+    counted_key& operator=(counted_key&&) = default;
+
+    friend bool operator==(const counted_key& a, const counted_key& b)
+    {
+        return a.value == b.value;
+    }
+
+    struct hash
+    {
+        std::size_t operator()(const counted_key& key) const
+        {
+            return std::hash<int>()(key.value);
+        }
+    };
+
+    static int copies;
+    int value;
+};
+
+int counted_key::copies = 0;
+} // namespace
+
+TEST_CASE("flat map moves keys when growing", "[lang]")
+{
+    nitro::lang::flat_map<counted_key, int, counted_key::hash> m;
+    counted_key::copies = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        m.try_emplace(counted_key(i), i);
+        m.emplace(counted_key(-i - 1), i);
+    }
+
+    REQUIRE(m.size() == 2000);
+    REQUIRE(counted_key::copies == 0);
+    REQUIRE(m.at(counted_key(999)) == 999);
+}
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+TEST_CASE("flat map in a memory resource", "[lang]")
+{
+    std::pmr::monotonic_buffer_resource first;
+    std::pmr::monotonic_buffer_resource second;
+
+    nitro::lang::pmr::flat_map<std::pmr::string, int> a(&first);
+    a["a key long enough to not fit into the small string buffer"] = 1;
+    a["b"] = 2;
+
+    REQUIRE(a.get_allocator().resource() == &first);
+    REQUIRE(a.begin()->first.get_allocator().resource() == &first);
+
+    nitro::lang::pmr::flat_map<std::pmr::string, int> b(&second);
+    b["c"] = 3;
+
+    SECTION("copy assignment keeps the allocator")
+    {
+        b = a;
+
+        REQUIRE(b.get_allocator().resource() == &second);
+        REQUIRE(b == a);
+        REQUIRE(b.begin()->first.get_allocator().resource() == &second);
+    }
+
+    SECTION("move assignment with another allocator moves the values")
+    {
+        b = std::move(a);
+
+        REQUIRE(b.get_allocator().resource() == &second);
+        REQUIRE(b.size() == 2);
+        REQUIRE(b.at("b") == 2);
+        REQUIRE(a.empty());
+    }
+
+    SECTION("move assignment with the same allocator moves the storage")
+    {
+        nitro::lang::pmr::flat_map<std::pmr::string, int> c(&first);
+        c = std::move(a);
+
+        REQUIRE(c.size() == 2);
+        REQUIRE(a.empty());
+    }
+
+    SECTION("sets work as well")
+    {
+        nitro::lang::pmr::flat_set<int> s(&first);
+        s.insert(1);
+
+        nitro::lang::pmr::flat_set<int> t(&second);
+        t = s;
+        t.swap(t);
+
+        REQUIRE(t.contains(1));
+        REQUIRE(t.get_allocator().resource() == &second);
+    }
+}
+#endif
@@ -4,7 +4,19 @@
 #include <nitro/except/raise.hpp>
 #include <nitro/format/format.hpp>
 
+#include <nitro/lang/string_ref.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
 #include <sstream>
+#include <tuple>
+#include <vector>
 
 TEST_CASE("Simple format strings", "[format]")
 {
@@ -109,7 +121,7 @@ TEST_CASE("Args works")
         fmt.args(1, "foo", 5.25004005);
         std::string out = fmt;
 
-        REQUIRE(out == "Test 1 foo 5.25004");
+        REQUIRE(out == "Test 1 foo 5.25004005");
     }
 
     SECTION("Can be called mixed with arguments")
@@ -155,3 +167,372 @@ TEST_CASE("Format can be used in exptions and raise")
             "This is an exception formatted with nitro::format");
     }
 }
+
+TEST_CASE("Format specifications work", "[format]")
+{
+    SECTION("fields can be indexed explicitly")
+    {
+        std::string out = "{1} {0} {1}"_nf % "World" % "Hello";
+
+        REQUIRE(out == "Hello World Hello");
+    }
+
+    SECTION("fields can be referenced by name")
+    {
+        std::string out = "{greeting} {name}!"_nf % nitro::arg("name", "World") %
+                          nitro::arg("greeting", "Hello");
+
+        REQUIRE(out == "Hello World!");
+    }
+
+    SECTION("names without a matching argument are kept literally")
+    {
+        REQUIRE(std::string(nitro::format("json: {key} value {}") % 5) == "json: {key} value 5");
+        REQUIRE(std::string("{a:>3} {b}"_nf % nitro::arg("b", 1)) == "{a:>3} 1");
+    }
+
+    SECTION("width and alignment pad the argument")
+    {
+        REQUIRE(std::string("[{:>6}]"_nf % 42) == "[    42]");
+        REQUIRE(std::string("[{:{<5}]"_nf % 42) == "[42{{{]");
+        REQUIRE(std::string("[{:<6}]"_nf % 42) == "[42    ]");
+        REQUIRE(std::string("[{:^6}]"_nf % 42) == "[  42  ]");
+        REQUIRE(std::string("[{:*^7}]"_nf % "abc") == "[**abc**]");
+        REQUIRE(std::string("[{:6}]"_nf % "abc") == "[abc   ]");
+        REQUIRE(std::string("[{:2}]"_nf % "abcd") == "[abcd]");
+    }
+
+    SECTION("integers can be written in other bases")
+    {
+        REQUIRE(std::string("{:x}"_nf % 255) == "ff");
+        REQUIRE(std::string("{:#X}"_nf % 255) == "0XFF");
+        REQUIRE(std::string("{:08x}"_nf % 48879) == "0000beef");
+        REQUIRE(std::string("{:#010x}"_nf % 48879) == "0x0000beef");
+        REQUIRE(std::string("{:b}"_nf % 5) == "101");
+        REQUIRE(std::string("{:#o}"_nf % 8) == "010");
+    }
+
+    SECTION("signs are written as requested")
+    {
+        REQUIRE(std::string("{:+}"_nf % 5) == "+5");
+        REQUIRE(std::string("{: }"_nf % 5) == " 5");
+        REQUIRE(std::string("{:05}"_nf % -42) == "-0042");
+        REQUIRE(std::string("{}"_nf % std::numeric_limits<long long>::min()) ==
+                "-9223372036854775808");
+        REQUIRE(std::string("{}"_nf % std::numeric_limits<unsigned long long>::max()) ==
+                "18446744073709551615");
+    }
+
+    SECTION("floating point precision can be given")
+    {
+        REQUIRE(std::string("{:.3f}"_nf % 3.14159) == "3.142");
+        REQUIRE(std::string("{:8.2f}"_nf % -2.5) == "   -2.50");
+        REQUIRE(std::string("{:08.2f}"_nf % -2.5) == "-0002.50");
+        REQUIRE(std::string("{:.2e}"_nf % 1234.5) == "1.23e+03");
+    }
+
+    SECTION("precision truncates strings")
+    {
+        REQUIRE(std::string("{:.3}"_nf % "abcdef") == "abc");
+        REQUIRE(std::string("{:>5.2}"_nf % std::string("abcdef")) == "   ab");
+    }
+
+    SECTION("characters are written as characters")
+    {
+        REQUIRE(std::string("{}{:d}"_nf % 'a' % 'a') == "a97");
+    }
+
+    SECTION("user types are padded as well")
+    {
+        std::string out = "[{:>4}]"_nf % nitro::lang::string_ref("ab");
+
+        REQUIRE(out == "[  ab]");
+    }
+
+    SECTION("invalid fields are kept literally")
+    {
+        REQUIRE(std::string("{ {} }"_nf % 1) == "{ 1 }");
+        REQUIRE(std::string("{:q} {}"_nf % 1) == "{:q} 1");
+        REQUIRE(std::string("{{}}"_nf % 1) == "{1}");
+    }
+
+    SECTION("invalid types for an argument throw")
+    {
+        REQUIRE_THROWS("{:f}"_nf % 1);
+        REQUIRE_THROWS("{:x}"_nf % "abc");
+    }
+
+    SECTION("unreferenced arguments throw")
+    {
+        auto fmt = "{0}"_nf % 1 % 2;
+
+        REQUIRE_THROWS(fmt.str());
+    }
+
+    SECTION("other character types work")
+    {
+        std::u16string out = u"{:>4}|{}"_nf % 42 % u"abc";
+
+        REQUIRE(out == u"  42|abc");
+    }
+}
+
+TEST_CASE("Format strings are compiled only once", "[format]")
+{
+    SECTION("formatting the same string twice hits the cache")
+    {
+        auto& cache = nitro::format_cache<char>::local();
+
+        std::string fmt = "cached {} format string";
+
+        auto misses = cache.misses();
+        auto hits = cache.hits();
+
+        std::string first = nitro::format(fmt) % 1;
+        std::string second = nitro::format(fmt) % 2;
+
+        REQUIRE(first == "cached 1 format string");
+        REQUIRE(second == "cached 2 format string");
+        REQUIRE(cache.misses() == misses + 1);
+        REQUIRE(cache.hits() == hits + 1);
+    }
+
+    SECTION("the cache size is bounded")
+    {
+        nitro::format_cache<char> cache(8);
+
+        for (int i = 0; i < 100; i++)
+        {
+            cache.get(std::to_string(i) + " {}");
+        }
+
+        REQUIRE(cache.capacity() == 8);
+        REQUIRE(cache.size() == 8);
+        REQUIRE(cache.misses() == 100);
+
+        auto compiled = cache.get("99 {}");
+
+        REQUIRE(compiled->fields().size() == 1);
+        REQUIRE(cache.hits() == 1);
+    }
+}
+
+namespace
+{
+struct celsius
+{
+    double value;
+};
+
+struct streamed_only
+{
+    int value;
+};
+
+std::ostream& operator<<(std::ostream& s, const streamed_only& v)
+{
+    return s << "streamed(" << v.value << ")";
+}
+} // namespace
+
+namespace nitro
+{
+template <>
+struct formatter_traits<celsius>
+{
+    template <class Char, class Traits>
+    static void append(std::basic_string<Char, Traits>& out, const celsius& c,
+                       const format_spec<Char>& spec)
+    {
+        formatter_traits<double>::append(out, c.value, spec);
+        out.append({ Char(' '), Char('C') });
+    }
+};
+} // namespace nitro
+
+TEST_CASE("Formatter traits work", "[format]")
+{
+    SECTION("user specializations are used")
+    {
+        static_assert(nitro::has_formatter_traits<celsius>::value, "");
+
+        REQUIRE(std::string("{:.1f}"_nf % celsius{ 21.55 }) == "21.6 C");
+    }
+
+    SECTION("types without a specialization use operator<<")
+    {
+        static_assert(!nitro::has_formatter_traits<streamed_only>::value, "");
+
+        REQUIRE(std::string("{:>12}"_nf % streamed_only{ 5 }) == " streamed(5)");
+    }
+
+    SECTION("durations are written with their unit")
+    {
+        REQUIRE(std::string("{}"_nf % std::chrono::milliseconds(42)) == "42ms");
+        REQUIRE(std::string("{}"_nf % std::chrono::minutes(3)) == "3min");
+        REQUIRE(std::string("{:>6}"_nf % std::chrono::seconds(5)) == "    5s");
+        REQUIRE(std::string("{}"_nf % std::chrono::duration<int, std::ratio<1, 3>>(2)) ==
+                "2[1/3]s");
+    }
+
+    SECTION("system clock time points are written as date and time")
+    {
+        using namespace std::chrono;
+
+        auto tp = system_clock::time_point(duration_cast<system_clock::duration>(
+            seconds(1614834367) + milliseconds(89)));
+        auto ms = time_point_cast<milliseconds>(tp);
+
+        REQUIRE(std::string("{}"_nf % ms) == "2021-03-04 05:06:07.089");
+        REQUIRE(std::string("{}"_nf % time_point_cast<seconds>(tp)) == "2021-03-04 05:06:07");
+        REQUIRE(std::string("{}"_nf % time_point<system_clock, seconds>(seconds(-1))) ==
+                "1969-12-31 23:59:59");
+    }
+
+    SECTION("ranges and tuples are written element wise")
+    {
+        std::vector<int> v = { 1, 2, 3 };
+
+        REQUIRE(std::string("{}"_nf % v) == "[1, 2, 3]");
+        REQUIRE(std::string("{:02x}"_nf % v) == "[01, 02, 03]");
+        REQUIRE(std::string("{}"_nf % std::make_tuple(1, "a", 'b')) == "(1, a, b)");
+        REQUIRE(std::string("{}"_nf % std::make_pair(std::string("k"), v)) == "(k, [1, 2, 3])");
+    }
+}
+
+TEST_CASE("Floating point values are written with the shortest round-trip digits", "[format]")
+{
+    SECTION("common values are written as expected")
+    {
+        REQUIRE(std::string("{}"_nf % 0.1) == "0.1");
+        REQUIRE(std::string("{}"_nf % 1.0) == "1");
+        REQUIRE(std::string("{}"_nf % 100.0) == "100");
+        REQUIRE(std::string("{}"_nf % -2.5) == "-2.5");
+        REQUIRE(std::string("{}"_nf % 0.0001) == "0.0001");
+        REQUIRE(std::string("{}"_nf % 0.00001) == "1e-05");
+        REQUIRE(std::string("{}"_nf % 1e21) == "1e+21");
+        REQUIRE(std::string("{}"_nf % 123456789012345678.0) == "1.2345678901234568e+17");
+        REQUIRE(std::string("{}"_nf % 5e-324) == "5e-324");
+        REQUIRE(std::string("{}"_nf % 1.7976931348623157e308) == "1.7976931348623157e+308");
+        REQUIRE(std::string("{}"_nf % -0.0) == "-0");
+        REQUIRE(std::string("{}"_nf % 0.1f) == "0.1");
+        REQUIRE(std::string("{}"_nf % 16777216.0f) == "16777216");
+    }
+
+    SECTION("sign and padding apply")
+    {
+        REQUIRE(std::string("{:+}"_nf % 0.5) == "+0.5");
+        REQUIRE(std::string("{:>6}"_nf % 0.5) == "   0.5");
+        REQUIRE(std::string("{:06}"_nf % -0.5) == "-000.5");
+    }
+
+    SECTION("random values parse back exactly")
+    {
+        std::mt19937_64 rng(42);
+
+        for (int i = 0; i < 100000; i++)
+        {
+            auto bits = rng();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            if (!std::isfinite(value))
+            {
+                continue;
+            }
+
+            std::string str = "{}"_nf % value;
+            double parsed = std::strtod(str.c_str(), nullptr);
+
+            REQUIRE(std::memcmp(&parsed, &value, sizeof(value)) == 0);
+        }
+
+        for (int i = 0; i < 100000; i++)
+        {
+            auto bits = static_cast<std::uint32_t>(rng());
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            if (!std::isfinite(value))
+            {
+                continue;
+            }
+
+            std::string str = "{}"_nf % value;
+            float parsed = std::strtof(str.c_str(), nullptr);
+
+            REQUIRE(std::memcmp(&parsed, &value, sizeof(value)) == 0);
+        }
+    }
+}
+
+TEST_CASE("Floating point values with a precision are rounded exactly", "[format]")
+{
+    SECTION("ties round to even")
+    {
+        REQUIRE(std::string("{:.0f}"_nf % 0.5) == "0");
+        REQUIRE(std::string("{:.0f}"_nf % 1.5) == "2");
+        REQUIRE(std::string("{:.0f}"_nf % 2.5) == "2");
+        REQUIRE(std::string("{:.2f}"_nf % 0.125) == "0.12");
+        REQUIRE(std::string("{:.2f}"_nf % 0.375) == "0.38");
+        REQUIRE(std::string("{:.1f}"_nf % 0.15) == "0.1");
+        REQUIRE(std::string("{:.0e}"_nf % 2.5) == "2e+00");
+        REQUIRE(std::string("{:.1f}"_nf % 9.96) == "10.0");
+        REQUIRE(std::string("{:.2e}"_nf % 9.999) == "1.00e+01");
+    }
+
+    SECTION("all types are written like printf")
+    {
+        REQUIRE(std::string("{:e}"_nf % 0.0) == "0.000000e+00");
+        REQUIRE(std::string("{:E}"_nf % 1e-300) == "1.000000E-300");
+        REQUIRE(std::string("{:.3g}"_nf % 0.0001234) == "0.000123");
+        REQUIRE(std::string("{:.3g}"_nf % 0.00001234) == "1.23e-05");
+        REQUIRE(std::string("{:G}"_nf % 1e20) == "1E+20");
+        REQUIRE(std::string("{:g}"_nf % 100.0) == "100");
+        REQUIRE(std::string("{:#g}"_nf % 100.0) == "100.000");
+        REQUIRE(std::string("{:#.0f}"_nf % 3.0) == "3.");
+        REQUIRE(std::string("{:.3}"_nf % 2.0) == "2");
+        REQUIRE(std::string("{:.1f}"_nf % 0.25f) == "0.2");
+        REQUIRE(std::string("{:.0f}"_nf % 1e22) == "10000000000000000000000");
+        REQUIRE(std::string("{:.30f}"_nf % 0.1) == "0.100000000000000005551115123126");
+    }
+
+    SECTION("non-finite values are written as words")
+    {
+        REQUIRE(std::string("{:.2f}"_nf % std::numeric_limits<double>::infinity()) == "inf");
+        REQUIRE(std::string("{:F}"_nf % -std::numeric_limits<double>::infinity()) == "-INF");
+        REQUIRE(std::string("{:+05e}"_nf % std::numeric_limits<double>::quiet_NaN()) == " +nan");
+    }
+
+    SECTION("random values match printf in the C locale")
+    {
+        std::mt19937_64 rng(7);
+        const char types[] = { 'e', 'f', 'g', 'E', 'G' };
+
+        for (int i = 0; i < 20000; i++)
+        {
+            auto bits = rng();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            if (!std::isfinite(value) || std::fabs(value) > 1e100)
+            {
+                continue;
+            }
+
+            const int precision = static_cast<int>(rng() % 20);
+            const char type = types[rng() % 5];
+
+            char format[8];
+            std::snprintf(format, sizeof(format), "%%.*%c", type);
+
+            char expected[512];
+            std::snprintf(expected, sizeof(expected), format, precision, value);
+
+            std::string spec = "{:." + std::to_string(precision) + type + "}";
+            std::string out = nitro::format(spec) % value;
+
+            REQUIRE(out == expected);
+        }
+    }
+}
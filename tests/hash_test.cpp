@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/hash.hpp>
+#include <nitro/lang/tuple_operators.hpp>
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr char literal[] = "a string literal, hashed in a constant expression";
+constexpr std::uint64_t literal_hash = nitro::lang::hash_bytes(literal, sizeof(literal) - 1);
+
+struct point : nitro::lang::tuple_operators<point>
+{
+    point(int x, int y) : x(x), y(y)
+    {
+    }
+
+    auto as_tuple()
+    {
+        return std::tie(x, y);
+    }
+
+    int x;
+    int y;
+};
+} // namespace
+
+TEST_CASE("hash_bytes works in constant expressions", "[lang]")
+{
+    std::string str(literal);
+
+    REQUIRE(nitro::lang::hash_bytes(str.data(), str.size()) == literal_hash);
+    REQUIRE(nitro::lang::hash(str) == static_cast<std::size_t>(literal_hash));
+}
+
+TEST_CASE("hash_bytes depends on all bytes and the seed", "[lang]")
+{
+    std::set<std::uint64_t> hashes;
+
+    std::vector<unsigned char> data(200, 0);
+    for (std::size_t size = 0; size < data.size(); size++)
+    {
+        hashes.insert(nitro::lang::hash_bytes(data.data(), size));
+        hashes.insert(nitro::lang::hash_bytes(data.data(), size, 42));
+
+        if (size > 0)
+        {
+            data[size - 1] = 1;
+            hashes.insert(nitro::lang::hash_bytes(data.data(), size));
+            data[size - 1] = 0;
+        }
+    }
+
+    REQUIRE(hashes.size() == 3 * data.size() - 1);
+}
+
+TEST_CASE("hashes of integers are well distributed", "[lang]")
+{
+    constexpr std::size_t buckets = 1024;
+    std::set<std::size_t> used;
+
+    // sequential keys with a stride of the bucket count would all collide with std::hash
+    for (std::size_t i = 0; i < buckets; i++)
+    {
+        used.insert(nitro::lang::hash(i * buckets) % buckets);
+    }
+
+    REQUIRE(used.size() > buckets / 2);
+}
+
+TEST_CASE("equal values have equal hashes", "[lang]")
+{
+    REQUIRE(nitro::lang::hash(0.0) == nitro::lang::hash(-0.0));
+    REQUIRE(nitro::lang::hash(std::make_tuple(0.0f, 1)) ==
+            nitro::lang::hash(std::make_tuple(-0.0f, 1)));
+
+    REQUIRE(nitro::lang::hash(std::make_pair(1, 2)) == nitro::lang::hash(std::make_tuple(1, 2)));
+    REQUIRE(nitro::lang::hash(point(1, 2)) == nitro::lang::hash(std::make_tuple(1, 2)));
+    REQUIRE(nitro::lang::hash(point(1, 2)) != nitro::lang::hash(point(2, 1)));
+
+    std::vector<int> v = { 1, 2, 3 };
+    std::array<int, 3> a = { { 1, 2, 3 } };
+    REQUIRE(nitro::lang::hash(v) == nitro::lang::hash(a));
+    REQUIRE(nitro::lang::hash(v) == nitro::lang::hash_bytes(v.data(), v.size() * sizeof(int)));
+
+    std::vector<std::string> strings = { "a", "b" };
+    REQUIRE(nitro::lang::hash(strings) != nitro::lang::hash(std::vector<std::string>{ "b", "a" }));
+}
+
+TEST_CASE("hash_wrapper can be seeded", "[lang]")
+{
+    nitro::lang::hash_wrapper<std::string> unseeded;
+    nitro::lang::hash_wrapper<std::string> seeded(42);
+
+    REQUIRE(unseeded("key") == nitro::lang::hash(std::string("key")));
+    REQUIRE(seeded("key") != unseeded("key"));
+    REQUIRE(seeded("key") == nitro::lang::hash_wrapper<std::string>(42)("key"));
+}
+
+TEST_CASE("all string types have the same hash", "[lang]")
+{
+    const char* chars = "a metric name longer than the small string buffer";
+    std::string str(chars);
+    nitro::lang::string_ref ref(str);
+
+    REQUIRE(nitro::lang::hash(chars) == nitro::lang::hash(str));
+    REQUIRE(nitro::lang::hash(ref) == nitro::lang::hash(str));
+
+    nitro::lang::hash_wrapper<std::string> h(42);
+    REQUIRE(h(chars) == h(str));
+    REQUIRE(h(ref) == h(str));
+
+    nitro::lang::string_equal eq;
+    REQUIRE(eq(str, chars));
+    REQUIRE(eq(ref, str));
+    REQUIRE(!eq(str, "a metric name"));
+    REQUIRE(eq(std::string(), static_cast<const char*>(nullptr)));
+
+#if __cplusplus >= 201703L
+    std::string_view view(str);
+    REQUIRE(nitro::lang::hash(view) == nitro::lang::hash(str));
+    REQUIRE(h(view) == h(chars));
+    REQUIRE(eq(view, ref));
+#endif
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/intern.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("interning gives equal symbols for equal strings", "[lang]")
+{
+    auto a = nitro::lang::intern("metric.cpu");
+    auto b = nitro::lang::intern(std::string("metric.cpu"));
+    auto c = nitro::lang::intern(nitro::lang::string_ref("metric.cpu.user").substr(0, 10));
+    auto d = nitro::lang::intern("metric.mem");
+
+    REQUIRE(a == b);
+    REQUIRE(a == c);
+    REQUIRE(a != d);
+    REQUIRE(a.id() != d.id());
+
+    REQUIRE(a.str() == "metric.cpu");
+    REQUIRE(std::string(a.c_str()) == "metric.cpu");
+    REQUIRE(a.size() == 10);
+    REQUIRE(a.str().data() == b.str().data());
+
+    std::ostringstream s;
+    s << d;
+    REQUIRE(s.str() == "metric.mem");
+
+#if __cplusplus >= 201703L
+    REQUIRE(nitro::lang::intern(std::string_view("metric.mem")) == d);
+#endif
+}
+
+TEST_CASE("the default symbol is the empty string", "[lang]")
+{
+    nitro::lang::symbol empty;
+
+    REQUIRE(empty.empty());
+    REQUIRE(empty.str() == "");
+    REQUIRE(empty == nitro::lang::intern(""));
+    REQUIRE(!nitro::lang::intern("x").empty());
+}
+
+TEST_CASE("literals can be hashed at compile time", "[lang]")
+{
+    static constexpr nitro::lang::symbol_key key("compile.time");
+    static_assert(key.size() == 12, "");
+    static_assert(key.hash() == nitro::lang::hash_bytes("compile.time", 12), "");
+
+    REQUIRE(nitro::lang::intern(key) == nitro::lang::intern("compile.time"));
+    REQUIRE(nitro::lang::intern("compile.time"_sym) == nitro::lang::intern(key));
+}
+
+TEST_CASE("symbols hash as integers", "[lang]")
+{
+    std::unordered_set<nitro::lang::symbol> set;
+    std::set<nitro::lang::symbol> ordered;
+
+    for (int i = 0; i < 5000; i++)
+    {
+        auto sym = nitro::lang::intern("name." + std::to_string(i % 100));
+        set.insert(sym);
+        ordered.insert(sym);
+    }
+
+    REQUIRE(set.size() == 100);
+    REQUIRE(ordered.size() == 100);
+    REQUIRE(nitro::lang::hash(nitro::lang::intern("name.1")) ==
+            std::hash<nitro::lang::symbol>()(nitro::lang::intern("name.1")));
+}
+
+TEST_CASE("strings can be interned from multiple threads", "[lang]")
+{
+    const int threads = 4;
+    const int names = 20000;
+
+    std::vector<std::vector<nitro::lang::symbol>> results(threads);
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&results, t, names]() {
+            for (int i = 0; i < names; i++)
+            {
+                // every thread interns the same names in a different order
+                auto n = (i * (t + 1) * 7919) % names;
+                results[t].push_back(nitro::lang::intern("thread.name." + std::to_string(n)));
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        for (int i = 0; i < names; i++)
+        {
+            auto n = (i * (t + 1) * 7919) % names;
+            REQUIRE(results[t][i] == nitro::lang::intern("thread.name." + std::to_string(n)));
+            REQUIRE(results[t][i].str() == "thread.name." + std::to_string(n));
+        }
+    }
+}
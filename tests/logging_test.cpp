@@ -255,3 +255,24 @@ TEST_CASE("Logging lambdas works", "[log]")
         CHECK(i == 4);
     }
 }
+
+TEST_CASE("Values with formatter_traits are appended to the message", "[log]")
+{
+    SECTION("Without manipulators")
+    {
+        auto log = logging::info();
+        log << "test 43: " << 42 << ' ' << 1.5 << ' ' << std::make_pair(1, "two");
+
+        CHECK(log.record().message() == "test 43: 42 1.5 (1, two)");
+    }
+
+    SECTION("After a manipulator, values go through the stream")
+    {
+        auto log = logging::info();
+        log << "test 44: " << std::hex << 255 << ' ' << std::make_pair(10, 11);
+
+        CHECK(log.record().message() == "test 44: ");
+        // pairs have no operator<<, so they are formatted and the manipulator doesn't apply
+        CHECK(log.sstr().str() == "ff (10, 11)");
+    }
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/optional.hpp>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<nitro::lang::optional<int>>::value,
+              "optional of trivially copyable types must be trivially copyable");
+static_assert(sizeof(nitro::lang::optional<double>) == 2 * sizeof(double),
+              "optional must store its value inline");
+
+TEST_CASE("optional can be empty", "[lang]")
+{
+    nitro::lang::optional<std::string> o;
+
+    REQUIRE(!o);
+    REQUIRE(!o.has_value());
+    REQUIRE(o.value_or("default") == "default");
+    REQUIRE_THROWS_AS(*o, nitro::except::exception);
+}
+
+TEST_CASE("optional stores values", "[lang]")
+{
+    nitro::lang::optional<std::string> o = std::string("a value");
+
+    REQUIRE(o);
+    REQUIRE(*o == "a value");
+    REQUIRE(o->size() == 7);
+    REQUIRE(o.value_or("default") == "a value");
+
+    *o = "changed";
+    REQUIRE(o.value() == "changed");
+
+    o = std::string("assigned");
+    REQUIRE(*o == "assigned");
+
+    o.emplace(3, 'x');
+    REQUIRE(*o == "xxx");
+
+    o.reset();
+    REQUIRE(!o);
+}
+
+TEST_CASE("optional can be copied and moved", "[lang]")
+{
+    nitro::lang::optional<std::string> o = std::string("a value");
+    nitro::lang::optional<std::string> empty;
+
+    auto copy = o;
+    REQUIRE(*copy == "a value");
+    REQUIRE(*o == "a value");
+
+    copy = empty;
+    REQUIRE(!copy);
+
+    auto moved = std::move(o);
+    REQUIRE(*moved == "a value");
+
+    nitro::lang::optional<std::unique_ptr<int>> p = std::make_unique<int>(42);
+    nitro::lang::optional<std::unique_ptr<int>> q;
+    q = std::move(p);
+    REQUIRE(**q == 42);
+}
+
+TEST_CASE("optional of trivial types", "[lang]")
+{
+    nitro::lang::optional<int> o;
+    REQUIRE(o.value_or(1) == 1);
+
+    o = 5;
+    auto copy = o;
+    REQUIRE(*copy == 5);
+
+    o.reset();
+    copy = o;
+    REQUIRE(!copy);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/enumerate.hpp>
+#include <nitro/lang/parallel.hpp>
+#include <nitro/lang/reverse.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ranges can be split into chunks", "[lang]")
+{
+    std::vector<int> input(10);
+    std::iota(input.begin(), input.end(), 0);
+
+    auto chunks = nitro::lang::chunked(input, 4);
+
+    REQUIRE(chunks.size() == 3);
+    REQUIRE(chunks[0].size() == 4);
+    REQUIRE(chunks[2].size() == 2);
+    REQUIRE(*chunks[2].begin() == 8);
+
+    std::size_t count = 0;
+    int sum = 0;
+    for (auto chunk : chunks)
+    {
+        for (auto value : chunk)
+        {
+            sum += value;
+        }
+        count++;
+    }
+
+    REQUIRE(count == 3);
+    REQUIRE(sum == 45);
+
+    auto enumerated = nitro::lang::enumerate(input);
+    for (auto chunk : nitro::lang::chunked(enumerated, 3))
+    {
+        for (auto e : chunk)
+        {
+            CHECK(e.index() == static_cast<std::size_t>(e.value()));
+        }
+    }
+
+    std::vector<int> empty;
+    REQUIRE(nitro::lang::chunked(empty, 4).size() == 0);
+    REQUIRE(nitro::lang::chunked(empty, 4).begin() == nitro::lang::chunked(empty, 4).end());
+}
+
+TEST_CASE("parallel_for_each visits every element once", "[lang]")
+{
+    std::vector<int> input(100000);
+    std::iota(input.begin(), input.end(), 0);
+
+    SECTION("for plain ranges")
+    {
+        nitro::lang::parallel_for_each(input, [](int& value) { value *= 2; });
+
+        for (std::size_t i = 0; i < input.size(); i++)
+        {
+            REQUIRE(input[i] == static_cast<int>(2 * i));
+        }
+    }
+
+    SECTION("for enumerate ranges with global indices")
+    {
+        std::vector<std::size_t> indices(input.size());
+
+        nitro::lang::parallel_for_each(nitro::lang::enumerate(input), [&indices](auto e) {
+            indices[static_cast<std::size_t>(e.value())] = e.index();
+        });
+
+        for (std::size_t i = 0; i < indices.size(); i++)
+        {
+            REQUIRE(indices[i] == i);
+        }
+    }
+
+    SECTION("for enumerated reverse ranges")
+    {
+        std::atomic<std::size_t> mismatches(0);
+
+        nitro::lang::parallel_for_each(
+            nitro::lang::enumerate(nitro::lang::reverse(input)),
+            [&mismatches, &input](auto e) {
+                if (static_cast<std::size_t>(e.value()) != input.size() - 1 - e.index())
+                {
+                    mismatches++;
+                }
+            },
+            7);
+
+        REQUIRE(mismatches == 0);
+    }
+
+    SECTION("for empty ranges")
+    {
+        std::vector<int> empty;
+        nitro::lang::parallel_for_each(empty, [](int&) { FAIL(); });
+    }
+}
+
+TEST_CASE("parallel_for_each rethrows exceptions", "[lang]")
+{
+    std::vector<int> input(1000, 1);
+    std::atomic<int> calls(0);
+
+    REQUIRE_THROWS_AS(nitro::lang::parallel_for_each(input,
+                                                     [&calls](int value) {
+                                                         calls++;
+                                                         if (value == 1)
+                                                         {
+                                                             throw std::runtime_error("fail");
+                                                         }
+                                                     },
+                                                     10),
+                      std::runtime_error);
+
+    REQUIRE(calls > 0);
+}
@@ -0,0 +1,301 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/lang/mpmc_queue.hpp>
+#include <nitro/lang/spsc_queue.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// an output iterator, whose assignment throws once the limit is reached
+struct limited_output
+{
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    limited_output& operator*()
+    {
+        return *this;
+    }
+
+    limited_output& operator++()
+    {
+        return *this;
+    }
+
+    limited_output& operator=(const std::string& value)
+    {
+        if (out->size() == limit)
+            throw std::runtime_error("output is full");
+
+        out->push_back(value);
+        return *this;
+    }
+
+    std::vector<std::string>* out;
+    std::size_t limit;
+};
+
+// copying throws on demand, moving never does
+struct fragile
+{
+    static bool fail;
+
+    explicit fragile(int v) : value(v)
+    {
+    }
+
+    fragile(const fragile& other) : value(other.value)
+    {
+        if (fail)
+            throw std::runtime_error("copy failed");
+    }
+
+    fragile(fragile&&) noexcept = default;
+    fragile& operator=(const fragile&) = default;
+    fragile& operator=(fragile&&) noexcept = default;
+
+    int value;
+};
+
+bool fragile::fail = false;
+} // namespace
+
+TEST_CASE("spsc queue works in a single thread", "[lang]")
+{
+    nitro::lang::spsc_queue<std::string> q(3);
+
+    REQUIRE(q.capacity() == 4);
+    REQUIRE(q.empty());
+
+    std::string value;
+    REQUIRE(!q.try_pop(value));
+
+    for (int round = 0; round < 10; round++)
+    {
+        REQUIRE(q.try_push("a string, which is too long for small string optimization"));
+        REQUIRE(q.try_emplace(3, 'b'));
+        REQUIRE(q.size() == 2);
+
+        REQUIRE(q.try_pop(value));
+        REQUIRE(value == "a string, which is too long for small string optimization");
+        REQUIRE(q.pop() == "bbb");
+    }
+
+    std::vector<std::string> in = { "1", "2", "3", "4", "5", "6" };
+    REQUIRE(q.try_push_n(in.begin(), in.size()) == 4);
+    REQUIRE(!q.try_push("7"));
+    REQUIRE(q.size() == 4);
+
+    std::vector<std::string> out(6);
+    REQUIRE(q.try_pop_n(out.begin(), 3) == 3);
+    REQUIRE(out[2] == "3");
+    REQUIRE(q.try_pop_n(out.begin(), 6) == 1);
+    REQUIRE(out[0] == "4");
+
+    // the remaining elements are destroyed with the queue
+    REQUIRE(q.try_push_n(in.begin(), 2) == 2);
+}
+
+TEST_CASE("mpmc queue works in a single thread", "[lang]")
+{
+    nitro::lang::mpmc_queue<std::string> q(1);
+
+    REQUIRE(q.capacity() == 2);
+
+    std::string value;
+    REQUIRE(!q.try_pop(value));
+
+    for (int round = 0; round < 10; round++)
+    {
+        REQUIRE(q.try_push("a string, which is too long for small string optimization"));
+        REQUIRE(q.try_emplace(3, 'b'));
+        REQUIRE(!q.try_push("c"));
+        REQUIRE(q.size() == 2);
+
+        REQUIRE(q.try_pop(value));
+        REQUIRE(value == "a string, which is too long for small string optimization");
+        REQUIRE(q.pop() == "bbb");
+        REQUIRE(q.empty());
+    }
+
+    nitro::lang::mpmc_queue<int> numbers(8);
+    std::vector<int> in(10);
+    std::iota(in.begin(), in.end(), 0);
+
+    REQUIRE(numbers.try_push_n(in.begin(), 5) == 5);
+    REQUIRE(numbers.try_push_n(in.begin() + 5, 5) == 3);
+
+    std::vector<int> out(10);
+    REQUIRE(numbers.try_pop_n(out.begin(), 10) == 8);
+    REQUIRE(std::equal(out.begin(), out.begin() + 8, in.begin()));
+    REQUIRE(numbers.try_pop_n(out.begin(), 10) == 0);
+
+    nitro::lang::mpmc_queue<std::string> leftover(4);
+    leftover.push("destroyed with the queue");
+}
+
+TEST_CASE("queues pop into output iterators", "[lang]")
+{
+    std::vector<int> in = { 1, 2, 3 };
+
+    nitro::lang::spsc_queue<int> spsc(4);
+    nitro::lang::mpmc_queue<int> mpmc(4);
+
+    spsc.try_push_n(in.begin(), 3);
+    mpmc.try_push_n(in.begin(), 3);
+
+    std::vector<int> spsc_out;
+    std::vector<int> mpmc_out;
+
+    REQUIRE(spsc.try_pop_n(std::back_inserter(spsc_out), 4) == 3);
+    REQUIRE(mpmc.try_pop_n(std::back_inserter(mpmc_out), 4) == 3);
+    REQUIRE(spsc_out == in);
+    REQUIRE(mpmc_out == in);
+}
+
+TEST_CASE("queues stay consistent, if an element operation throws", "[lang]")
+{
+    std::vector<std::string> in = { "a", "b", "c", "d" };
+    std::vector<std::string> out;
+
+    SECTION("spsc queue keeps the element, whose output threw")
+    {
+        nitro::lang::spsc_queue<std::string> q(4);
+        q.try_push_n(in.begin(), 4);
+
+        REQUIRE_THROWS_AS(q.try_pop_n(limited_output{ &out, 2 }, 4), std::runtime_error);
+        REQUIRE(out.size() == 2);
+        REQUIRE(q.size() == 2);
+        REQUIRE(q.pop() == "c");
+        REQUIRE(q.pop() == "d");
+        REQUIRE(q.empty());
+    }
+
+    SECTION("mpmc queue releases all claimed cells")
+    {
+        nitro::lang::mpmc_queue<std::string> q(4);
+        q.try_push_n(in.begin(), 4);
+
+        REQUIRE_THROWS_AS(q.try_pop_n(limited_output{ &out, 2 }, 4), std::runtime_error);
+        REQUIRE(out.size() == 2);
+        REQUIRE(q.empty());
+
+        // the queue still works afterwards
+        for (int round = 0; round < 3; round++)
+        {
+            REQUIRE(q.try_push_n(in.begin(), 4) == 4);
+            REQUIRE(q.try_pop_n(std::back_inserter(out), 4) == 4);
+        }
+    }
+
+    SECTION("mpmc queue doesn't claim a cell for a throwing copy")
+    {
+        nitro::lang::mpmc_queue<fragile> q(2);
+        fragile element(1);
+
+        fragile::fail = true;
+        REQUIRE_THROWS_AS(q.try_push(element), std::runtime_error);
+        REQUIRE_THROWS_AS(q.try_push_n(&element, 1), std::runtime_error);
+        fragile::fail = false;
+
+        REQUIRE(q.try_push(element));
+        REQUIRE(q.try_push_n(&element, 1) == 1);
+
+        fragile popped(0);
+        REQUIRE(q.try_pop(popped));
+        REQUIRE(q.try_pop(popped));
+        REQUIRE(popped.value == 1);
+        REQUIRE(q.empty());
+    }
+}
+
+TEST_CASE("spsc queue passes all elements between threads", "[lang]")
+{
+    nitro::lang::spsc_queue<std::uint64_t> q(64);
+    const std::uint64_t count = 100000;
+
+    std::thread producer([&q, count]() {
+        for (std::uint64_t i = 0; i < count; i += 4)
+        {
+            std::uint64_t batch[4] = { i, i + 1, i + 2, i + 3 };
+            std::size_t pushed = 0;
+            while (pushed < 4)
+            {
+                pushed += q.try_push_n(batch + pushed, 4 - pushed);
+            }
+        }
+    });
+
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        REQUIRE(q.pop() == i);
+    }
+
+    producer.join();
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("mpmc queue passes all elements between threads", "[lang]")
+{
+    nitro::lang::mpmc_queue<std::uint64_t> q(16);
+    const std::uint64_t per_thread = 20000;
+    const std::uint64_t producers = 3;
+    const std::uint64_t consumers = 3;
+
+    std::vector<std::thread> threads;
+    std::vector<std::uint64_t> sums(consumers);
+
+    for (std::uint64_t p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&q, per_thread]() {
+            for (std::uint64_t i = 1; i <= per_thread; i++)
+            {
+                q.push(i);
+            }
+        });
+    }
+
+    for (std::uint64_t c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&q, &sums, c, per_thread, producers, consumers]() {
+            std::uint64_t buffer[8];
+            for (std::uint64_t received = 0; received < per_thread * producers / consumers;)
+            {
+                auto left = per_thread * producers / consumers - received;
+                auto n = q.try_pop_n(buffer, std::min<std::uint64_t>(left, 8));
+
+                if (n == 0)
+                {
+                    buffer[0] = q.pop();
+                    n = 1;
+                }
+
+                for (std::size_t i = 0; i < n; i++)
+                {
+                    sums[c] += buffer[i];
+                }
+                received += n;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(std::accumulate(sums.begin(), sums.end(), std::uint64_t(0)) ==
+            producers * per_thread * (per_thread + 1) / 2);
+    REQUIRE(q.empty());
+}
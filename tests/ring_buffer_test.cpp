@@ -0,0 +1,224 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/ring_buffer.hpp>
+
+#include "tracked.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+template <typename Buffer>
+std::vector<int> contents(const Buffer& b)
+{
+    return std::vector<int>(b.begin(), b.end());
+}
+} // namespace
+
+TEST_CASE("ring buffer init", "[lang]")
+{
+    nitro::lang::ring_buffer<int> b(4);
+
+    REQUIRE(b.empty());
+    REQUIRE(!b.full());
+    REQUIRE(b.size() == 0);
+    REQUIRE(b.capacity() == 4);
+    REQUIRE(b.policy() == nitro::lang::ring_policy::overwrite_oldest);
+    REQUIRE(b.begin() == b.end());
+}
+
+TEST_CASE("ring buffer overwrites the oldest elements", "[lang]")
+{
+    // 3 is not a power of two, 4 is, both index paths must agree
+    for (std::size_t capacity : { 3, 4 })
+    {
+        nitro::lang::ring_buffer<int> b(capacity);
+
+        for (int i = 0; i < 10; i++)
+        {
+            REQUIRE(b.push_back(i));
+        }
+
+        REQUIRE(b.full());
+        REQUIRE(b.size() == capacity);
+        REQUIRE(b.front() == 10 - static_cast<int>(capacity));
+        REQUIRE(b.back() == 9);
+
+        std::vector<int> expected(capacity);
+        std::iota(expected.begin(), expected.end(), 10 - static_cast<int>(capacity));
+        REQUIRE(contents(b) == expected);
+
+        for (std::size_t i = 0; i < capacity; i++)
+        {
+            REQUIRE(b[i] == expected[i]);
+            REQUIRE(b.at(i) == expected[i]);
+        }
+
+        REQUIRE_THROWS_AS(b.at(capacity), nitro::except::exception);
+    }
+}
+
+TEST_CASE("ring buffer rejects new elements", "[lang]")
+{
+    nitro::lang::ring_buffer<int> b(3, nitro::lang::ring_policy::reject_new);
+
+    REQUIRE(b.push_back(1));
+    REQUIRE(b.push_back(2));
+    REQUIRE(b.push_back(3));
+    REQUIRE(!b.push_back(4));
+    REQUIRE(contents(b) == std::vector<int>{ 1, 2, 3 });
+
+    b.pop_front();
+    REQUIRE(b.push_back(5));
+    REQUIRE(contents(b) == std::vector<int>{ 2, 3, 5 });
+}
+
+TEST_CASE("ring buffer pops from both ends", "[lang]")
+{
+    nitro::lang::ring_buffer<int> b(4);
+
+    for (int i = 0; i < 6; i++)
+    {
+        b.push_back(i);
+    }
+
+    b.pop_front();
+    b.pop_back();
+    REQUIRE(contents(b) == std::vector<int>{ 3, 4 });
+
+    b.pop_front();
+    b.pop_front();
+    REQUIRE(b.empty());
+    REQUIRE_THROWS_AS(b.pop_front(), nitro::except::exception);
+    REQUIRE_THROWS_AS(b.pop_back(), nitro::except::exception);
+}
+
+TEST_CASE("ring buffer iterators are random access", "[lang]")
+{
+    nitro::lang::ring_buffer<int> b(5);
+
+    for (int i = 0; i < 8; i++)
+    {
+        b.push_back(i);
+    }
+
+    static_assert(std::is_same<std::iterator_traits<decltype(b.begin())>::iterator_category,
+                               std::random_access_iterator_tag>::value,
+                  "");
+
+    auto it = b.begin();
+    REQUIRE(b.end() - it == 5);
+    REQUIRE(it[2] == 5);
+    REQUIRE(*(it + 4) == 7);
+    REQUIRE(*(b.end() - 1) == 7);
+    REQUIRE(it < b.end());
+
+    std::vector<int> reversed(b.rbegin(), b.rend());
+    REQUIRE(reversed == std::vector<int>{ 7, 6, 5, 4, 3 });
+
+    nitro::lang::ring_buffer<int>::const_iterator cit = it;
+    REQUIRE(*cit == 3);
+
+    std::sort(b.begin(), b.end(), [](int x, int y) { return x > y; });
+    REQUIRE(contents(b) == std::vector<int>{ 7, 6, 5, 4, 3 });
+    REQUIRE(std::lower_bound(b.begin(), b.end(), 5, [](int x, int y) { return x > y; }) -
+                b.begin() ==
+            2);
+}
+
+TEST_CASE("ring buffer splits into at most two spans", "[lang]")
+{
+    nitro::lang::ring_buffer<int> b(4);
+
+    b.push_back(1);
+    b.push_back(2);
+
+    auto spans = b.as_spans();
+    REQUIRE(spans[0].size() == 2);
+    REQUIRE(spans[1].empty());
+    REQUIRE(spans[0][0] == 1);
+
+    for (int i = 3; i <= 6; i++)
+    {
+        b.push_back(i);
+    }
+
+    const auto& cb = b;
+    auto cspans = cb.as_spans();
+    REQUIRE(cspans[0].size() == 2);
+    REQUIRE(cspans[1].size() == 2);
+    REQUIRE(cspans[0].size_bytes() == 2 * sizeof(int));
+
+    int out[4];
+    std::memcpy(out, cspans[0].data(), cspans[0].size_bytes());
+    std::memcpy(out + cspans[0].size(), cspans[1].data(), cspans[1].size_bytes());
+    REQUIRE(std::vector<int>(out, out + 4) == std::vector<int>{ 3, 4, 5, 6 });
+}
+
+TEST_CASE("ring buffer constructs and destroys elements", "[lang]")
+{
+    {
+        nitro::lang::ring_buffer<tracked> b(3);
+
+        for (int i = 0; i < 5; i++)
+        {
+            b.emplace_back(i);
+        }
+
+        REQUIRE(tracked::alive == 3);
+
+        // refers to the element, which is overwritten
+        b.push_back(b.front());
+        REQUIRE(b.back().value == 2);
+        REQUIRE(tracked::alive == 3);
+
+        b.pop_front();
+        REQUIRE(tracked::alive == 2);
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("ring buffer copy and move", "[lang]")
+{
+    nitro::lang::ring_buffer<std::string> b(3);
+
+    for (int i = 0; i < 5; i++)
+    {
+        b.push_back(std::to_string(i));
+    }
+
+    nitro::lang::ring_buffer<std::string> c = b;
+    REQUIRE(c.size() == 3);
+    REQUIRE(std::equal(b.begin(), b.end(), c.begin()));
+
+    c.push_back("5");
+    REQUIRE(c.front() == "3");
+    REQUIRE(b.front() == "2");
+
+    nitro::lang::ring_buffer<std::string> m = std::move(c);
+    REQUIRE(m.size() == 3);
+    REQUIRE(m.back() == "5");
+    REQUIRE(c.empty());
+    REQUIRE(c.capacity() == 3);
+
+    // a moved-from buffer keeps its capacity and is usable again
+    c.push_back("x");
+    REQUIRE(c.front() == "x");
+
+    nitro::lang::ring_buffer<std::string> r(1, nitro::lang::ring_policy::reject_new);
+    r = b;
+    REQUIRE(r.capacity() == 3);
+    REQUIRE(r.policy() == nitro::lang::ring_policy::overwrite_oldest);
+    REQUIRE(r.front() == "2");
+
+    r = std::move(m);
+    REQUIRE(r.front() == "3");
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/soa_vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct sample : nitro::lang::tuple_operators<sample>
+{
+    sample() = default;
+
+    sample(std::uint64_t time, double value, std::string name)
+    : time(time), value(value), name(std::move(name))
+    {
+    }
+
+    auto as_tuple()
+    {
+        return std::tie(time, value, name);
+    }
+
+    std::uint64_t time = 0;
+    double value = 0;
+    std::string name;
+};
+} // namespace
+
+TEST_CASE("soa vector init", "[lang]")
+{
+    nitro::lang::soa_vector<sample> v;
+
+    REQUIRE(v.empty());
+    REQUIRE(v.size() == 0);
+    REQUIRE(v.begin() == v.end());
+
+    static_assert(nitro::lang::soa_vector<sample>::column_count == 3, "");
+    static_assert(
+        std::is_same<nitro::lang::soa_vector<sample>::column_type<1>, double>::value, "");
+}
+
+TEST_CASE("soa vector stores each field in its own column", "[lang]")
+{
+    nitro::lang::soa_vector<sample> v;
+
+    for (std::uint64_t i = 0; i < 100; i++)
+    {
+        v.push_back(sample(i, i * 0.5, std::to_string(i)));
+    }
+
+    REQUIRE(v.size() == 100);
+
+    auto times = v.column<0>();
+    auto values = v.column<1>();
+
+    REQUIRE(times.size() == 100);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(times.data()) % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(values.data()) % 64 == 0);
+    REQUIRE(std::accumulate(times.begin(), times.end(), std::uint64_t(0)) == 4950);
+    REQUIRE(values[42] == 21.0);
+    REQUIRE(v.column<2>()[7] == "7");
+
+    const auto& cv = v;
+    REQUIRE(cv.column<0>().back() == 99);
+}
+
+TEST_CASE("soa vector references behave like T&", "[lang]")
+{
+    nitro::lang::soa_vector<sample> v = { sample(1, 1.5, "a"), sample(2, 2.5, "b") };
+
+    sample s = v[1];
+    REQUIRE(s == sample(2, 2.5, "b"));
+
+    v[0] = sample(3, 3.5, "c");
+    REQUIRE(v.column<0>()[0] == 3);
+    REQUIRE(v.front().get<2>() == "c");
+
+    v[1].get<1>() = 4.5;
+    REQUIRE(v.column<1>()[1] == 4.5);
+
+    v[1] = v[0];
+    REQUIRE(sample(v.back()) == sample(3, 3.5, "c"));
+
+    REQUIRE(nitro::lang::as_tuple(v.back()) == v.at(0).as_tuple());
+    REQUIRE_THROWS_AS(v.at(2), nitro::except::exception);
+
+    for (auto r : v)
+    {
+        r.get<0>() += 10;
+    }
+    REQUIRE(v.column<0>()[0] == 13);
+    REQUIRE(v.column<0>()[1] == 13);
+}
+
+TEST_CASE("soa vector iterators work with algorithms", "[lang]")
+{
+    nitro::lang::soa_vector<sample> v;
+
+    for (std::uint64_t i : { 5, 3, 9, 1 })
+    {
+        v.emplace_back(i, i * 2.0, std::to_string(i));
+    }
+
+    std::sort(v.begin(), v.end());
+
+    REQUIRE(std::vector<std::uint64_t>(v.column<0>().begin(), v.column<0>().end()) ==
+            std::vector<std::uint64_t>{ 1, 3, 5, 9 });
+    REQUIRE(v.column<2>()[3] == "9");
+    REQUIRE(v.column<1>()[3] == 18.0);
+
+    nitro::lang::soa_vector<sample>::const_iterator it = v.begin() + 2;
+    REQUIRE(sample(*it).time == 5);
+    REQUIRE(v.end() - it == 2);
+}
+
+TEST_CASE("soa vector appends in bulk", "[lang]")
+{
+    std::vector<sample> aos;
+    for (std::uint64_t i = 0; i < 50; i++)
+    {
+        aos.emplace_back(i, 1.0, "x");
+    }
+
+    nitro::lang::soa_vector<sample> v;
+    v.append(aos.begin(), aos.end());
+    REQUIRE(v.size() == 50);
+    REQUIRE(v.capacity() >= 50);
+
+    std::list<sample> more = { sample(50, 2.0, "y") };
+    v.append(more.begin(), more.end());
+    REQUIRE(v.back().get<2>() == "y");
+
+    v.pop_back();
+    REQUIRE(v.size() == 50);
+
+    v.resize(60);
+    REQUIRE(v.column<1>()[59] == 0.0);
+    REQUIRE(v.column<2>()[59].empty());
+
+    v.clear();
+    REQUIRE(v.empty());
+    REQUIRE_THROWS_AS(v.pop_back(), nitro::except::exception);
+}
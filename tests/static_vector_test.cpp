@@ -0,0 +1,189 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/static_vector.hpp>
+
+#include "tracked.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+constexpr int sum_of_squares(int n)
+{
+    nitro::lang::static_vector<int, 16> v;
+
+    for (int i = 1; i <= n; i++)
+    {
+        v.emplace_back(i * i);
+    }
+
+    v.pop_back();
+
+    int sum = 0;
+    for (auto x : v)
+    {
+        sum += x;
+    }
+
+    return sum;
+}
+
+// a tracked value, whose copy throws for a negative value
+struct fragile : tracked
+{
+    using tracked::tracked;
+
+    fragile(const fragile& other) : tracked(other)
+    {
+        if (value < 0)
+        {
+            throw std::runtime_error("copy failed");
+        }
+    }
+};
+} // namespace
+
+TEST_CASE("static vector init", "[lang]")
+{
+    nitro::lang::static_vector<std::int64_t, 10> v;
+
+    REQUIRE(v.size() == 0);
+    REQUIRE(v.empty());
+    REQUIRE(v.capacity() == 10);
+    REQUIRE(sizeof(v) == sizeof(std::int64_t) * 10 + sizeof(std::size_t));
+}
+
+TEST_CASE("static vector is usable in constant expressions", "[lang]")
+{
+    constexpr nitro::lang::static_vector<int, 4> v = { 1, 2, 3 };
+
+    static_assert(v.size() == 3, "");
+    static_assert(v[1] == 2, "");
+    static_assert(v.back() == 3, "");
+    static_assert(sum_of_squares(4) == 1 + 4 + 9, "");
+}
+
+TEST_CASE("static vector read and write", "[lang]")
+{
+    nitro::lang::static_vector<std::int64_t, 10> v;
+
+    v.emplace_back(5);
+    v.emplace_back(7);
+
+    REQUIRE(v.size() == 2);
+    REQUIRE(v[0] == 5);
+    REQUIRE(v.front() == 5);
+    REQUIRE(v.at(1) == 7);
+    REQUIRE(v.back() == 7);
+    REQUIRE_THROWS_AS(v.at(2), nitro::except::exception);
+    REQUIRE(std::get<1>(v) == 7);
+}
+
+TEST_CASE("static vector capacity is enforced", "[lang]")
+{
+    nitro::lang::static_vector<std::int64_t, 2> v = { 1, 2 };
+
+    REQUIRE_THROWS_AS(v.emplace_back(3), nitro::except::exception);
+    REQUIRE(v.size() == 2);
+
+    v.pop_back();
+    v.pop_back();
+    REQUIRE_THROWS_AS(v.pop_back(), nitro::except::exception);
+}
+
+TEST_CASE("static vector emplace and erase", "[lang]")
+{
+    nitro::lang::static_vector<std::string, 10> v = { "a", "c" };
+
+    v.emplace(v.begin() + 1, "b");
+    v.emplace(v.end(), "d");
+    REQUIRE(v.size() == 4);
+    REQUIRE(*v.rbegin() == "d");
+    REQUIRE(v[0] + v[1] + v[2] + v[3] == "abcd");
+
+    v.erase(v.begin());
+    REQUIRE(v.size() == 3);
+    REQUIRE(v.front() == "b");
+    REQUIRE(v.back() == "d");
+}
+
+TEST_CASE("static vector array assignment", "[lang]")
+{
+    constexpr std::array<std::int64_t, 6> INIT_VALUES = { 0, 1, 2, 3, 4, 5 };
+
+    nitro::lang::static_vector<std::int64_t, 10> v(INIT_VALUES);
+
+    REQUIRE(v.front() == 0);
+    REQUIRE(v.back() == 5);
+    REQUIRE(v.size() == 6);
+
+    nitro::lang::static_vector<std::int64_t, 10> w = { 6, 7, 8 };
+    v.push_back(w.begin(), w.end());
+
+    REQUIRE(v.size() == 9);
+    REQUIRE(v.back() == 8);
+}
+
+TEST_CASE("static vector constructs elements only on insertion", "[lang]")
+{
+    {
+        nitro::lang::static_vector<tracked, 100> v;
+        REQUIRE(tracked::alive == 0);
+
+        v.emplace_back(1);
+        v.emplace_back(2);
+        v.emplace_back(3);
+        REQUIRE(tracked::alive == 3);
+
+        v.pop_back();
+        REQUIRE(tracked::alive == 2);
+
+        v.erase(v.begin());
+        REQUIRE(tracked::alive == 1);
+        REQUIRE(v.front().value == 2);
+
+        auto w = v;
+        REQUIRE(tracked::alive == 2);
+
+        w.emplace_back(4);
+        v = w;
+        REQUIRE(tracked::alive == 4);
+        REQUIRE(v.back().value == 4);
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("static vector destroys copied elements if a copy throws", "[lang]")
+{
+    {
+        nitro::lang::static_vector<fragile, 4> v;
+        v.emplace_back(1);
+        v.emplace_back(-1);
+        REQUIRE(tracked::alive == 2);
+
+        using vector = nitro::lang::static_vector<fragile, 4>;
+        REQUIRE_THROWS_AS(vector(v), std::runtime_error);
+        REQUIRE(tracked::alive == 2);
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("static vector with unique ptr", "[lang]")
+{
+    nitro::lang::static_vector<std::unique_ptr<std::int64_t>, 2> v;
+    v.insert(std::make_unique<std::int64_t>(5));
+    v.insert(std::make_unique<std::int64_t>(6));
+
+    auto w = std::move(v);
+    REQUIRE(*w[0] == 5);
+
+    REQUIRE_NOTHROW(w.erase(w.begin()));
+    REQUIRE(*w.front() == 6);
+}
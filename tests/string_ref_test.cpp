@@ -2,7 +2,12 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <nitro/lang/hash.hpp>
+
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <string>
 
 void test_func(const std::string&)
 {
@@ -43,3 +48,89 @@ TEST_CASE("String ref works", "[lang]")
         REQUIRE(std::string("literally a string literal") == sr2);
     }
 }
+
+TEST_CASE("String ref knows its length", "[lang]")
+{
+    std::string str("Hello World");
+    nitro::lang::string_ref sr = str;
+
+    REQUIRE(sr.size() == str.size());
+    REQUIRE(sr.data() == str.data());
+    REQUIRE(std::string(sr.begin(), sr.end()) == str);
+
+    SECTION("strings with embedded zeros keep their length")
+    {
+        std::string zeros("a\0b", 3);
+        nitro::lang::string_ref zr = zeros;
+
+        REQUIRE(zr.size() == 3);
+        REQUIRE(zr.str() == zeros);
+    }
+
+    SECTION("substrings don't copy")
+    {
+        auto world = sr.substr(6);
+
+        REQUIRE(world.data() == str.data() + 6);
+        REQUIRE(world == "World");
+        REQUIRE(sr.substr(0, 5) == "Hello");
+        REQUIRE(sr.substr(6, 100) == "World");
+        REQUIRE(sr.substr(11).empty());
+        REQUIRE_THROWS(sr.substr(12));
+
+        std::ostringstream s;
+        s << sr.substr(0, 5);
+        REQUIRE(s.str() == "Hello");
+    }
+
+    SECTION("can be searched")
+    {
+        REQUIRE(sr.find("World") == 6);
+        REQUIRE(sr.find('o') == 4);
+        REQUIRE(sr.find('o', 5) == 7);
+        REQUIRE(sr.find("Spam") == std::string::npos);
+        REQUIRE(sr.substr(0, 5).find('W') == std::string::npos);
+
+        REQUIRE(sr.starts_with("Hello"));
+        REQUIRE(!sr.starts_with("World"));
+        REQUIRE(sr.ends_with("World"));
+        REQUIRE(sr.starts_with(""));
+        REQUIRE(!sr.substr(0, 3).starts_with("Hello"));
+    }
+
+    SECTION("hashes like the equal std::string")
+    {
+        REQUIRE(nitro::lang::hash(sr) == nitro::lang::hash(str));
+        REQUIRE(nitro::lang::hash(sr.substr(0, 5)) == nitro::lang::hash(std::string("Hello")));
+        REQUIRE(std::hash<nitro::lang::string_ref>()(sr) == nitro::lang::hash(str));
+    }
+
+#if __cplusplus >= 201703L
+    SECTION("converts from and to std::string_view")
+    {
+        std::string_view view = sr;
+        REQUIRE(view.data() == str.data());
+        REQUIRE(view.size() == str.size());
+
+        nitro::lang::string_ref from_view = view.substr(0, 5);
+        REQUIRE(from_view.data() == str.data());
+        REQUIRE(from_view == "Hello");
+
+        std::string copy(from_view);
+        REQUIRE(copy == "Hello");
+    }
+
+    SECTION("compares with std::string_view in both directions")
+    {
+        std::string_view view = str;
+        std::string_view other = "Hello";
+
+        REQUIRE(sr == view);
+        REQUIRE(view == sr);
+        REQUIRE(sr != other);
+        REQUIRE(other != sr);
+        REQUIRE(!(sr == other));
+        REQUIRE(!(other == sr));
+    }
+#endif
+}
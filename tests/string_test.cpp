@@ -2,6 +2,11 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
 TEST_CASE("String join works", "[lang]")
 {
     std::vector<std::string> str;
@@ -43,6 +48,19 @@ TEST_CASE("String join works", "[lang]")
         REQUIRE(nitro::lang::join(str, " cruel ") == "Hello cruel World");
     }
 
+    SECTION("joining skips empty strings everywhere")
+    {
+        REQUIRE(nitro::lang::join({ std::string(), "Hello", std::string(), "World" }, ", ") ==
+                "Hello, World");
+        REQUIRE(nitro::lang::join({ "Hello", std::string() }, ", ") == "Hello");
+    }
+
+    SECTION("joining C strings works")
+    {
+        std::vector<const char*> words = { "Hello", "", "World" };
+        REQUIRE(nitro::lang::join(words.begin(), words.end(), "-") == "Hello-World");
+    }
+
     SECTION("joining with an empty infix works")
     {
         REQUIRE(nitro::lang::join(str, std::string()) == "HelloWorld");
@@ -132,6 +150,66 @@ TEST_CASE("String split works", "[lang]")
     }
 }
 
+TEST_CASE("String split finds all needles in long strings", "[lang]")
+{
+    std::mt19937 rng(42);
+
+    for (std::size_t needle_size = 1; needle_size < 6; needle_size++)
+    {
+        std::string needle(needle_size, 'a');
+        needle.back() = 'b';
+
+        for (std::size_t size = 0; size < 100; size++)
+        {
+            std::string str;
+            for (std::size_t i = 0; i < size; i++)
+            {
+                str.push_back("ab"[rng() % 2]);
+            }
+
+            std::vector<std::string> expected;
+            std::string::size_type start = 0;
+            for (auto pos = str.find(needle); pos != std::string::npos;
+                 pos = str.find(needle, start))
+            {
+                expected.emplace_back(str.substr(start, pos - start));
+                start = pos + needle.size();
+            }
+            expected.emplace_back(str.substr(start));
+
+            REQUIRE(nitro::lang::split(str, needle) == expected);
+        }
+    }
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("String split_view works", "[lang]")
+{
+    std::string str = "1234##5678##9101112";
+
+    std::vector<std::string_view> pieces;
+    for (auto piece : nitro::lang::split_view(str, "##"))
+    {
+        pieces.emplace_back(piece);
+    }
+
+    REQUIRE(pieces.size() == 3);
+    REQUIRE(pieces[0] == "1234");
+    REQUIRE(pieces[1] == "5678");
+    REQUIRE(pieces[2] == "9101112");
+    REQUIRE(pieces[0].data() == str.data());
+
+    nitro::lang::split_view empty("", ",");
+    REQUIRE(std::distance(empty.begin(), empty.end()) == 1);
+    REQUIRE(*empty.begin() == "");
+
+    nitro::lang::split_view trailing("a,b,", ",");
+    REQUIRE(std::distance(trailing.begin(), trailing.end()) == 3);
+
+    REQUIRE_THROWS(nitro::lang::split_view(str, ""));
+}
+#endif
+
 TEST_CASE("String starts_with works", "[lang]")
 {
     SECTION("Egg and Spam starts with Egg")
@@ -189,4 +267,62 @@ TEST_CASE("String replace_all works", "[lang]")
         nitro::lang::replace_all(str, "Egg", "Spam");
         REQUIRE(str == "");
     }
+    SECTION("Replacing with a string of the same length")
+    {
+        std::string str("Egg and Ham and Ham");
+        nitro::lang::replace_all(str, "Ham", "Egg");
+        REQUIRE(str == "Egg and Egg and Egg");
+    }
+    SECTION("Replacements are not replaced again")
+    {
+        std::string str("aaa");
+        nitro::lang::replace_all(str, "a", "aa");
+        REQUIRE(str == "aaaaaa");
+    }
+    SECTION("Replacing an empty string does nothing")
+    {
+        std::string str("Egg");
+        nitro::lang::replace_all(str, "", "Spam");
+        REQUIRE(str == "Egg");
+    }
+    SECTION("Replacing many occurrences in a long string")
+    {
+        std::string str;
+        std::string expected;
+        for (int i = 0; i < 10000; i++)
+        {
+            str += "Spam, ";
+            expected += "Egg; ";
+        }
+        nitro::lang::replace_all(str, "Spam, ", "Egg; ");
+        REQUIRE(str == expected);
+    }
+}
+
+TEST_CASE("String replace_all with several patterns works", "[lang]")
+{
+    SECTION("All patterns are replaced in one pass")
+    {
+        std::string str("Egg, Bacon and Spam");
+        nitro::lang::replace_all(str, { { "Bacon", "Spam" }, { "Spam", "Bacon" } });
+        REQUIRE(str == "Egg, Spam and Bacon");
+    }
+    SECTION("The earliest occurrence wins, ties go to the first pattern")
+    {
+        std::string str("abcd");
+        nitro::lang::replace_all(str, { { "bc", "X" }, { "abc", "Y" }, { "cd", "Z" } });
+        REQUIRE(str == "Yd");
+
+        str = "abcd";
+        nitro::lang::replace_all(str, { { "bcd", "X" }, { "bc", "Y" } });
+        REQUIRE(str == "aX");
+    }
+    SECTION("Nothing happens without matches or patterns")
+    {
+        std::string str("Egg");
+        nitro::lang::replace_all(str, { { "Spam", "Bacon" }, { "", "Bacon" } });
+        REQUIRE(str == "Egg");
+        nitro::lang::replace_all(str, {});
+        REQUIRE(str == "Egg");
+    }
 }
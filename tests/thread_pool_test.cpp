@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <nitro/except/exception.hpp>
+#include <nitro/lang/enumerate.hpp>
+#include <nitro/lang/parallel.hpp>
+#include <nitro/lang/thread_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+std::size_t fib(nitro::lang::thread_pool& pool, std::size_t n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+
+    std::size_t a = 0;
+    nitro::lang::wait_group group(1);
+
+    pool.post([&pool, &a, &group, n]() {
+        a = fib(pool, n - 1);
+        group.done();
+    });
+
+    auto b = fib(pool, n - 2);
+    pool.wait(group);
+
+    return a + b;
+}
+} // namespace
+
+TEST_CASE("thread pool runs submitted tasks", "[lang]")
+{
+    nitro::lang::thread_pool pool(4);
+
+    REQUIRE(pool.size() == 4);
+
+    auto answer = pool.submit([]() { return 42; });
+    auto nothing = pool.submit([]() {});
+    auto failure = pool.submit([]() -> int { throw std::runtime_error("fail"); });
+
+    REQUIRE(answer.get() == 42);
+    nothing.get();
+    REQUIRE_THROWS_AS(failure.get(), std::runtime_error);
+
+    std::atomic<int> count(0);
+    nitro::lang::wait_group group(1000);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        pool.post([&count, &group]() {
+            count++;
+            group.done();
+        });
+    }
+
+    group.wait();
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("tasks can wait for the tasks they start", "[lang]")
+{
+    nitro::lang::thread_pool pool(2);
+
+    REQUIRE(pool.submit([&pool]() { return fib(pool, 18); }).get() == 2584);
+    REQUIRE(fib(pool, 15) == 610);
+}
+
+TEST_CASE("thread pool runs parallel loops", "[lang]")
+{
+    nitro::lang::thread_pool pool(3);
+    std::vector<std::size_t> values(10000);
+
+    pool.parallel_for(0, values.size(), [&values](std::size_t i) { values[i] = i * i; });
+
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        REQUIRE(values[i] == i * i);
+    }
+
+    REQUIRE_THROWS_AS(pool.parallel_for(0, 100,
+                                        [](std::size_t i) {
+                                            if (i == 50)
+                                            {
+                                                throw std::runtime_error("fail");
+                                            }
+                                        },
+                                        10),
+                      std::runtime_error);
+
+    std::vector<std::size_t> indices(values.size());
+    nitro::lang::parallel_for_each(pool, nitro::lang::enumerate(values),
+                                   [&indices](auto e) { indices[e.index()] = e.value(); });
+
+    REQUIRE(indices == values);
+}
+
+TEST_CASE("thread pool shuts down gracefully", "[lang]")
+{
+    std::atomic<int> count(0);
+
+    {
+        nitro::lang::thread_pool pool(2, true);
+
+        for (int i = 0; i < 100; i++)
+        {
+            pool.post([&count, &pool]() {
+                // tasks may still start tasks while shutting down
+                pool.post([&count]() { count++; });
+                count++;
+            });
+        }
+
+        pool.shutdown();
+
+        REQUIRE(count == 200);
+        REQUIRE_THROWS_AS(pool.post([]() {}), nitro::except::exception);
+    }
+
+    {
+        nitro::lang::thread_pool pool(2);
+        pool.post([&count]() { count++; });
+    }
+
+    REQUIRE(count == 201);
+}
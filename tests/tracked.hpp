@@ -0,0 +1,32 @@
+#pragma once
+
+namespace
+{
+// counts live instances to catch leaked or doubly destroyed elements in container tests
+struct tracked
+{
+    static int alive;
+
+    // deliberately not default constructible
+    explicit tracked(int v) : value(v)
+    {
+        ++alive;
+    }
+
+    tracked(const tracked& other) : value(other.value)
+    {
+        ++alive;
+    }
+
+    tracked& operator=(const tracked&) = default;
+
+    ~tracked()
+    {
+        --alive;
+    }
+
+    int value;
+};
+
+int tracked::alive = 0;
+} // namespace
@@ -69,6 +69,20 @@ TEST_CASE("Test Hashing")
 
         REQUIRE(test.size() == 3);
     }
+
+    SECTION("string keys can be found with any string type")
+    {
+        nitro::lang::unordered_map<std::string, int> test;
+        test["key"] = 1;
+
+        REQUIRE(test.find(std::string("key")) != test.end());
+
+#if __cpp_lib_generic_unordered_lookup >= 201811L
+        REQUIRE(test.find("key")->second == 1);
+        REQUIRE(test.count(std::string_view("key")) == 1);
+        REQUIRE(test.find(nitro::lang::string_ref("missing")) == test.end());
+#endif
+    }
 }
 
 #endif